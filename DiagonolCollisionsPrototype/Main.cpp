@@ -9,6 +9,7 @@ using namespace JesseRussell::Diagnostics;
 
 #include <thread>
 #include <chrono>
+#include <cstdio>
 #include <iostream>
 // Override base class with your custom functionality
 class Example : public olc::PixelGameEngine
@@ -102,10 +103,15 @@ public:
 
 		
 		// draw values on screen:
-		DrawString(10, 20, "follow force: " + std::to_string(f));
-		DrawString(10, 30, "drag force: "   + std::to_string(k));
-		DrawString(10, 40, "mass: "   + std::to_string(bob.getMass()));
-		DrawString(10, 50, "frame time : "   + std::to_string(ft));
+		char text[64];
+		std::snprintf(text, sizeof(text), "follow force: %f", f);
+		DrawString(10, 20, text);
+		std::snprintf(text, sizeof(text), "drag force: %f", k);
+		DrawString(10, 30, text);
+		std::snprintf(text, sizeof(text), "mass: %f", bob.getMass());
+		DrawString(10, 40, text);
+		std::snprintf(text, sizeof(text), "frame time : %f", ft);
+		DrawString(10, 50, text);
 		//
 
 
@@ -264,7 +270,8 @@ public:
 		}
 
 
-		DrawString(10, 60, "time for collision:" + std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(sw.getElapsed()).count()));
+		std::snprintf(text, sizeof(text), "time for collision:%lld", (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(sw.getElapsed()).count());
+		DrawString(10, 60, text);
 		//
 
 
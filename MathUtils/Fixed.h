@@ -0,0 +1,127 @@
+#pragma once
+#include<cstdint>
+#include<string>
+#include<limits>
+
+namespace JesseRussell {
+	// o-------o
+	// | fixed |
+	// o-------o
+
+	// Binary fixed-point number. Stored as a Raw integer holding value * 2^FractionBits.
+	//
+	// Every operation is plain integer arithmetic, so results are the same bit for bit on every compiler, platform
+	// and set of floating-point flags. That's the point of it: replays and lockstep need the simulation to be
+	// reproducible, and floats aren't.
+	//
+	// Products and quotients are computed in 64 bits. For 32 bit Raw types that's exact before the final shift.
+	// For a 64 bit Raw it limits |a * b| and |a| (in a / b) to about 2^(63 - 2 * FractionBits).
+	//
+	// Floats and ints convert in implicitly, so constants and mixed expressions read the same as with float.
+	// Converting out is explicit, so it's always visible where determinism ends.
+	template<typename Raw, int FractionBits>
+	class fixed {
+		static_assert(std::numeric_limits<Raw>::is_integer && std::numeric_limits<Raw>::is_signed, "Raw must be a signed integer type.");
+		static_assert(FractionBits > 0 && FractionBits < std::numeric_limits<Raw>::digits, "FractionBits doesn't fit in Raw.");
+
+		using wide = int64_t;
+
+	public: // constants:
+		static constexpr Raw one = Raw(1) << FractionBits;
+		static constexpr int fractionBits = FractionBits;
+
+	public: // Constructors:
+		constexpr fixed() = default;
+		constexpr fixed(int value) : raw(Raw(value) * one) {}
+		constexpr fixed(long long value) : raw(Raw(value * one)) {}
+		// Rounds to nearest. Scaling by a power of two is exact, so this is deterministic too.
+		constexpr fixed(float value) : raw(Raw(value * one + (value < 0 ? -0.5f : 0.5f))) {}
+		constexpr fixed(double value) : raw(Raw(value * one + (value < 0 ? -0.5 : 0.5))) {}
+
+	public: // factories:
+		static constexpr fixed FromRaw(Raw raw) {
+			fixed result;
+			result.raw = raw;
+			return result;
+		}
+
+		static constexpr fixed Epsilon() { return FromRaw(1); }
+		static constexpr fixed Max() { return FromRaw(std::numeric_limits<Raw>::max()); }
+		static constexpr fixed Min() { return FromRaw(std::numeric_limits<Raw>::min()); }
+
+	public: // Properties:
+		constexpr Raw GetRaw() const { return raw; }
+
+	public: // conversions:
+		explicit constexpr operator float() const { return float(raw) / one; }
+		explicit constexpr operator double() const { return double(raw) / one; }
+		// Truncates toward zero like a float to int cast.
+		explicit constexpr operator int32_t() const { return int32_t(raw < 0 ? -(-raw >> FractionBits) : raw >> FractionBits); }
+		explicit constexpr operator int64_t() const { return int64_t(raw < 0 ? -(-raw >> FractionBits) : raw >> FractionBits); }
+
+	public: // operators:
+		constexpr fixed operator-() const { return FromRaw(-raw); }
+		constexpr fixed operator+() const { return *this; }
+
+		friend constexpr fixed operator+(fixed a, fixed b) { return FromRaw(a.raw + b.raw); }
+		friend constexpr fixed operator-(fixed a, fixed b) { return FromRaw(a.raw - b.raw); }
+		// Rounds toward negative infinity (arithmetic shift), on every platform.
+		friend constexpr fixed operator*(fixed a, fixed b) { return FromRaw(Raw((wide(a.raw) * b.raw) >> FractionBits)); }
+		// Rounds toward zero (integer division), on every platform.
+		// Dividing by zero saturates instead of trapping, standing in for float's inf: Max() for a positive
+		// numerator, Min() for a negative one and 0 for 0 / 0.
+		friend constexpr fixed operator/(fixed a, fixed b) {
+			if (b.raw == 0) return a.raw > 0 ? Max() : a.raw < 0 ? Min() : fixed();
+			return FromRaw(Raw((wide(a.raw) * one) / b.raw));
+		}
+
+		fixed& operator+=(fixed other) { return *this = *this + other; }
+		fixed& operator-=(fixed other) { return *this = *this - other; }
+		fixed& operator*=(fixed other) { return *this = *this * other; }
+		fixed& operator/=(fixed other) { return *this = *this / other; }
+
+		friend constexpr bool operator==(fixed a, fixed b) { return a.raw == b.raw; }
+		friend constexpr bool operator!=(fixed a, fixed b) { return a.raw != b.raw; }
+		friend constexpr bool operator< (fixed a, fixed b) { return a.raw <  b.raw; }
+		friend constexpr bool operator> (fixed a, fixed b) { return a.raw >  b.raw; }
+		friend constexpr bool operator<=(fixed a, fixed b) { return a.raw <= b.raw; }
+		friend constexpr bool operator>=(fixed a, fixed b) { return a.raw >= b.raw; }
+
+	public: // math (found through ADL, same as the std:: versions for float):
+		friend constexpr fixed abs(fixed value) { return value.raw < 0 ? -value : value; }
+
+		// Integer square root of raw * 2^FractionBits, rounded down. Bit by bit, so no floating point is involved.
+		friend fixed sqrt(fixed value) {
+			if (value.raw <= 0) return fixed();
+			uint64_t n = uint64_t(value.raw) << FractionBits;
+			uint64_t result = 0;
+			uint64_t bit = uint64_t(1) << 62;
+			while (bit > n) bit >>= 2;
+			while (bit != 0) {
+				if (n >= result + bit) {
+					n -= result + bit;
+					result = (result >> 1) + bit;
+				}
+				else result >>= 1;
+				bit >>= 2;
+			}
+			return FromRaw(Raw(result));
+		}
+
+		friend bool signbit(fixed value) { return value.raw < 0; }
+
+		friend std::string to_string(fixed value) { return std::to_string(double(value)); }
+
+	private: // Fields:
+		Raw raw = 0;
+	};
+
+	template<typename Raw, int FractionBits>
+	constexpr Raw fixed<Raw, FractionBits>::one;
+	template<typename Raw, int FractionBits>
+	constexpr int fixed<Raw, FractionBits>::fractionBits;
+
+	using fixed16_16 = fixed<int32_t, 16>;
+	using fixed24_8  = fixed<int32_t, 8>;
+	using fixed48_16 = fixed<int64_t, 16>;
+}
@@ -0,0 +1,295 @@
+#pragma once
+#include<string>
+#include<cmath>
+
+namespace JesseRussell {
+	namespace vectors {
+		// o------o
+		// | vec2 |
+		// o------o
+
+		// vec2<T> is a 2d vector of any number-like T (float, double, or a fixed-point type).
+		//
+		// Arithmetic on vec2s doesn't compute anything right away. Instead it builds a small expression object that
+		// remembers what to do, and the whole chain gets evaluated in one go when it's assigned to a vec2 (or passed
+		// somewhere a vec2 is expected). So something like:
+		//
+		//     velocity.timesX(std::abs(velocity.x)).timesY(std::abs(velocity.y)) * 0.5 * -0.0005
+		//
+		// ends up as one multiply chain per component instead of four intermediate vectors.
+		//
+		// Every node holds its operands by value (a vec2 is only two numbers), so an expression never dangles, even if
+		// it was built from temporaries and kept in an auto variable.
+
+		template<typename T> struct vec2;
+		template<typename E> struct vec2_expr;
+
+		// Number type of a vec2 or vec2 expression.
+		template<typename E> struct vec2_traits;
+		template<typename T> struct vec2_traits<vec2<T>> { using value_type = T; };
+
+		namespace expr {
+			// o-----------o
+			// | operators |
+			// o-----------o
+			struct add     { template<typename T> static T apply(const T& a, const T& b) { return a + b; } };
+			struct sub     { template<typename T> static T apply(const T& a, const T& b) { return a - b; } };
+			struct mul     { template<typename T> static T apply(const T& a, const T& b) { return a * b; } };
+			struct div     { template<typename T> static T apply(const T& a, const T& b) { return a / b; } };
+			struct rdiv    { template<typename T> static T apply(const T& a, const T& b) { return b / a; } };
+			struct replace { template<typename T> static T apply(const T&, const T& b) { return b; } };
+
+			struct negate  { template<typename T> static T apply(const T& a) { return -a; } };
+			struct absolute {
+				template<typename T> static T apply(const T& a) {
+					using std::abs;
+					return abs(a);
+				}
+			};
+
+			// o-------o
+			// | nodes |
+			// o-------o
+
+			// Component-wise op between two vectors.
+			template<typename L, typename R, typename Op>
+			struct binary : vec2_expr<binary<L, R, Op>> {
+				using value_type = typename vec2_traits<L>::value_type;
+
+				binary(const L& l, const R& r) : l(l), r(r) {}
+
+				value_type getX() const { return Op::apply(l.getX(), r.getX()); }
+				value_type getY() const { return Op::apply(l.getY(), r.getY()); }
+
+			private:
+				const L l;
+				const R r;
+			};
+
+			// Op between a vector and a scalar, applied to x, y, or both.
+			template<typename E, typename Op, bool onX, bool onY>
+			struct scalar : vec2_expr<scalar<E, Op, onX, onY>> {
+				using value_type = typename vec2_traits<E>::value_type;
+
+				scalar(const E& e, const value_type& s) : e(e), s(s) {}
+
+				value_type getX() const { return onX ? Op::apply(e.getX(), s) : e.getX(); }
+				value_type getY() const { return onY ? Op::apply(e.getY(), s) : e.getY(); }
+
+			private:
+				const E e;
+				value_type s;
+			};
+
+			// Op between two vectors, applied to x or y only. The other component comes from the left side.
+			template<typename L, typename R, typename Op, bool onX, bool onY>
+			struct masked : vec2_expr<masked<L, R, Op, onX, onY>> {
+				using value_type = typename vec2_traits<L>::value_type;
+
+				masked(const L& l, const R& r) : l(l), r(r) {}
+
+				value_type getX() const { return onX ? Op::apply(l.getX(), r.getX()) : l.getX(); }
+				value_type getY() const { return onY ? Op::apply(l.getY(), r.getY()) : l.getY(); }
+
+			private:
+				const L l;
+				const R r;
+			};
+
+			template<typename E, typename Op>
+			struct unary : vec2_expr<unary<E, Op>> {
+				using value_type = typename vec2_traits<E>::value_type;
+
+				unary(const E& e) : e(e) {}
+
+				value_type getX() const { return Op::apply(e.getX()); }
+				value_type getY() const { return Op::apply(e.getY()); }
+
+			private:
+				const E e;
+			};
+		}
+
+		template<typename L, typename R, typename Op>
+		struct vec2_traits<expr::binary<L, R, Op>> { using value_type = typename vec2_traits<L>::value_type; };
+		template<typename E, typename Op, bool onX, bool onY>
+		struct vec2_traits<expr::scalar<E, Op, onX, onY>> { using value_type = typename vec2_traits<E>::value_type; };
+		template<typename L, typename R, typename Op, bool onX, bool onY>
+		struct vec2_traits<expr::masked<L, R, Op, onX, onY>> { using value_type = typename vec2_traits<L>::value_type; };
+		template<typename E, typename Op>
+		struct vec2_traits<expr::unary<E, Op>> { using value_type = typename vec2_traits<E>::value_type; };
+
+
+
+		// o-----------o
+		// | vec2_expr |
+		// o-----------o
+
+		// Base of vec2 and of every expression node. Holds everything that only needs to read x and y, so it works the
+		// same on a vec2 or on an unevaluated expression.
+		template<typename E>
+		struct vec2_expr {
+			using value_type = typename vec2_traits<E>::value_type;
+
+			const E& self() const { return static_cast<const E&>(*this); }
+
+			// Evaluation:
+			vec2<value_type> eval() const { return vec2<value_type>(self().getX(), self().getY()); }
+			vec2<value_type> clone() const { return eval(); }
+
+			// Methods:
+				// out-of-place modification:
+			vec2<value_type> transformed(const vec2<value_type>& i, const vec2<value_type>& j) const {
+				vec2<value_type> result = eval();
+				result.transform(i, j);
+				return result;
+			}
+
+			vec2<value_type> normalized() const {
+				vec2<value_type> result = eval();
+				result.normalize();
+				return result;
+			}
+
+			expr::scalar<E, expr::replace, true, false> withX(const value_type& x) const { return { self(), x }; }
+			expr::scalar<E, expr::replace, false, true> withY(const value_type& y) const { return { self(), y }; }
+			template<typename O> expr::masked<E, O, expr::replace, true, false> withX(const vec2_expr<O>& other) const { return { self(), other.self() }; }
+			template<typename O> expr::masked<E, O, expr::replace, false, true> withY(const vec2_expr<O>& other) const { return { self(), other.self() }; }
+
+			expr::scalar<E, expr::add, true, false> plusX(const value_type& x) const { return { self(), x }; }
+			expr::scalar<E, expr::add, false, true> plusY(const value_type& y) const { return { self(), y }; }
+			template<typename O> expr::masked<E, O, expr::add, true, false> plusX(const vec2_expr<O>& other) const { return { self(), other.self() }; }
+			template<typename O> expr::masked<E, O, expr::add, false, true> plusY(const vec2_expr<O>& other) const { return { self(), other.self() }; }
+
+			expr::scalar<E, expr::sub, true, false> minusX(const value_type& x) const { return { self(), x }; }
+			expr::scalar<E, expr::sub, false, true> minusY(const value_type& y) const { return { self(), y }; }
+			template<typename O> expr::masked<E, O, expr::sub, true, false> minusX(const vec2_expr<O>& other) const { return { self(), other.self() }; }
+			template<typename O> expr::masked<E, O, expr::sub, false, true> minusY(const vec2_expr<O>& other) const { return { self(), other.self() }; }
+
+			expr::scalar<E, expr::mul, true, false> timesX(const value_type& x) const { return { self(), x }; }
+			expr::scalar<E, expr::mul, false, true> timesY(const value_type& y) const { return { self(), y }; }
+			template<typename O> expr::masked<E, O, expr::mul, true, false> timesX(const vec2_expr<O>& other) const { return { self(), other.self() }; }
+			template<typename O> expr::masked<E, O, expr::mul, false, true> timesY(const vec2_expr<O>& other) const { return { self(), other.self() }; }
+
+			expr::scalar<E, expr::div, true, false> divbyX(const value_type& x) const { return { self(), x }; }
+			expr::scalar<E, expr::div, false, true> divbyY(const value_type& y) const { return { self(), y }; }
+			template<typename O> expr::masked<E, O, expr::div, true, false> divbyX(const vec2_expr<O>& other) const { return { self(), other.self() }; }
+			template<typename O> expr::masked<E, O, expr::div, false, true> divbyY(const vec2_expr<O>& other) const { return { self(), other.self() }; }
+
+			expr::scalar<E, expr::replace, false, true> selectX() const { return { self(), value_type(0) }; }
+			expr::scalar<E, expr::replace, true, false> selectY() const { return { self(), value_type(0) }; }
+
+			expr::unary<E, expr::absolute> abs() const { return { self() }; }
+				//
+
+
+			value_type getMagnitudeSquared() const {
+				value_type x = self().getX(), y = self().getY();
+				return x * x + y * y;
+			}
+
+			value_type getMagnitude() const {
+				using std::sqrt;
+				return sqrt(getMagnitudeSquared());
+			}
+
+			template<typename O> value_type distanceSquared(const vec2_expr<O>& other) const { return (*this - other).getMagnitudeSquared(); }
+			template<typename O> value_type distance(const vec2_expr<O>& other) const { return (*this - other).getMagnitude(); }
+
+			std::string toString() const {
+				using std::to_string;
+				return "[ " + to_string(self().getX()) + ", " + to_string(self().getY()) + " ]";
+			}
+		};
+
+
+
+		// o------o
+		// | vec2 |
+		// o------o
+
+		// Aligned to its own size so a vec2<float> is one 8 byte load and a vec2<double> fills exactly one SSE register.
+		template<typename T>
+		struct alignas(2 * sizeof(T)) vec2 : vec2_expr<vec2<T>> {
+			using value_type = T;
+
+			// fields:
+			T
+				x = T(0),
+				y = T(0);
+
+			// Constructors:
+			vec2() = default;
+			vec2(T x, T y) { this->x = x; this->y = y; }
+
+			template<typename E>
+			vec2(const vec2_expr<E>& e) : x(e.self().getX()), y(e.self().getY()) {}
+
+			template<typename E>
+			vec2& operator=(const vec2_expr<E>& e) { x = e.self().getX(); y = e.self().getY(); return *this; }
+
+			// Expression leaf:
+			const T& getX() const { return x; }
+			const T& getY() const { return y; }
+
+			// Methods:
+				// in-place modification:
+			void set(const vec2& value) { x = value.x; y = value.y; }
+			void set(const T& x, const T& y) { this->x = x; this->y = y; }
+
+			void transform(const vec2& i, const vec2& j) {
+				T oldx = x;
+				x = x * i.x + y * j.x;
+				y = oldx * i.y + y * j.y;
+			}
+
+			void normalize() {
+				T mag = this->getMagnitude();
+				x /= mag;
+				y /= mag;
+			}
+
+			// operators:
+			// Each component of an expression only ever reads the same component of its operands, so these can write
+			// x before reading y even if other refers to this vector.
+			template<typename E> vec2& operator+=(const vec2_expr<E>& other) { x += other.self().getX(); y += other.self().getY(); return *this; }
+			template<typename E> vec2& operator-=(const vec2_expr<E>& other) { x -= other.self().getX(); y -= other.self().getY(); return *this; }
+			vec2& operator*=(const T& scaler) { x *= scaler; y *= scaler; return *this; }
+			vec2& operator/=(const T& scaler) { x /= scaler; y /= scaler; return *this; }
+		};
+
+		using fvector2 = vec2<float>;
+		using dvector2 = vec2<double>;
+
+
+
+		// o-----------o
+		// | operators |
+		// o-----------o
+
+		template<typename L, typename R>
+		expr::binary<L, R, expr::add> operator+(const vec2_expr<L>& l, const vec2_expr<R>& r) { return { l.self(), r.self() }; }
+		template<typename L, typename R>
+		expr::binary<L, R, expr::sub> operator-(const vec2_expr<L>& l, const vec2_expr<R>& r) { return { l.self(), r.self() }; }
+
+		template<typename E>
+		expr::scalar<E, expr::mul, true, true> operator*(const vec2_expr<E>& e, const typename vec2_traits<E>::value_type& scaler) { return { e.self(), scaler }; }
+		template<typename E>
+		expr::scalar<E, expr::div, true, true> operator/(const vec2_expr<E>& e, const typename vec2_traits<E>::value_type& scaler) { return { e.self(), scaler }; }
+
+		template<typename E>
+		expr::scalar<E, expr::mul, true, true> operator*(const typename vec2_traits<E>::value_type& scaler, const vec2_expr<E>& e) { return { e.self(), scaler }; }
+		template<typename E>
+		expr::scalar<E, expr::rdiv, true, true> operator/(const typename vec2_traits<E>::value_type& scaler, const vec2_expr<E>& e) { return { e.self(), scaler }; }
+
+		template<typename E>
+		expr::unary<E, expr::negate> operator-(const vec2_expr<E>& e) { return { e.self() }; }
+		template<typename E>
+		const E& operator+(const vec2_expr<E>& e) { return e.self(); }
+
+		template<typename L, typename R>
+		bool operator==(const vec2_expr<L>& l, const vec2_expr<R>& r) { return l.self().getX() == r.self().getX() && l.self().getY() == r.self().getY(); }
+		template<typename L, typename R>
+		bool operator!=(const vec2_expr<L>& l, const vec2_expr<R>& r) { return !(l == r); }
+	}
+}
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "PlatformPhysics.h"
+#include "Stopwatch.h"
+
+#include<atomic>
+#include<condition_variable>
+#include<cstdint>
+#include<deque>
+#include<functional>
+#include<memory>
+#include<mutex>
+#include<thread>
+#include<unordered_map>
+#include<vector>
+
+namespace phy {
+	// o------------o
+	// | RegionData |
+	// o------------o
+
+	// What one region of the level contains. It's filled in on the loader thread, so it's plain data: the entities
+	// themselves are only created once the region is activated on the engine's thread.
+	struct RegionData {
+		struct Box {
+			vector2 position;
+			vector2 size;
+		};
+
+		std::vector<Box> statics;
+
+		void clear() { statics.clear(); }
+	};
+
+
+
+	// o--------------o
+	// | ChunkedWorld |
+	// o--------------o
+
+	// Streams a level that's too big to keep in memory (or in the engine) all at once.
+	//
+	// The level is split into square regions regionSize wide. Every update, the regions within loadRadius of the focus
+	// (normally the player) are requested from the loader, which runs on a background thread. Loaded regions are handed
+	// to the engine a batch at a time, and regions further than unloadRadius away are taken out of it again, also a batch
+	// at a time, so neither causes a hitch however much a region holds. unloadRadius is larger than loadRadius so walking
+	// back and forth over a region border doesn't load and unload the same regions over and over.
+	//
+	// At most (2 * unloadRadius + 1)^2 regions are ever loaded, which is what bounds memory. RegionData buffers are
+	// recycled, so once streaming has warmed up it allocates little more than the entities themselves.
+	//
+	// Only static geometry is streamed. Dynamic entities move between regions, so they stay the game's to manage.
+	// update must be called from whichever thread owns the engine, and the engine must outlive the ChunkedWorld. The
+	// ChunkedWorld doesn't take its entities back out of the engine when it's destroyed.
+	class ChunkedWorld {
+	public: // types:
+		// Fills out (already empty) with the contents of region (x, y), whose top left corner is at
+		// (x * regionSize, y * regionSize). Called on the loader thread. It must return the same contents every time it's
+		// asked for the same region, since regions are loaded again whenever the player comes back to them.
+		using Loader = std::function<void(int32_t x, int32_t y, RegionData& out)>;
+
+	public: // Constructors:
+		ChunkedWorld(Engine& engine, scalar regionSize, Loader loader, int32_t loadRadius = 1, int32_t unloadRadius = 2, size_t maxEntitiesPerUpdate = 256)
+			: engine(engine), regionSize(regionSize), loader(loader),
+			loadRadius(loadRadius), unloadRadius(unloadRadius > loadRadius ? unloadRadius : loadRadius + 1),
+			maxEntitiesPerUpdate(maxEntitiesPerUpdate != 0 ? maxEntitiesPerUpdate : 1) {
+			thread = std::thread(&ChunkedWorld::loaderMain, this);
+		}
+
+		~ChunkedWorld() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			wakeLoader.notify_one();
+			thread.join();
+		}
+
+		ChunkedWorld(const ChunkedWorld&) = delete;
+		ChunkedWorld& operator=(const ChunkedWorld&) = delete;
+
+	public: // Properties:
+		scalar getRegionSize() const { return regionSize; }
+
+		// Regions that are loaded, being loaded or waiting to be activated.
+		size_t getRegionCount() const { return regions.size(); }
+		// Regions whose entities are all in the engine. Safe to read from any thread, e.g. while a PhysicsThread runs update.
+		size_t getActiveRegionCount() const { return activeRegionCount.load(std::memory_order_relaxed); }
+		// Entities the world has in the engine right now.
+		size_t getEntityCount() const { return entityCount; }
+		// Entities waiting to be taken out of the engine.
+		size_t getPendingRemovalCount() const { return pendingRemovals.size(); }
+
+	public: // Methods:
+		// Call once per step (or frame), before engine.update, with the position the world should be loaded around.
+		void update(const vector2& focus) {
+			PROFILE_ZONE("world.update");
+			int32_t focusX = regionOf(focus.x), focusY = regionOf(focus.y);
+
+			// unload what's now too far away:
+			for (auto iter = regions.begin(); iter != regions.end();) {
+				Region& region = iter->second;
+				if (distance(region.x, region.y, focusX, focusY) <= unloadRadius) {
+					++iter;
+					continue;
+				}
+
+				if (region.state == REQUESTED) cancelRequest(iter->first);
+				if (region.data) recycle(std::move(region.data));
+				if (region.state == ACTIVE) activeRegionCount.fetch_sub(1, std::memory_order_relaxed);
+				entityCount -= region.entities.size();
+				pendingRemovals.insert(pendingRemovals.end(), region.entities.begin(), region.entities.end());
+				iter = regions.erase(iter);
+			}
+
+			// request what's now near enough, nearest first:
+			bool requested = false;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				loaderFocusX = focusX;
+				loaderFocusY = focusY;
+				for (int32_t ring = 0; ring <= loadRadius; ++ring) {
+					for (int32_t y = focusY - ring; y <= focusY + ring; ++y) {
+						for (int32_t x = focusX - ring; x <= focusX + ring; ++x) {
+							if (distance(x, y, focusX, focusY) != ring) continue;
+							uint64_t k = key(x, y);
+							if (regions.find(k) != regions.end()) continue;
+							Region& region = regions[k];
+							region.x = x;
+							region.y = y;
+							requests.push_back({ x, y });
+							requested = true;
+						}
+					}
+				}
+
+				// pick up what the loader has finished:
+				for (Loaded& loaded : finished) {
+					auto iter = regions.find(key(loaded.x, loaded.y));
+					// the region may have been unloaded again while it was loading.
+					if (iter == regions.end() || iter->second.state != REQUESTED) {
+						spare.push_back(std::move(loaded.data));
+						continue;
+					}
+					iter->second.state = ACTIVATING;
+					iter->second.data = std::move(loaded.data);
+					activationQueue.push_back(iter->first);
+				}
+				finished.clear();
+			}
+			if (requested) wakeLoader.notify_one();
+
+			size_t budget = maxEntitiesPerUpdate;
+			removeBatch(budget);
+			activateBatch(budget);
+		}
+
+	private: // types:
+		enum RegionState { REQUESTED, ACTIVATING, ACTIVE };
+
+		// Its own type so nothing else (like GeometryOptimizer) mistakes the world's entities for its own to merge or delete.
+		class RegionEntity : public Entity {
+		public:
+			using Entity::Entity;
+		};
+
+		struct Region {
+			int32_t x = 0, y = 0;
+			RegionState state = REQUESTED;
+			std::unique_ptr<RegionData> data; // only while ACTIVATING.
+			size_t activated = 0;             // boxes of data already in the engine.
+			std::vector<Entity*> entities;
+		};
+
+		struct Request {
+			int32_t x, y;
+		};
+
+		struct Loaded {
+			int32_t x, y;
+			std::unique_ptr<RegionData> data;
+		};
+
+	private: // engine side:
+		void removeBatch(size_t& budget) {
+			if (pendingRemovals.empty()) return;
+			size_t count = pendingRemovals.size() < budget ? pendingRemovals.size() : budget;
+			batch.assign(pendingRemovals.end() - count, pendingRemovals.end());
+			pendingRemovals.resize(pendingRemovals.size() - count);
+			engine.entities_deleteBatch(batch);
+			budget -= count;
+		}
+
+		void activateBatch(size_t& budget) {
+			batch.clear();
+			while (budget != 0 && !activationQueue.empty()) {
+				auto iter = regions.find(activationQueue.front());
+				if (iter == regions.end() || iter->second.state != ACTIVATING) {
+					activationQueue.pop_front();
+					continue;
+				}
+
+				Region& region = iter->second;
+				const std::vector<RegionData::Box>& boxes = region.data->statics;
+				region.entities.reserve(boxes.size());
+				for (; region.activated < boxes.size() && budget != 0; ++region.activated, --budget) {
+					const RegionData::Box& box = boxes[region.activated];
+					Entity* e = new RegionEntity(box.position, Box(box.size));
+					region.entities.push_back(e);
+					batch.push_back(e);
+				}
+				if (region.activated == boxes.size()) {
+					region.state = ACTIVE;
+					activeRegionCount.fetch_add(1, std::memory_order_relaxed);
+					std::lock_guard<std::mutex> lock(mutex);
+					spare.push_back(std::move(region.data));
+					activationQueue.pop_front();
+				}
+			}
+
+			if (!batch.empty()) {
+				engine.entities_addBatch(batch);
+				entityCount += batch.size();
+			}
+		}
+
+		void cancelRequest(uint64_t k) {
+			std::lock_guard<std::mutex> lock(mutex);
+			for (auto iter = requests.begin(); iter != requests.end(); ++iter) {
+				if (key(iter->x, iter->y) == k) {
+					requests.erase(iter);
+					return;
+				}
+			}
+			// not found: the loader already has it, and update will throw the result away when it arrives.
+		}
+
+		void recycle(std::unique_ptr<RegionData> data) {
+			std::lock_guard<std::mutex> lock(mutex);
+			spare.push_back(std::move(data));
+		}
+
+	private: // loader side:
+		void loaderMain() {
+			JesseRussell::Diagnostics::Profiler::setThreadName("world loader");
+			std::unique_lock<std::mutex> lock(mutex);
+			for (;;) {
+				wakeLoader.wait(lock, [this] { return stopping || !requests.empty(); });
+				if (stopping) return;
+
+				// the focus may have moved on since these were asked for, so take whichever is nearest to it now.
+				auto nearest = requests.begin();
+				for (auto iter = requests.begin(); iter != requests.end(); ++iter)
+					if (distance(iter->x, iter->y, loaderFocusX, loaderFocusY) < distance(nearest->x, nearest->y, loaderFocusX, loaderFocusY))
+						nearest = iter;
+				Request request = *nearest;
+				requests.erase(nearest);
+
+				std::unique_ptr<RegionData> data;
+				if (!spare.empty()) {
+					data = std::move(spare.back());
+					spare.pop_back();
+				}
+				lock.unlock();
+
+				{
+					PROFILE_ZONE("load region");
+					if (data) data->clear();
+					else data.reset(new RegionData);
+					loader(request.x, request.y, *data);
+				}
+
+				lock.lock();
+				finished.push_back({ request.x, request.y, std::move(data) });
+			}
+		}
+
+	private:
+		int32_t regionOf(const scalar& coordinate) const {
+			// floor, not truncation, so region -1 doesn't get twice the width of the others.
+			int32_t region = (int32_t)(coordinate / regionSize);
+			if (coordinate < scalar(region) * regionSize) --region;
+			return region;
+		}
+
+		// in regions, along whichever axis is further.
+		static int32_t distance(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+			int32_t dx = x1 > x2 ? x1 - x2 : x2 - x1;
+			int32_t dy = y1 > y2 ? y1 - y2 : y2 - y1;
+			return dx > dy ? dx : dy;
+		}
+
+		static uint64_t key(int32_t x, int32_t y) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y; }
+
+	private: // Fields:
+		Engine& engine;
+		scalar regionSize;
+		Loader loader;
+		int32_t loadRadius;
+		int32_t unloadRadius;
+		size_t maxEntitiesPerUpdate;
+
+		// Only touched by the thread calling update.
+		std::unordered_map<uint64_t, Region> regions;
+		std::deque<uint64_t> activationQueue;
+		std::vector<Entity*> pendingRemovals;
+		std::vector<Entity*> batch;
+		std::atomic<size_t> activeRegionCount{ 0 }; // also read by other threads, for display.
+		size_t entityCount = 0;
+
+		// Shared with the loader thread, under mutex.
+		std::mutex mutex;
+		std::condition_variable wakeLoader;
+		std::deque<Request> requests;
+		std::vector<Loaded> finished;
+		std::vector<std::unique_ptr<RegionData>> spare;
+		int32_t loaderFocusX = 0, loaderFocusY = 0;
+		bool stopping = false;
+
+		std::thread thread;
+	};
+}
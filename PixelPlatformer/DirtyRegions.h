@@ -0,0 +1,253 @@
+#pragma once
+
+#include<algorithm>
+#include<cstdint>
+#include<functional>
+#include<vector>
+
+namespace JesseRussell {
+	namespace Graphics {
+		// o------o
+		// | Rect |
+		// o------o
+
+		// Pixel rectangle: x, y is its top left pixel, and it covers width by height pixels.
+		struct Rect {
+			int32_t x = 0, y = 0;
+			int32_t width = 0, height = 0;
+
+			int32_t getRight() const { return x + width; }   // one past the last column.
+			int32_t getBottom() const { return y + height; } // one past the last row.
+			int64_t getArea() const { return (int64_t)width * height; }
+			bool isEmpty() const { return width <= 0 || height <= 0; }
+
+			bool intersects(const Rect& other) const {
+				return x < other.getRight() && other.x < getRight() && y < other.getBottom() && other.y < getBottom();
+			}
+
+			bool contains(const Rect& other) const {
+				return other.x >= x && other.y >= y && other.getRight() <= getRight() && other.getBottom() <= getBottom();
+			}
+
+			Rect united(const Rect& other) const {
+				int32_t x1 = std::min(x, other.x), y1 = std::min(y, other.y);
+				return { x1, y1, std::max(getRight(), other.getRight()) - x1, std::max(getBottom(), other.getBottom()) - y1 };
+			}
+
+			Rect clipped(const Rect& to) const {
+				int32_t x1 = std::max(x, to.x), y1 = std::max(y, to.y);
+				return { x1, y1, std::max(0, std::min(getRight(), to.getRight()) - x1), std::max(0, std::min(getBottom(), to.getBottom()) - y1) };
+			}
+		};
+
+
+
+		// o--------------------o
+		// | DirtyRegionTracker |
+		// o--------------------o
+
+		// Works out which parts of the screen need redrawing, so a frame where little moved only clears and redraws that
+		// little instead of every pixel.
+		//
+		// Each frame, instead of drawing straight away, add() everything that would be drawn: an id that stays the same
+		// from frame to frame (an entity's address, say), the pixels it covers and a style standing for anything else
+		// that changes how it looks (its colour, say). Things drawn some other way, like text, invalidate() the area they
+		// cover instead. Then endFrame() compares against the last frame:
+		//   - anything added, removed, moved or restyled makes its old and new bounds dirty.
+		//   - every item overlapping a dirty area has to be redrawn, so its whole bounds become dirty too, until nothing
+		//     else overlaps. That's what makes redrawing whole items correct without any clipping.
+		// Then clear each getDirty() rectangle, redraw the items forEachToRedraw() reports, in the order they were added,
+		// and draw the invalidated things as usual.
+		//
+		// When so much changed that it's not worth it (the camera moved, for example), endFrame reports a full redraw:
+		// clear the screen and draw everything, as without the tracker.
+		class DirtyRegionTracker {
+		public: // types:
+			struct Item {
+				const void* id;
+				Rect bounds;  // as added, to redraw it with.
+				Rect visible; // the part on screen.
+				uint32_t style;
+			};
+
+		public: // Constructors:
+			DirtyRegionTracker(int32_t screenWidth = 0, int32_t screenHeight = 0) { setScreenSize(screenWidth, screenHeight); }
+
+		public: // Properties:
+			// Also forces a full redraw.
+			void setScreenSize(int32_t width, int32_t height) {
+				screen = { 0, 0, width, height };
+				invalidateAll();
+			}
+
+			// While disabled, every frame is a full redraw.
+			bool isEnabled() const { return enabled; }
+			void setEnabled(bool value) {
+				enabled = value;
+				invalidateAll();
+			}
+
+			// A full redraw is cheaper once the dirty area gets past this share of the screen.
+			void setFullRedrawThreshold(float value) { fullRedrawThreshold = value; }
+
+			// Results of the last endFrame:
+			bool isFullRedraw() const { return fullRedraw; }
+			const std::vector<Rect>& getDirty() const { return dirty; }
+			int64_t getDirtyArea() const { return dirtyArea; }
+			// Rows that changed, [getDirtyTop(), getDirtyBottom()). Empty when nothing did.
+			int32_t getDirtyTop() const { return dirtyTop; }
+			int32_t getDirtyBottom() const { return dirtyBottom; }
+
+		public: // Methods:
+			// The next frame is a full redraw, whatever changed. For when something changed that the tracker can't see.
+			void invalidateAll() { forceFull = true; }
+
+			void beginFrame() {
+				previous.swap(current);
+				current.clear();
+				previousInvalidated.swap(invalidated);
+				invalidated.clear();
+			}
+
+			void add(const void* id, const Rect& bounds, uint32_t style = 0) {
+				Rect onScreen = bounds.clipped(screen);
+				if (!onScreen.isEmpty()) current.push_back({ id, bounds, onScreen, style });
+			}
+
+			// Marks an area that's drawn without going through add, this frame and (to clear it away) the next.
+			void invalidate(const Rect& area) {
+				Rect onScreen = area.clipped(screen);
+				if (!onScreen.isEmpty()) invalidated.push_back(onScreen);
+			}
+
+			void endFrame() {
+				dirty.clear();
+				redraw.assign(current.size(), false);
+				fullRedraw = forceFull || !enabled;
+				forceFull = false;
+				if (!fullRedraw) findChanges();
+				if (!fullRedraw) spreadToOverlappingItems();
+				if (!fullRedraw) {
+					dirtyArea = 0;
+					for (const Rect& rect : dirty) dirtyArea += rect.getArea();
+					fullRedraw = dirtyArea > screen.getArea() * fullRedrawThreshold;
+				}
+
+				if (fullRedraw) {
+					dirty.assign(1, screen);
+					dirtyArea = screen.getArea();
+					redraw.assign(current.size(), true);
+				}
+
+				dirtyTop = screen.getBottom();
+				dirtyBottom = screen.y;
+				for (const Rect& rect : dirty) {
+					dirtyTop = std::min(dirtyTop, rect.y);
+					dirtyBottom = std::max(dirtyBottom, rect.getBottom());
+				}
+				if (dirty.empty()) dirtyTop = dirtyBottom = 0;
+			}
+
+			// Calls action(item) for every item that needs redrawing, in the order they were added.
+			template<typename Action>
+			void forEachToRedraw(Action action) const {
+				for (size_t i = 0; i < current.size(); ++i)
+					if (redraw[i]) action(current[i]);
+			}
+
+		private:
+			// (< isn't defined between unrelated pointers, std::less is.)
+			static bool isBefore(const void* a, const void* b) { return std::less<const void*>()(a, b); }
+
+			void markDirty(const Rect& rect) {
+				// overlapping rectangles are merged, so the same pixels aren't cleared twice.
+				Rect merged = rect;
+				for (size_t i = 0; i < dirty.size();) {
+					if (dirty[i].intersects(merged)) {
+						merged = merged.united(dirty[i]);
+						dirty[i] = dirty.back();
+						dirty.pop_back();
+						i = 0;
+					}
+					else ++i;
+				}
+				dirty.push_back(merged);
+				if (dirty.size() > maxDirtyRects) fullRedraw = true;
+			}
+
+			void findChanges() {
+				for (const Rect& rect : previousInvalidated) markDirty(rect);
+				for (const Rect& rect : invalidated) markDirty(rect);
+
+				// match items by id: sorted copies, walked side by side.
+				sortedPrevious.assign(previous.begin(), previous.end());
+				sortedCurrent.assign(current.begin(), current.end());
+				auto byId = [](const Item& a, const Item& b) { return isBefore(a.id, b.id); };
+				std::sort(sortedPrevious.begin(), sortedPrevious.end(), byId);
+				std::sort(sortedCurrent.begin(), sortedCurrent.end(), byId);
+
+				size_t p = 0, c = 0;
+				while ((p < sortedPrevious.size() || c < sortedCurrent.size()) && !fullRedraw) {
+					if (c == sortedCurrent.size() || (p < sortedPrevious.size() && isBefore(sortedPrevious[p].id, sortedCurrent[c].id))) {
+						markDirty(sortedPrevious[p++].visible); // gone.
+					}
+					else if (p == sortedPrevious.size() || isBefore(sortedCurrent[c].id, sortedPrevious[p].id)) {
+						markDirty(sortedCurrent[c++].visible); // new.
+					}
+					else {
+						const Item& before = sortedPrevious[p++];
+						const Item& now = sortedCurrent[c++];
+						if (before.style != now.style || before.bounds.x != now.bounds.x || before.bounds.y != now.bounds.y ||
+							before.bounds.width != now.bounds.width || before.bounds.height != now.bounds.height) {
+							markDirty(before.visible);
+							markDirty(now.visible);
+						}
+					}
+				}
+			}
+
+			void spreadToOverlappingItems() {
+				for (bool grew = true; grew && !fullRedraw;) {
+					grew = false;
+					for (size_t i = 0; i < current.size() && !fullRedraw; ++i) {
+						if (redraw[i]) continue;
+						const Rect& bounds = current[i].visible;
+						bool overlaps = false, inside = false;
+						for (const Rect& rect : dirty) {
+							if (rect.intersects(bounds)) {
+								overlaps = true;
+								if (rect.contains(bounds)) inside = true;
+							}
+						}
+						if (!overlaps) continue;
+						redraw[i] = true;
+						if (!inside) {
+							markDirty(bounds);
+							grew = true;
+						}
+					}
+				}
+			}
+
+		private: // Fields:
+			static const size_t maxDirtyRects = 64;
+
+			Rect screen;
+			bool enabled = true;
+			bool forceFull = true;
+			float fullRedrawThreshold = 0.5f;
+
+			std::vector<Item> previous, current;
+			std::vector<Rect> previousInvalidated, invalidated;
+
+			bool fullRedraw = true;
+			std::vector<Rect> dirty;
+			std::vector<bool> redraw;
+			int64_t dirtyArea = 0;
+			int32_t dirtyTop = 0, dirtyBottom = 0;
+
+			// scratch:
+			std::vector<Item> sortedPrevious, sortedCurrent;
+		};
+	}
+}
@@ -0,0 +1,338 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+
+#include<algorithm>
+#include<cstdint>
+#include<functional>
+#include<string>
+#include<vector>
+
+namespace JesseRussell {
+	namespace Graphics {
+		// o----------o
+		// | DrawList |
+		// o----------o
+
+		// Records FillRect, DrawRect, DrawSprite and DrawString calls instead of drawing them, to be drawn later by
+		// execute, as many times as needed. Meant for things that stay the same from frame to frame, like a HUD: record it
+		// once, execute it every frame, and clear and record it again when it changes.
+		//
+		// Before drawing, the commands are compiled: the ones entirely off the draw target are dropped, the rest are put
+		// in layer order, and within a layer, commands of the same kind, sprite, colour and mode are batched together
+		// where that doesn't change the picture. A command only moves up past commands whose bounds it doesn't touch, so
+		// wherever two commands overlap, they still draw in the order they were recorded. Fills in the same batch that
+		// exactly share an edge are merged into one. The compiled commands are kept until something is recorded or the
+		// draw target changes size.
+		//
+		// So layers draw in order, lowest first, and within a layer the result is the same as drawing the commands one
+		// after another.
+		//
+		// Nothing is allocated once the buffers have grown to fit: clear keeps their memory, and text is kept in one
+		// buffer of characters. Sprites are read while executing, so they have to stay alive until then.
+		class DrawList {
+		public: // Properties:
+			// Commands recorded since the last clear.
+			size_t getCommandCount() const { return commands.size(); }
+			// Commands the last compile left to draw, after culling and merging.
+			size_t getDrawnCount() const { return compiled.size(); }
+
+			// Like the engine's, these apply to the commands recorded after them. A CUSTOM command uses whatever
+			// function the engine has when it's executed.
+			uint8_t getLayer() const { return layer; }
+			void setLayer(uint8_t value) { layer = value; }
+			void setPixelMode(olc::Pixel::Mode value) { mode = value; }
+			void setPixelBlend(float value) { blend = std::min(std::max(value, 0.0f), 1.0f); }
+
+		public: // recording:
+			void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, olc::Pixel p) {
+				add(Command::FILL_RECT, x, y, w, h, p);
+			}
+
+			void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, olc::Pixel p) {
+				add(Command::DRAW_RECT, x, y, w, h, p);
+			}
+
+			void drawSprite(int32_t x, int32_t y, olc::Sprite* sprite, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE) {
+				if (sprite == nullptr) return;
+				drawPartialSprite(x, y, sprite, 0, 0, sprite->width, sprite->height, scale, flip);
+			}
+
+			void drawPartialSprite(int32_t x, int32_t y, olc::Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE) {
+				if (sprite == nullptr) return;
+				Command& command = add(Command::SPRITE, x, y, w, h, olc::WHITE);
+				command.sprite = sprite;
+				command.ox = ox;
+				command.oy = oy;
+				command.scale = scale;
+				command.flip = flip;
+			}
+
+			// The text is copied.
+			void drawString(int32_t x, int32_t y, const std::string& text, olc::Pixel p = olc::WHITE, uint32_t scale = 1) {
+				// The size GetTextSize would give it.
+				int32_t columns = 0, lines = 1, column = 0;
+				for (char c : text) {
+					if (c == '\n') {
+						++lines;
+						column = 0;
+					}
+					else columns = std::max(columns, ++column);
+				}
+				int32_t s = (int32_t)std::max(scale, 1u);
+				Command& command = add(Command::STRING, x, y, columns * 8 * s, lines * 8 * s, p);
+				command.ox = (int32_t)characters.size();
+				command.scale = scale;
+				characters.insert(characters.end(), text.begin(), text.end());
+				characters.push_back('\0');
+			}
+
+		public: // Methods:
+			// Forgets every command, keeping the memory for the next ones.
+			void clear() {
+				commands.clear();
+				characters.clear();
+				compiled.clear();
+				valid = false;
+			}
+
+			// Draws everything recorded onto the engine's draw target, compiling first if anything changed. The commands
+			// are kept, to be executed again. The engine's pixel mode and blend are put back afterwards.
+			void execute(olc::PixelGameEngine& pge) {
+				if (pge.GetDrawTarget() == nullptr) return;
+				int32_t width = pge.GetDrawTargetWidth(), height = pge.GetDrawTargetHeight();
+				if (!valid || width != compiledWidth || height != compiledHeight) compile(width, height);
+
+				olc::Pixel::Mode oldMode = pge.GetPixelMode();
+				float oldBlend = pge.GetPixelBlend();
+				uint8_t currentMode = 0xFF;
+				float currentBlend = -1.0f;
+				for (const Command& c : compiled) {
+					if (c.mode != currentMode) pge.SetPixelMode((olc::Pixel::Mode)(currentMode = c.mode));
+					if (c.blend != currentBlend) pge.SetPixelBlend(currentBlend = c.blend);
+
+					switch (c.type) {
+					case Command::FILL_RECT:
+						pge.FillRect(c.x, c.y, c.w, c.h, c.colour);
+						break;
+					case Command::DRAW_RECT:
+						pge.DrawRect(c.x, c.y, c.w, c.h, c.colour);
+						break;
+					case Command::SPRITE:
+						pge.DrawPartialSprite(c.x, c.y, c.sprite, c.ox, c.oy, c.w, c.h, c.scale, c.flip);
+						break;
+					case Command::STRING:
+						pge.DrawString(c.x, c.y, characters.data() + c.ox, c.colour, c.scale);
+						break;
+					}
+				}
+				pge.SetPixelMode(oldMode);
+				pge.SetPixelBlend(oldBlend);
+			}
+
+		private: // types:
+			struct Command {
+				// In the order they're drawn within a layer.
+				enum Type : uint8_t { FILL_RECT, DRAW_RECT, SPRITE, STRING };
+				Type type;
+				uint8_t layer;
+				uint8_t mode;
+				uint8_t flip;
+				float blend;
+				olc::Pixel colour;
+				int32_t x, y, w, h;
+				int32_t ox, oy;       // sprite: where in it to draw from. string: offset of its characters, null terminated.
+				olc::Sprite* sprite;
+				uint32_t scale;
+				uint32_t sequence;    // order recorded in, so sorting is repeatable.
+			};
+
+			struct Bounds {
+				int32_t left, top, right, bottom;
+			};
+
+			// Commands of compiled that are drawn together, linked through nextInBatch in the order they were recorded.
+			struct Batch {
+				uint32_t first, last;
+				Bounds bounds; // of all of them.
+			};
+
+			static constexpr uint32_t noCommand = UINT32_MAX;
+
+		private:
+			Command& add(Command::Type type, int32_t x, int32_t y, int32_t w, int32_t h, olc::Pixel colour) {
+				Command command = {};
+				command.type = type;
+				command.layer = layer;
+				command.mode = (uint8_t)mode;
+				command.blend = blend;
+				command.colour = colour;
+				command.x = x;
+				command.y = y;
+				command.w = w;
+				command.h = h;
+				command.sequence = (uint32_t)commands.size();
+				commands.push_back(command);
+				valid = false;
+				return commands.back();
+			}
+
+			// The pixels c could touch, right and bottom exclusive. Empty if it can't touch any.
+			static Bounds boundsOf(const Command& c) {
+				Bounds b = { c.x, c.y, 0, 0 };
+				switch (c.type) {
+				case Command::FILL_RECT:
+					if (c.w <= 0 || c.h <= 0) return { 0, 0, 0, 0 };
+					b.right = c.x + c.w;
+					b.bottom = c.y + c.h;
+					break;
+				case Command::DRAW_RECT:
+					b.left = std::min(c.x, c.x + c.w);
+					b.top = std::min(c.y, c.y + c.h);
+					b.right = std::max(c.x, c.x + c.w) + 1;
+					b.bottom = std::max(c.y, c.y + c.h) + 1;
+					break;
+				case Command::SPRITE: {
+					if (c.w <= 0 || c.h <= 0) return { 0, 0, 0, 0 };
+					int32_t s = (int32_t)std::max(c.scale, 1u);
+					b.right = c.x + c.w * s;
+					b.bottom = c.y + c.h * s;
+					break;
+				}
+				default:
+					b.right = c.x + c.w;
+					b.bottom = c.y + c.h;
+					break;
+				}
+				return b;
+			}
+
+			static bool intersects(const Bounds& a, const Bounds& b) {
+				return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+			}
+
+			// Whether a and b only differ in where they are (and what text), so they can be drawn as one batch.
+			static bool isSameBatch(const Command& a, const Command& b) {
+				return a.type == b.type && a.sprite == b.sprite && a.colour == b.colour && a.mode == b.mode && a.blend == b.blend;
+			}
+
+			// Whether anything in batch touches bounds.
+			bool overlaps(const Batch& batch, const Bounds& bounds) const {
+				if (!intersects(batch.bounds, bounds)) return false;
+				for (uint32_t i = batch.first; i != noCommand; i = nextInBatch[i])
+					if (intersects(this->bounds[i], bounds)) return true;
+				return false;
+			}
+
+			// Merges each command of [begin, end) into the one kept before it where merge says it can, and moves up the
+			// ones kept. Returns the new end.
+			template<typename Merge>
+			static Command* mergeRuns(Command* begin, Command* end, Merge merge) {
+				Command* out = begin;
+				for (Command* c = begin; c != end; ++c) {
+					if (out != begin && merge(out[-1], *c)) continue;
+					*out++ = *c;
+				}
+				return out;
+			}
+
+			// Fills of one batch are the same operation, so their order doesn't matter: they're sorted and merged side by
+			// side, then one on top of the other. Returns the new end.
+			static Command* mergeFills(Command* begin, Command* end) {
+				std::sort(begin, end, [](const Command& a, const Command& b) {
+					if (a.y != b.y) return a.y < b.y;
+					if (a.h != b.h) return a.h < b.h;
+					if (a.x != b.x) return a.x < b.x;
+					return a.sequence < b.sequence;
+				});
+				Command* merged = mergeRuns(begin, end, [](Command& a, const Command& b) {
+					if (a.y != b.y || a.h != b.h || a.x + a.w != b.x) return false;
+					a.w += b.w;
+					return true;
+				});
+				std::sort(begin, merged, [](const Command& a, const Command& b) {
+					if (a.x != b.x) return a.x < b.x;
+					if (a.w != b.w) return a.w < b.w;
+					if (a.y != b.y) return a.y < b.y;
+					return a.sequence < b.sequence;
+				});
+				return mergeRuns(begin, merged, [](Command& a, const Command& b) {
+					if (a.x != b.x || a.w != b.w || a.y + a.h != b.y) return false;
+					a.h += b.h;
+					return true;
+				});
+			}
+
+			void compile(int32_t width, int32_t height) {
+				const Bounds target = { 0, 0, width, height };
+				compiled.clear();
+				for (const Command& c : commands)
+					if (intersects(boundsOf(c), target)) compiled.push_back(c);
+				// recorded order within each layer.
+				std::sort(compiled.begin(), compiled.end(), [](const Command& a, const Command& b) {
+					return a.layer != b.layer ? a.layer < b.layer : a.sequence < b.sequence;
+				});
+
+				bounds.resize(compiled.size());
+				for (size_t i = 0; i < compiled.size(); ++i) bounds[i] = boundsOf(compiled[i]);
+				nextInBatch.assign(compiled.size(), noCommand);
+				ordered.clear();
+
+				for (size_t layerBegin = 0; layerBegin < compiled.size();) {
+					size_t layerEnd = layerBegin + 1;
+					while (layerEnd < compiled.size() && compiled[layerEnd].layer == compiled[layerBegin].layer) ++layerEnd;
+
+					// Each command joins the earliest batch like it that nothing it touches was drawn after, or starts a
+					// new one at the end.
+					batches.clear();
+					for (size_t i = layerBegin; i < layerEnd; ++i) {
+						size_t join = batches.size();
+						for (size_t b = batches.size(); b-- > 0;) {
+							if (isSameBatch(compiled[batches[b].first], compiled[i])) join = b;
+							if (overlaps(batches[b], bounds[i])) break;
+						}
+						if (join == batches.size()) {
+							batches.push_back({ (uint32_t)i, (uint32_t)i, bounds[i] });
+							continue;
+						}
+						Batch& batch = batches[join];
+						nextInBatch[batch.last] = (uint32_t)i;
+						batch.last = (uint32_t)i;
+						batch.bounds = { std::min(batch.bounds.left, bounds[i].left), std::min(batch.bounds.top, bounds[i].top),
+							std::max(batch.bounds.right, bounds[i].right), std::max(batch.bounds.bottom, bounds[i].bottom) };
+					}
+
+					for (const Batch& batch : batches) {
+						size_t start = ordered.size();
+						for (uint32_t i = batch.first; i != noCommand; i = nextInBatch[i])
+							ordered.push_back(compiled[i]);
+						if (compiled[batch.first].type == Command::FILL_RECT && ordered.size() - start > 1)
+							ordered.resize((size_t)(mergeFills(ordered.data() + start, ordered.data() + ordered.size()) - ordered.data()));
+					}
+					layerBegin = layerEnd;
+				}
+				compiled.swap(ordered);
+
+				compiledWidth = width;
+				compiledHeight = height;
+				valid = true;
+			}
+
+		private: // Fields:
+			uint8_t layer = 0;
+			uint8_t mode = olc::Pixel::NORMAL;
+			float blend = 1.0f;
+
+			std::vector<Command> commands;
+			std::vector<char> characters;
+			std::vector<Command> compiled;
+			bool valid = false;
+
+			// compile's scratch, kept between calls:
+			std::vector<Bounds> bounds;      // of each compiled command.
+			std::vector<uint32_t> nextInBatch;
+			std::vector<Batch> batches;
+			std::vector<Command> ordered;
+			int32_t compiledWidth = 0, compiledHeight = 0;
+		};
+	}
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "PlatformPhysics.h"
+
+#include<algorithm>
+#include<cstdint>
+#include<initializer_list>
+#include<typeinfo>
+#include<vector>
+
+namespace phy {
+	// o-------------------o
+	// | GeometryOptimizer |
+	// o-------------------o
+
+	// Merges static boxes into as few non-overlapping boxes as it greedily can, covering exactly the same area.
+	// Walls built from lots of small, touching or overlapping boxes (mouse drawn ones, tiles) become a handful of big
+	// ones, which means fewer pairs to test and no seams between them for things to catch on.
+	//
+	// How: every distinct box edge becomes a grid line, so the boxes turn into cells of an uneven grid, filled or not.
+	// Then from each filled cell not used yet, a box is grown as far right as it can go, then as far down as the whole
+	// width of it can. Boxes that end up sharing a whole edge are joined afterwards. Grids with more than maxCells cells are split in two (boxes across the split are cut), so big
+	// levels cost about n log n instead of n squared, at the price of the odd extra seam along a split.
+	class GeometryOptimizer {
+	public: // Properties:
+		void setMaxCells(size_t value) {
+			boxMerger.maxCells = value > 4 ? value : 4;
+			entityMerger.maxCells = boxMerger.maxCells;
+		}
+
+	public: // boxes:
+		void merge(std::vector<StaticBox>& boxes) {
+			output.clear();
+			// boxes without any area can't be merged with anything (and can't be lost either), so they're kept as they are.
+			std::vector<Merger<float>::Edges> solid;
+			solid.reserve(boxes.size());
+			for (const StaticBox& box : boxes) {
+				if (box.width > 0 && box.height > 0) solid.push_back({ box.x, box.y, box.x + box.width, box.y + box.height });
+				else output.push_back(box);
+			}
+			for (const Merger<float>::Edges& box : boxMerger.run(solid))
+				output.push_back({ box.x1, box.y1, box.x2 - box.x1, box.y2 - box.y1 });
+			boxes.swap(output);
+		}
+
+	public: // entities:
+		// Merges the engine's plain static entities: objects of exactly type Entity, not moving. Subclasses are game
+		// objects (or someone else's, like ChunkedWorld's), so they're left alone. Merged entities are deleted, so nothing
+		// may hold on to them. Returns how many fewer entities the engine has.
+		size_t mergeStaticEntities(Engine& engine) {
+			victims.clear();
+			for (auto iter = engine.entities_cbegin(); iter != engine.entities_cend(); ++iter)
+				if (isMergeable(**iter)) victims.push_back(*iter);
+			return replace(engine, nullptr);
+		}
+
+		// Adds a static box, merged with the plain static entities it overlaps or touches, so editing a level doesn't
+		// leave it any more fragmented than before. Returns how many entities the box was merged with.
+		size_t addStaticEntity(Engine& engine, const vector2& position, const Box& box) {
+			CollisionBox added(position, box);
+			victims.clear();
+			for (auto iter = engine.entities_cbegin(); iter != engine.entities_cend(); ++iter) {
+				Entity& e = **iter;
+				if (isMergeable(e) && touches(e, added)) victims.push_back(*iter);
+			}
+			size_t merged = victims.size();
+			replace(engine, &added);
+			return merged;
+		}
+
+	private: // entities:
+		static bool isMergeable(Entity& e) {
+			return !e.isDynamic() && typeid(e) == typeid(Entity) && e.getVelocity_x() == 0 && e.getVelocity_y() == 0;
+		}
+
+		static bool touches(const CollisionBox& a, const CollisionBox& b) {
+			return a.getX1() <= b.getX2() && b.getX1() <= a.getX2() && a.getY1() <= b.getY2() && b.getY1() <= a.getY2();
+		}
+
+		// Swaps victims for the merge of victims and extra (if any). Merged in scalar, not through StaticBox's floats,
+		// so with PHY_FIXED_POINT every edge stays exactly where it was.
+		size_t replace(Engine& engine, const CollisionBox* extra) {
+			std::vector<Entity*> merged;
+			entityEdges.clear();
+			auto add = [this, &merged](const CollisionBox& c) {
+				// boxes without any area can't be merged with anything, so they're kept as they are.
+				if (c.getWidth() > 0 && c.getHeight() > 0) entityEdges.push_back({ c.getX1(), c.getY1(), c.getX2(), c.getY2() });
+				else merged.push_back(new Entity(c.getPosition(), c.getCollisionBox()));
+			};
+			if (extra != nullptr) add(*extra);
+			for (Entity* e : victims) add(*e);
+
+			for (const Merger<scalar>::Edges& box : entityMerger.run(entityEdges))
+				merged.push_back(new Entity(vector2(box.x1, box.y1), Box(box.x2 - box.x1, box.y2 - box.y1)));
+
+			size_t before = victims.size() + (extra != nullptr ? 1 : 0);
+			if (!victims.empty()) engine.entities_deleteBatch(victims);
+			engine.entities_addBatch(merged);
+			return before > merged.size() ? before - merged.size() : 0;
+		}
+
+	private: // merging:
+		// The merge itself, on edges of type T: float for StaticBox, scalar for entities.
+		template<typename T>
+		class Merger {
+		public:
+			// Boxes are handled as edges while merging, so cutting them doesn't round anything.
+			struct Edges {
+				T x1, y1, x2, y2;
+			};
+
+			size_t maxCells = 1 << 20;
+
+			// Merges boxes (which it may empty) and returns the result, valid until the next run.
+			const std::vector<Edges>& run(std::vector<Edges>& boxes) {
+				merged.clear();
+				mergeArea(boxes, true);
+				joinNeighbours();
+				return merged;
+			}
+
+		private:
+			void emit(T x1, T y1, T x2, T y2) { merged.push_back({ x1, y1, x2, y2 }); }
+
+			// Greedy growing leaves strips that could have been one box (and splitting leaves seams), so afterwards, boxes
+			// that share a whole edge are joined until there are none left.
+			void joinNeighbours() {
+				while (joinAlong(true) | joinAlong(false)) {}
+			}
+
+			bool joinAlong(bool vertical) {
+				// sorted so that boxes of the same span sit next to each other, in order along the other axis.
+				std::sort(merged.begin(), merged.end(), [vertical](const Edges& a, const Edges& b) {
+					if (vertical) return a.x1 != b.x1 ? a.x1 < b.x1 : a.x2 != b.x2 ? a.x2 < b.x2 : a.y1 < b.y1;
+					return a.y1 != b.y1 ? a.y1 < b.y1 : a.y2 != b.y2 ? a.y2 < b.y2 : a.x1 < b.x1;
+				});
+
+				size_t kept = 0;
+				for (size_t i = 0; i < merged.size(); ++i) {
+					if (kept != 0) {
+						Edges& last = merged[kept - 1];
+						const Edges& box = merged[i];
+						if (vertical && last.x1 == box.x1 && last.x2 == box.x2 && last.y2 == box.y1) {
+							last.y2 = box.y2;
+							continue;
+						}
+						if (!vertical && last.y1 == box.y1 && last.y2 == box.y2 && last.x2 == box.x1) {
+							last.x2 = box.x2;
+							continue;
+						}
+					}
+					merged[kept++] = merged[i];
+				}
+				bool joined = kept != merged.size();
+				merged.resize(kept);
+				return joined;
+			}
+
+			void mergeArea(std::vector<Edges>& boxes, bool splitX) {
+				if (boxes.empty()) return;
+				if (boxes.size() == 1) {
+					emit(boxes[0].x1, boxes[0].y1, boxes[0].x2, boxes[0].y2);
+					return;
+				}
+
+				xs.clear();
+				ys.clear();
+				for (const Edges& box : boxes) {
+					xs.push_back(box.x1);
+					xs.push_back(box.x2);
+					ys.push_back(box.y1);
+					ys.push_back(box.y2);
+				}
+				sortUnique(xs);
+				sortUnique(ys);
+				size_t columns = xs.size() - 1, rows = ys.size() - 1;
+
+				if ((uint64_t)columns * rows > maxCells) {
+					split(boxes, splitX);
+					return;
+				}
+
+				enum : uint8_t { EMPTY, FILLED, USED };
+				cells.assign(columns * rows, EMPTY);
+				for (const Edges& box : boxes) {
+					size_t column1 = indexOf(xs, box.x1), column2 = indexOf(xs, box.x2);
+					size_t row1 = indexOf(ys, box.y1), row2 = indexOf(ys, box.y2);
+					for (size_t row = row1; row < row2; ++row)
+						std::fill(cells.begin() + row * columns + column1, cells.begin() + row * columns + column2, (uint8_t)FILLED);
+				}
+
+				for (size_t row = 0; row < rows; ++row) {
+					for (size_t column = 0; column < columns; ++column) {
+						if (cells[row * columns + column] != FILLED) continue;
+
+						size_t column2 = column + 1;
+						while (column2 < columns && cells[row * columns + column2] == FILLED) ++column2;
+
+						size_t row2 = row + 1;
+						for (; row2 < rows; ++row2) {
+							const uint8_t* line = &cells[row2 * columns];
+							if (std::find_if(line + column, line + column2, [](uint8_t cell) { return cell != FILLED; }) != line + column2) break;
+						}
+
+						for (size_t r = row; r < row2; ++r)
+							std::fill(cells.begin() + r * columns + column, cells.begin() + r * columns + column2, (uint8_t)USED);
+						emit(xs[column], ys[row], xs[column2], ys[row2]);
+					}
+				}
+			}
+
+			// Cuts the area in two at the median box edge and merges each half on its own, alternating between axes.
+			void split(std::vector<Edges>& boxes, bool splitX, bool otherAxisTried = false) {
+				std::vector<T> starts;
+				starts.reserve(boxes.size());
+				for (const Edges& box : boxes) starts.push_back(splitX ? box.x1 : box.y1);
+				std::nth_element(starts.begin(), starts.begin() + starts.size() / 2, starts.end());
+				T at = starts[starts.size() / 2];
+				// every box starting at the minimum would leave one half empty, so split at the nearest end past it instead.
+				if (at == *std::min_element(starts.begin(), starts.end())) {
+					T next = at;
+					for (const Edges& box : boxes) {
+						T end = splitX ? box.x2 : box.y2;
+						if (end > at && (next == at || end < next)) next = end;
+					}
+					at = next;
+				}
+
+				std::vector<Edges> low, high;
+				for (const Edges& box : boxes) {
+					T start = splitX ? box.x1 : box.y1;
+					T end = splitX ? box.x2 : box.y2;
+					if (end <= at) low.push_back(box);
+					else if (start >= at) high.push_back(box);
+					else {
+						Edges a = box, b = box;
+						(splitX ? a.x2 : a.y2) = at;
+						(splitX ? b.x1 : b.y1) = at;
+						low.push_back(a);
+						high.push_back(b);
+					}
+				}
+
+				if ((low.empty() || high.empty()) && !otherAxisTried) {
+					split(boxes, !splitX, true);
+					return;
+				}
+				// can't be cut along either axis (they're all on top of each other), so merge it as it is, however big.
+				if (low.empty() || high.empty()) {
+					size_t saved = maxCells;
+					maxCells = (size_t)-1;
+					mergeArea(boxes, !splitX);
+					maxCells = saved;
+					return;
+				}
+
+				boxes.clear();
+				boxes.shrink_to_fit();
+				mergeArea(low, !splitX);
+				mergeArea(high, !splitX);
+			}
+
+			static void sortUnique(std::vector<T>& values) {
+				std::sort(values.begin(), values.end());
+				values.erase(std::unique(values.begin(), values.end()), values.end());
+			}
+
+			static size_t indexOf(const std::vector<T>& values, T value) {
+				return (size_t)(std::lower_bound(values.begin(), values.end(), value) - values.begin());
+			}
+
+			// scratch, kept between calls:
+			std::vector<Edges> merged;
+			std::vector<T> xs, ys;
+			std::vector<uint8_t> cells;
+		};
+
+	private: // Fields:
+		Merger<float> boxMerger;
+		Merger<scalar> entityMerger;
+
+		// scratch, kept between calls:
+		std::vector<StaticBox> output;
+		std::vector<Merger<scalar>::Edges> entityEdges;
+		std::vector<Entity*> victims;
+	};
+}
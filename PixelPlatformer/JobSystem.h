@@ -0,0 +1,312 @@
+#pragma once
+#include<atomic>
+#include<condition_variable>
+#include<functional>
+#include<initializer_list>
+#include<mutex>
+#include<thread>
+#include<type_traits>
+#include<vector>
+
+namespace JesseRussell {
+	namespace Threading {
+		// o-----------o
+		// | JobSystem |
+		// o-----------o
+
+		// Small work-stealing scheduler.
+		//
+		// Every worker thread has its own queue. It takes its newest task first (still hot in cache), and when it runs dry
+		// it steals the oldest task from another queue. Threads that aren't workers, such as the game loop, share one
+		// extra queue. They join in whenever they wait, so the caller is never idle while its work is outstanding.
+		//
+		// parallel_for splits a range into chunks. Chunks are plain values in the queues, so splitting doesn't allocate.
+		// run() schedules a general job, optionally after other jobs, and returns a handle that wait() joins on.
+		class JobSystem {
+		private: // types:
+			struct Task {
+				void(*function)(void* context, size_t begin, size_t end);
+				void* context;
+				size_t begin, end;
+				std::atomic<size_t>* remaining; // decremented once the task has run.
+			};
+
+			// Owner pushes and pops at the back, thieves take from the front.
+			class WorkQueue {
+			public:
+				void push(const Task& task) {
+					std::lock_guard<std::mutex> lock(mutex);
+					if (count == ring.size()) grow();
+					ring[(head + count) & (ring.size() - 1)] = task;
+					++count;
+				}
+
+				bool pop(Task& out) {
+					std::lock_guard<std::mutex> lock(mutex);
+					if (count == 0) return false;
+					--count;
+					out = ring[(head + count) & (ring.size() - 1)];
+					return true;
+				}
+
+				bool steal(Task& out) {
+					std::lock_guard<std::mutex> lock(mutex);
+					if (count == 0) return false;
+					out = ring[head];
+					head = (head + 1) & (ring.size() - 1);
+					--count;
+					return true;
+				}
+
+			private:
+				void grow() {
+					std::vector<Task> bigger(ring.empty() ? 256 : ring.size() * 2);
+					for (size_t i = 0; i < count; ++i)
+						bigger[i] = ring[(head + i) & (ring.size() - 1)];
+					ring.swap(bigger);
+					head = 0;
+				}
+
+				std::mutex mutex;
+				std::vector<Task> ring;
+				size_t head = 0;
+				size_t count = 0;
+			};
+
+			struct Job {
+				std::function<void()> work;
+				std::atomic<int> references{ 2 };  // one for the scheduler, one for the JobHandle.
+				std::atomic<int> unfinishedPrerequisites{ 1 }; // starts at 1 so it can't run while run() is still wiring it up.
+				std::atomic<size_t> remaining{ 1 };
+				std::mutex continuationsMutex;
+				std::vector<Job*> continuations;
+				bool finished = false;
+			};
+
+			struct ThreadSlot {
+				const JobSystem* system = nullptr;
+				size_t index = 0;
+			};
+
+			static ThreadSlot& currentSlot() {
+				thread_local ThreadSlot slot;
+				return slot;
+			}
+
+			// The system whose task the calling thread is running, if any.
+			static JobSystem*& executingSystem() {
+				thread_local JobSystem* system = nullptr;
+				return system;
+			}
+
+		public: // JobHandle:
+			class JobHandle {
+				friend class JobSystem;
+			public:
+				JobHandle() = default;
+				JobHandle(const JobHandle& other) : job(other.job) { if (job) job->references.fetch_add(1, std::memory_order_relaxed); }
+				JobHandle& operator=(JobHandle other) { std::swap(job, other.job); return *this; }
+				~JobHandle() { release(job); }
+
+				bool isValid() const { return job != nullptr; }
+				bool isFinished() const { return job == nullptr || job->remaining.load(std::memory_order_acquire) == 0; }
+
+			private:
+				explicit JobHandle(Job* job) : job(job) {}
+				Job* job = nullptr;
+			};
+
+		public: // Constructors:
+			// threadCount counts the calling thread, which helps out whenever it waits. 0 means one per hardware thread.
+			// Everything scheduled must have been waited on before the JobSystem is destroyed.
+			explicit JobSystem(unsigned threadCount = 0)
+				// queue 0 is shared by every thread that isn't a worker.
+				: queues(threadCount != 0 ? threadCount : std::thread::hardware_concurrency() != 0 ? std::thread::hardware_concurrency() : 1) {
+				for (size_t i = 1; i < queues.size(); ++i)
+					workers.emplace_back(&JobSystem::workerMain, this, i);
+			}
+
+			~JobSystem() {
+				{
+					std::lock_guard<std::mutex> lock(sleepMutex);
+					stopping = true;
+				}
+				wakeCondition.notify_all();
+				for (std::thread& worker : workers)
+					worker.join();
+			}
+
+			JobSystem(const JobSystem&) = delete;
+			JobSystem& operator=(const JobSystem&) = delete;
+
+		public: // Properties:
+			// Worker threads plus the calling thread.
+			unsigned getThreadCount() const { return (unsigned)queues.size(); }
+
+			// 0 for threads that aren't this system's workers, otherwise 1 to getThreadCount() - 1.
+			// Handy for per-thread scratch space indexed [0, getThreadCount()). Every non-worker shares slot 0 though, and
+			// any of them may run another's chunks while it waits, so a submitter needs a slot of its own if more than one
+			// non-worker thread uses the system (see TiledRenderer::execute).
+			size_t getCurrentThreadIndex() const {
+				const ThreadSlot& slot = currentSlot();
+				return slot.system == this ? slot.index : 0;
+			}
+
+		public: // parallel_for:
+			// Calls function(chunkBegin, chunkEnd) over [begin, end) in chunks of at most grainSize, on every thread, and
+			// returns once all of them have finished. Pick grainSize so one chunk is worth at least a few microseconds.
+			template<typename Function>
+			void parallel_for(size_t begin, size_t end, size_t grainSize, Function&& function) {
+				if (end <= begin) return;
+				if (grainSize == 0) grainSize = 1;
+				size_t chunks = (end - begin + grainSize - 1) / grainSize;
+				if (chunks == 1 || queues.size() == 1) {
+					for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grainSize)
+						function(chunkBegin, chunkBegin + grainSize < end ? chunkBegin + grainSize : end);
+					return;
+				}
+
+				using FunctionType = typename std::remove_reference<Function>::type;
+				std::atomic<size_t> remaining{ chunks };
+				WorkQueue& queue = queues[getCurrentThreadIndex()];
+				// pushed back to front, so the owner's pops go front to back and thieves start at the far end.
+				for (size_t chunk = chunks; chunk-- > 0;) {
+					size_t chunkBegin = begin + chunk * grainSize;
+					size_t chunkEnd = chunkBegin + grainSize < end ? chunkBegin + grainSize : end;
+					queue.push({
+						[](void* context, size_t b, size_t e) { (*(FunctionType*)context)(b, e); },
+						(void*)&function, chunkBegin, chunkEnd, &remaining });
+				}
+				wakeWorkers(chunks);
+				helpUntil(remaining);
+			}
+
+		public: // jobs:
+			// Schedules work to run once every job in after has finished.
+			JobHandle run(std::function<void()> work, std::initializer_list<JobHandle> after = {}) {
+				Job* job = new Job;
+				job->work = std::move(work);
+
+				for (const JobHandle& prerequisite : after) {
+					if (prerequisite.job == nullptr) continue;
+					std::lock_guard<std::mutex> lock(prerequisite.job->continuationsMutex);
+					if (!prerequisite.job->finished) {
+						job->unfinishedPrerequisites.fetch_add(1, std::memory_order_relaxed);
+						prerequisite.job->continuations.push_back(job);
+					}
+				}
+
+				if (job->unfinishedPrerequisites.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					schedule(job);
+				return JobHandle(job);
+			}
+
+			// Runs other tasks on the calling thread until job has finished.
+			void wait(const JobHandle& job) {
+				if (job.job != nullptr)
+					helpUntil(job.job->remaining);
+			}
+
+		private: // scheduling:
+			void schedule(Job* job) {
+				queues[getCurrentThreadIndex()].push({ &JobSystem::runJob, job, 0, 0, &job->remaining });
+				wakeWorkers(1);
+			}
+
+			static void runJob(void* context, size_t, size_t) {
+				Job* job = (Job*)context;
+				job->work();
+
+				std::vector<Job*> continuations;
+				{
+					std::lock_guard<std::mutex> lock(job->continuationsMutex);
+					job->finished = true;
+					continuations.swap(job->continuations);
+				}
+				JobSystem& system = *executingSystem();
+				for (Job* continuation : continuations)
+					if (continuation->unfinishedPrerequisites.fetch_sub(1, std::memory_order_acq_rel) == 1)
+						system.schedule(continuation);
+			}
+
+			static void release(Job* job) {
+				if (job != nullptr && job->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					delete job;
+			}
+
+			void execute(const Task& task) {
+				JobSystem* outer = executingSystem();
+				executingSystem() = this;
+				task.function(task.context, task.begin, task.end);
+				executingSystem() = outer;
+
+				bool isJob = task.function == &JobSystem::runJob;
+				task.remaining->fetch_sub(1, std::memory_order_acq_rel);
+				if (isJob) release((Job*)task.context);
+			}
+
+			bool findTask(size_t self, Task& out) {
+				if (queues[self].pop(out)) return true;
+				for (size_t i = 1; i < queues.size(); ++i)
+					if (queues[(self + i) % queues.size()].steal(out)) return true;
+				return false;
+			}
+
+			void helpUntil(const std::atomic<size_t>& remaining) {
+				size_t self = getCurrentThreadIndex();
+				Task task;
+				while (remaining.load(std::memory_order_acquire) != 0) {
+					if (findTask(self, task)) {
+						queued.fetch_sub(1, std::memory_order_relaxed);
+						execute(task);
+					}
+					else std::this_thread::yield();
+				}
+			}
+
+			void wakeWorkers(size_t tasks) {
+				queued.fetch_add(tasks);
+				if (sleeping.load() != 0) {
+					{ std::lock_guard<std::mutex> lock(sleepMutex); }
+					if (tasks == 1) wakeCondition.notify_one();
+					else wakeCondition.notify_all();
+				}
+			}
+
+			void workerMain(size_t index) {
+				currentSlot() = { this, index };
+				Task task;
+				for (;;) {
+					bool found = false;
+					// spin a little before sleeping, tasks tend to come in bursts.
+					for (int attempt = 0; attempt < 64 && !found; ++attempt) {
+						found = findTask(index, task);
+						if (!found) std::this_thread::yield();
+					}
+
+					if (found) {
+						queued.fetch_sub(1, std::memory_order_relaxed);
+						execute(task);
+						continue;
+					}
+
+					std::unique_lock<std::mutex> lock(sleepMutex);
+					sleeping.fetch_add(1);
+					wakeCondition.wait(lock, [this] { return stopping || queued.load() != 0; });
+					sleeping.fetch_sub(1);
+					if (stopping) return;
+				}
+			}
+
+		private: // Fields:
+			std::vector<WorkQueue> queues;
+			std::vector<std::thread> workers;
+
+			std::atomic<size_t> queued{ 0 };
+			std::atomic<unsigned> sleeping{ 0 };
+			std::mutex sleepMutex;
+			std::condition_variable wakeCondition;
+			bool stopping = false;
+		};
+	}
+}
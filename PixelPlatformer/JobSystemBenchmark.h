@@ -0,0 +1,142 @@
+#pragma once
+#include "JobSystem.h"
+#include "PlatformPhysics.h"
+#include "Stopwatch.h"
+
+#include<cmath>
+#include<cstdio>
+#include<vector>
+
+// Run with: PixelPlatformer --bench-jobs [maxThreads]
+namespace JobSystemBenchmark {
+	using JesseRussell::Threading::JobSystem;
+	using JesseRussell::Diagnostics::Clock;
+
+	inline double millisecondsSince(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// Roughly `units` microseconds-ish of arithmetic that the optimizer can't drop.
+	inline float work(unsigned units) {
+		float x = 1.0f;
+		for (unsigned i = 0; i < units * 200; ++i)
+			x = std::sqrt(x + (float)i);
+		return x;
+	}
+
+	// o-------------------o
+	// | overhead per task |
+	// o-------------------o
+	inline void overhead(JobSystem& jobs) {
+		const size_t chunks = 200000;
+		Clock::time_point start = Clock::now();
+		jobs.parallel_for(0, chunks, 1, [](size_t, size_t) {});
+		double forMs = millisecondsSince(start);
+
+		const size_t jobCount = 20000;
+		std::vector<JobSystem::JobHandle> handles(jobCount);
+		start = Clock::now();
+		for (size_t i = 0; i < jobCount; ++i)
+			handles[i] = jobs.run([] {});
+		for (const JobSystem::JobHandle& handle : handles)
+			jobs.wait(handle);
+		double runMs = millisecondsSince(start);
+
+		// a chain: every job depends on the one before it.
+		start = Clock::now();
+		JobSystem::JobHandle previous;
+		for (size_t i = 0; i < jobCount; ++i)
+			previous = jobs.run([] {}, { previous });
+		jobs.wait(previous);
+		double chainMs = millisecondsSince(start);
+
+		std::printf("  overhead: parallel_for %6.0f ns/chunk   run %6.0f ns/job   dependent chain %6.0f ns/job\n",
+			forMs * 1e6 / chunks, runMs * 1e6 / jobCount, chainMs * 1e6 / jobCount);
+	}
+
+	// o-----------------------------o
+	// | load balance on uneven work |
+	// o-----------------------------o
+	// 4096 "entities", where the first 10% sit in one crowded area and cost 30 times as much to update as the rest.
+	// Splitting the range evenly between threads leaves the thread with the crowd doing most of the work; small chunks
+	// plus stealing spread it out.
+	inline void loadBalance(JobSystem& jobs) {
+		const size_t count = 4096;
+		std::vector<unsigned> cost(count);
+		for (size_t i = 0; i < count; ++i)
+			cost[i] = i < count / 10 ? 30 : 1;
+		std::vector<float> out(count);
+
+		auto measure = [&](size_t grain) {
+			std::vector<double> busy(jobs.getThreadCount(), 0.0);
+			Clock::time_point start = Clock::now();
+			jobs.parallel_for(0, count, grain, [&](size_t begin, size_t end) {
+				Clock::time_point chunkStart = Clock::now();
+				for (size_t i = begin; i < end; ++i)
+					out[i] = work(cost[i]);
+				busy[jobs.getCurrentThreadIndex()] += millisecondsSince(chunkStart);
+			});
+			double total = millisecondsSince(start);
+
+			double sum = 0, most = 0;
+			for (double b : busy) {
+				sum += b;
+				if (b > most) most = b;
+			}
+			double mean = sum / busy.size();
+			std::printf("%8.2f ms (busiest thread %.2fx the mean)", total, mean > 0 ? most / mean : 0.0);
+		};
+
+		std::printf("  uneven work: even split");
+		measure((count + jobs.getThreadCount() - 1) / jobs.getThreadCount());
+		std::printf("   stealing");
+		measure(16);
+		std::printf("\n");
+	}
+
+	// o---------------o
+	// | engine passes |
+	// o---------------o
+	// 40 floors and 1000 boxes, most of them piled into one corner.
+	inline void engine(JobSystem* jobs) {
+		phy::Engine engine;
+		engine.setJobSystem(jobs);
+		for (int i = 0; i < 40; i++)
+			engine.entities_add(new phy::Entity(phy::vector2(phy::scalar(i * 50), phy::scalar(2000)), phy::Box(50, 10)));
+		std::vector<phy::DynamicEntity*> bodies;
+		for (int i = 0; i < 1000; i++) {
+			bool crowded = i % 10 != 0;
+			phy::vector2 position(phy::scalar(crowded ? (i * 7) % 200 : (i * 37) % 1900), phy::scalar(crowded ? (i * 11) % 200 : (i * 53) % 1500));
+			phy::DynamicEntity* body = new phy::DynamicEntity(position, phy::Box(8, 8), 1);
+			bodies.push_back(body);
+			engine.entities_add(body);
+		}
+
+		const int steps = 30;
+		Clock::time_point start = Clock::now();
+		for (int step = 0; step < steps; ++step) {
+			for (phy::DynamicEntity* body : bodies)
+				body->addForce(phy::vector2(0, phy::scalar(0.5)));
+			engine.update(phy::scalar(1) / 60);
+		}
+		std::printf("  engine.update (1040 entities): %8.3f ms/step\n", millisecondsSince(start) / steps);
+	}
+
+	inline int run(unsigned maxThreads) {
+		if (maxThreads == 0) maxThreads = std::thread::hardware_concurrency();
+		if (maxThreads == 0) maxThreads = 1;
+		std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+
+		std::printf("serial:\n");
+		engine(nullptr);
+
+		for (unsigned threads = 1; threads <= maxThreads; ++threads) {
+			std::printf("%u thread%s:\n", threads, threads == 1 ? "" : "s");
+			JobSystem jobs(threads);
+			overhead(jobs);
+			loadBalance(jobs);
+			engine(&jobs);
+		}
+		return 0;
+	}
+}
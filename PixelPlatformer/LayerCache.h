@@ -0,0 +1,74 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+
+#include<cstdint>
+
+namespace JesseRussell {
+	namespace Graphics {
+		// o------------o
+		// | LayerCache |
+		// o------------o
+
+		// Keeps something that rarely changes (the level's static geometry, say) drawn in an olc layer of its own, under
+		// layer 0. It's only drawn again, and its texture only uploaded again, after invalidate(). Everything else keeps
+		// drawing into layer 0 as usual, but has to clear to olc::BLANK instead of a solid colour so the cached layer
+		// shows through.
+		//
+		// Layers are drawn highest index first, so the cache sits under every layer created before it and over every
+		// layer created after it.
+		class LayerCache {
+		public: // Properties:
+			bool isCreated() const { return created; }
+			bool isEnabled() const { return enabled; }
+			bool isValid() const { return valid; }
+			uint8_t getLayer() const { return layer; }
+			// Times update has redrawn the layer.
+			size_t getRedrawCount() const { return redrawCount; }
+
+			// Shows or hides the layer. It's drawn again when it's next enabled, since it wasn't kept up to date.
+			void setEnabled(olc::PixelGameEngine& pge, bool value) {
+				enabled = value;
+				valid = false;
+				if (created) pge.EnableLayer(layer, value);
+			}
+
+			void setBackground(const olc::Pixel& value) {
+				background = value;
+				valid = false;
+			}
+
+		public: // Methods:
+			// Needs the engine's renderer, so call it from OnUserCreate, not before.
+			void create(olc::PixelGameEngine& pge) {
+				layer = (uint8_t)pge.CreateLayer();
+				created = true;
+				valid = false;
+				pge.EnableLayer(layer, enabled);
+			}
+
+			void invalidate() { valid = false; }
+
+			// If the layer isn't up to date, clears it and calls draw() with it as the draw target. Layer 0 is the draw
+			// target again afterwards. Returns whether it redrew.
+			template<typename Draw>
+			bool update(olc::PixelGameEngine& pge, Draw draw) {
+				if (!created || !enabled || valid) return false;
+				pge.SetDrawTarget(layer);
+				pge.Clear(background);
+				draw();
+				pge.SetDrawTarget(nullptr);
+				valid = true;
+				++redrawCount;
+				return true;
+			}
+
+		private: // Fields:
+			uint8_t layer = 0;
+			bool created = false;
+			bool enabled = true;
+			bool valid = false;
+			olc::Pixel background = olc::BLACK;
+			size_t redrawCount = 0;
+		};
+	}
+}
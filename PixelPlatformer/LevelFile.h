@@ -0,0 +1,445 @@
+#pragma once
+
+#include "PlatformPhysics.h"
+#include "GeometryOptimizer.h"
+
+#include<cmath>
+#include<cstdint>
+#include<cstring>
+#include<fstream>
+#include<string>
+#include<vector>
+
+#ifdef _WIN32
+	#if !defined(NOMINMAX)
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace phy {
+	// o--------------o
+	// | Level format |
+	// o--------------o
+
+	// A level file is:
+	//   LevelHeader
+	//   LevelSection[sectionCount]
+	//   each section's array of records, starting on a 16 byte boundary.
+	//
+	// Records are stored exactly as they're laid out in memory, in the byte order of the machine that wrote the file,
+	// so a loader can use them where they are. Loaders skip section types they don't know, so new sections can be added
+	// without breaking old loaders. Changing a record's layout means bumping levelFileVersion.
+	const uint32_t levelFileVersion = 1;
+	const uint32_t levelFileByteOrder = 0x01020304; // reads back as 0x04030201 on a machine of the other byte order.
+
+	enum LevelSectionType : uint32_t {
+		LEVEL_STATIC_BOXES = 1,        // StaticBox
+		LEVEL_STATIC_GRID = 2,         // one LevelGrid
+		LEVEL_STATIC_GRID_CELLS = 3,   // uint32_t, columns * rows + 1 cell starts (see StaticGeometry)
+		LEVEL_STATIC_GRID_INDICES = 4, // uint32_t
+		LEVEL_TILE_LAYERS = 5,         // LevelTileLayer
+		LEVEL_TILES = 6,               // uint16_t, every layer's tiles one after another
+		LEVEL_SPAWN_POINTS = 7,        // LevelSpawnPoint
+		LEVEL_ENTITIES = 8,            // LevelEntity
+	};
+
+	struct LevelHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t byteOrder;
+		uint32_t sectionCount;
+		uint64_t fileSize;
+	};
+
+	struct LevelSection {
+		uint32_t type;
+		uint32_t recordSize;
+		uint64_t count;
+		uint64_t offset; // from the start of the file.
+	};
+
+	struct LevelGrid {
+		float originX, originY;
+		float cellSize;
+		uint32_t columns, rows;
+	};
+
+	// Tile (column, row) is tiles[firstTile + row * columns + column]. 0 means no tile, what the rest mean is up to the game.
+	struct LevelTileLayer {
+		float originX, originY;
+		float tileSize;
+		uint32_t columns, rows;
+		uint32_t firstTile;
+	};
+
+	// Named places, like where the player starts. The ids are up to the game.
+	struct LevelSpawnPoint {
+		uint32_t id;
+		float x, y;
+	};
+
+	// Anything that isn't static geometry. What kind means is up to the game.
+	struct LevelEntity {
+		uint32_t kind;
+		float x, y;
+		float width, height;
+		float mass;
+		float bounciness;
+		uint32_t flags;
+	};
+
+
+
+	// o-------------o
+	// | LevelWriter |
+	// o-------------o
+
+	// Collects a level and saves it in the format above, building the static geometry's grid as it goes.
+	class LevelWriter {
+	public: // Properties:
+		// Width of the static geometry's grid cells. Doubled as needed while saving, so a big, sparse level doesn't get
+		// more cells than boxes.
+		void setGridCellSize(float value) { gridCellSize = value; }
+
+	public: // Methods:
+		void addStaticBox(float x, float y, float width, float height) {
+			// negative sizes are flipped, same as CollisionBox does.
+			if (width < 0) { x += width; width = -width; }
+			if (height < 0) { y += height; height = -height; }
+			boxes.push_back({ x, y, width, height });
+		}
+
+		// Copies columns * rows tile ids from tiles, row by row.
+		void addTileLayer(float originX, float originY, float tileSize, uint32_t columns, uint32_t rows, const uint16_t* tiles) {
+			tileLayers.push_back({ originX, originY, tileSize, columns, rows, (uint32_t)this->tiles.size() });
+			this->tiles.insert(this->tiles.end(), tiles, tiles + (size_t)columns * rows);
+		}
+
+		void addSpawnPoint(uint32_t id, float x, float y) { spawnPoints.push_back({ id, x, y }); }
+
+		void addEntity(const LevelEntity& entity) { entities.push_back(entity); }
+
+		// Merges the static boxes added so far into fewer, non-overlapping ones (see GeometryOptimizer).
+		void mergeStaticBoxes() { GeometryOptimizer().merge(boxes); }
+
+		size_t getStaticBoxCount() const { return boxes.size(); }
+
+		// Returns false if the file couldn't be written.
+		bool save(const std::string& path) const {
+			LevelGrid grid;
+			std::vector<uint32_t> cellStarts, indices;
+			buildGrid(grid, cellStarts, indices);
+
+			struct Pending {
+				LevelSection section;
+				const void* data;
+			};
+			std::vector<Pending> sections;
+			auto add = [&](LevelSectionType type, uint32_t recordSize, size_t count, const void* data) {
+				if (count != 0) sections.push_back({ { (uint32_t)type, recordSize, (uint64_t)count, 0 }, data });
+			};
+			add(LEVEL_STATIC_BOXES, sizeof(StaticBox), boxes.size(), boxes.data());
+			if (!boxes.empty()) {
+				add(LEVEL_STATIC_GRID, sizeof(LevelGrid), 1, &grid);
+				add(LEVEL_STATIC_GRID_CELLS, sizeof(uint32_t), cellStarts.size(), cellStarts.data());
+				add(LEVEL_STATIC_GRID_INDICES, sizeof(uint32_t), indices.size(), indices.data());
+			}
+			add(LEVEL_TILE_LAYERS, sizeof(LevelTileLayer), tileLayers.size(), tileLayers.data());
+			add(LEVEL_TILES, sizeof(uint16_t), tiles.size(), tiles.data());
+			add(LEVEL_SPAWN_POINTS, sizeof(LevelSpawnPoint), spawnPoints.size(), spawnPoints.data());
+			add(LEVEL_ENTITIES, sizeof(LevelEntity), entities.size(), entities.data());
+
+			uint64_t offset = align(sizeof(LevelHeader) + sections.size() * sizeof(LevelSection));
+			for (Pending& pending : sections) {
+				pending.section.offset = offset;
+				offset = align(offset + pending.section.count * pending.section.recordSize);
+			}
+
+			LevelHeader header;
+			std::memcpy(header.magic, "PPLV", 4);
+			header.version = levelFileVersion;
+			header.byteOrder = levelFileByteOrder;
+			header.sectionCount = (uint32_t)sections.size();
+			header.fileSize = offset;
+
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			if (!file) return false;
+			file.write((const char*)&header, sizeof(header));
+			for (const Pending& pending : sections)
+				file.write((const char*)&pending.section, sizeof(LevelSection));
+
+			const char padding[16] = {};
+			uint64_t written = sizeof(LevelHeader) + sections.size() * sizeof(LevelSection);
+			for (const Pending& pending : sections) {
+				file.write(padding, (std::streamsize)(pending.section.offset - written));
+				uint64_t size = pending.section.count * pending.section.recordSize;
+				file.write((const char*)pending.data, (std::streamsize)size);
+				written = pending.section.offset + size;
+			}
+			file.write(padding, (std::streamsize)(offset - written));
+			return (bool)file;
+		}
+
+	private:
+		static uint64_t align(uint64_t offset) { return (offset + 15) & ~(uint64_t)15; }
+
+		// Lists every box in each cell it overlaps, with a counting sort: count per cell, turn counts into starts, fill.
+		void buildGrid(LevelGrid& grid, std::vector<uint32_t>& cellStarts, std::vector<uint32_t>& indices) const {
+			grid = { 0, 0, gridCellSize > 0 ? gridCellSize : 64, 0, 0 };
+			if (boxes.empty()) return;
+
+			float x1 = boxes[0].x, y1 = boxes[0].y, x2 = x1, y2 = y1;
+			for (const StaticBox& box : boxes) {
+				if (box.x < x1) x1 = box.x;
+				if (box.y < y1) y1 = box.y;
+				if (box.x + box.width > x2) x2 = box.x + box.width;
+				if (box.y + box.height > y2) y2 = box.y + box.height;
+			}
+			grid.originX = x1;
+			grid.originY = y1;
+
+			for (;;) {
+				uint64_t columns = (uint64_t)std::floor((x2 - x1) / grid.cellSize) + 1;
+				uint64_t rows = (uint64_t)std::floor((y2 - y1) / grid.cellSize) + 1;
+				if (columns * rows <= boxes.size() * 4 + 1024) {
+					grid.columns = (uint32_t)columns;
+					grid.rows = (uint32_t)rows;
+					break;
+				}
+				grid.cellSize *= 2;
+			}
+
+			cellStarts.assign((size_t)grid.columns * grid.rows + 1, 0);
+			forEachCell(grid, [&](size_t, size_t cell) { ++cellStarts[cell + 1]; });
+			for (size_t i = 1; i < cellStarts.size(); ++i)
+				cellStarts[i] += cellStarts[i - 1];
+
+			indices.resize(cellStarts.back());
+			std::vector<uint32_t> next(cellStarts.begin(), cellStarts.end() - 1);
+			forEachCell(grid, [&](size_t box, size_t cell) { indices[next[cell]++] = (uint32_t)box; });
+		}
+
+		// Calls action(box index, cell index) for every cell every box overlaps, using the same cell boundaries as
+		// StaticGeometry's queries.
+		template<typename Action>
+		void forEachCell(const LevelGrid& grid, Action action) const {
+			auto cellOf = [&](float offset, uint32_t count) {
+				int64_t cell = (int64_t)std::floor(offset / grid.cellSize);
+				return (size_t)(cell < 0 ? 0 : cell >= count ? count - 1 : cell);
+			};
+			for (size_t i = 0; i < boxes.size(); ++i) {
+				const StaticBox& box = boxes[i];
+				size_t column1 = cellOf(box.x - grid.originX, grid.columns), column2 = cellOf(box.x + box.width - grid.originX, grid.columns);
+				size_t row1 = cellOf(box.y - grid.originY, grid.rows), row2 = cellOf(box.y + box.height - grid.originY, grid.rows);
+				for (size_t row = row1; row <= row2; ++row)
+					for (size_t column = column1; column <= column2; ++column)
+						action(i, row * grid.columns + column);
+			}
+		}
+
+	private: // Fields:
+		float gridCellSize = 64;
+		std::vector<StaticBox> boxes;
+		std::vector<LevelTileLayer> tileLayers;
+		std::vector<uint16_t> tiles;
+		std::vector<LevelSpawnPoint> spawnPoints;
+		std::vector<LevelEntity> entities;
+	};
+
+
+
+	// o-----------o
+	// | LevelFile |
+	// o-----------o
+
+	// A level file mapped into memory. Nothing is parsed or copied: every array, including the static geometry handed to
+	// Engine::setStaticGeometry, points straight into the mapping. So opening takes the same time whatever the level's
+	// size, pages are only read from disk once something touches them, and processes running the same level share them.
+	//
+	// open checks the header and that every section fits in the file. The records themselves are trusted, level files
+	// are assets, not user input.
+	class LevelFile {
+	public: // Constructors:
+		LevelFile() = default;
+		~LevelFile() { close(); }
+
+		LevelFile(const LevelFile&) = delete;
+		LevelFile& operator=(const LevelFile&) = delete;
+
+	public: // Properties:
+		bool isOpen() const { return data != nullptr; }
+		// Why the last open failed.
+		const std::string& getError() const { return error; }
+
+		const StaticGeometry& getStaticGeometry() const { return staticGeometry; }
+
+		const LevelTileLayer* getTileLayers() const { return tileLayers; }
+		size_t getTileLayerCount() const { return tileLayerCount; }
+		const uint16_t* getTiles(const LevelTileLayer& layer) const { return tiles + layer.firstTile; }
+
+		const LevelSpawnPoint* getSpawnPoints() const { return spawnPoints; }
+		size_t getSpawnPointCount() const { return spawnPointCount; }
+
+		const LevelEntity* getEntities() const { return entities; }
+		size_t getEntityCount() const { return entityCount; }
+
+	public: // Methods:
+		// Returns false, and leaves the file closed, if it can't be mapped or isn't a level this version can read.
+		bool open(const std::string& path) {
+			close();
+			if (!map(path)) return false;
+			if (!readSections()) {
+				close();
+				return false;
+			}
+			return true;
+		}
+
+		void close() {
+			if (data != nullptr) unmap();
+			data = nullptr;
+			size = 0;
+			staticGeometry = StaticGeometry();
+			tileLayers = nullptr;
+			tiles = nullptr;
+			spawnPoints = nullptr;
+			entities = nullptr;
+			tileLayerCount = tileCount = spawnPointCount = entityCount = 0;
+		}
+
+		// nullptr if there's no spawn point with that id.
+		const LevelSpawnPoint* findSpawnPoint(uint32_t id) const {
+			for (size_t i = 0; i < spawnPointCount; ++i)
+				if (spawnPoints[i].id == id) return &spawnPoints[i];
+			return nullptr;
+		}
+
+	private:
+		bool fail(const std::string& message) {
+			error = message;
+			return false;
+		}
+
+		bool readSections() {
+			if (size < sizeof(LevelHeader)) return fail("too small to be a level file");
+			const LevelHeader& header = *(const LevelHeader*)data;
+			if (std::memcmp(header.magic, "PPLV", 4) != 0) return fail("not a level file");
+			if (header.byteOrder != levelFileByteOrder) return fail("written on a machine with a different byte order");
+			if (header.version != levelFileVersion) return fail("unsupported version " + std::to_string(header.version));
+			if (header.fileSize > size || (uint64_t)header.sectionCount * sizeof(LevelSection) > size - sizeof(LevelHeader))
+				return fail("truncated");
+
+			const LevelSection* sections = (const LevelSection*)(data + sizeof(LevelHeader));
+			const LevelGrid* grid = nullptr;
+			size_t gridCount = 0, cellCount = 0, indexCount = 0;
+			for (uint32_t i = 0; i < header.sectionCount; ++i) {
+				const LevelSection& section = sections[i];
+				if (section.offset % 16 != 0 || section.offset > size || section.count > (size - section.offset) / (section.recordSize ? section.recordSize : 1))
+					return fail("section " + std::to_string(i) + " doesn't fit in the file");
+
+				switch (section.type) {
+				case LEVEL_STATIC_BOXES:        if (!get(section, staticGeometry.boxes, staticGeometry.boxCount)) return false; break;
+				case LEVEL_STATIC_GRID:         if (!get(section, grid, gridCount)) return false; break;
+				case LEVEL_STATIC_GRID_CELLS:   if (!get(section, staticGeometry.cellStarts, cellCount)) return false; break;
+				case LEVEL_STATIC_GRID_INDICES: if (!get(section, staticGeometry.indices, indexCount)) return false; break;
+				case LEVEL_TILE_LAYERS:         if (!get(section, tileLayers, tileLayerCount)) return false; break;
+				case LEVEL_TILES:               if (!get(section, tiles, tileCount)) return false; break;
+				case LEVEL_SPAWN_POINTS:        if (!get(section, spawnPoints, spawnPointCount)) return false; break;
+				case LEVEL_ENTITIES:            if (!get(section, entities, entityCount)) return false; break;
+				default: break; // from a newer writer, not needed to play the level.
+				}
+			}
+
+			if (staticGeometry.boxCount != 0) {
+				if (gridCount != 1 || grid->cellSize <= 0 || cellCount != (size_t)grid->columns * grid->rows + 1 || cellCount < 2 ||
+					staticGeometry.cellStarts[cellCount - 1] != indexCount)
+					return fail("static geometry grid doesn't match its boxes");
+				// queries index straight into these, so a corrupt file must not get past here.
+				if (staticGeometry.cellStarts[0] != 0) return fail("static geometry grid cells don't start at 0");
+				for (size_t i = 1; i < cellCount; ++i)
+					if (staticGeometry.cellStarts[i] < staticGeometry.cellStarts[i - 1])
+						return fail("static geometry grid cell " + std::to_string(i - 1) + " ends before it starts");
+				for (size_t i = 0; i < indexCount; ++i)
+					if (staticGeometry.indices[i] >= staticGeometry.boxCount)
+						return fail("static geometry grid index " + std::to_string(i) + " is past the last box");
+				staticGeometry.originX = grid->originX;
+				staticGeometry.originY = grid->originY;
+				staticGeometry.cellSize = grid->cellSize;
+				staticGeometry.columns = grid->columns;
+				staticGeometry.rows = grid->rows;
+			}
+			for (size_t i = 0; i < tileLayerCount; ++i)
+				if ((uint64_t)tileLayers[i].firstTile + (uint64_t)tileLayers[i].columns * tileLayers[i].rows > tileCount)
+					return fail("tile layer " + std::to_string(i) + " has more tiles than the file");
+			return true;
+		}
+
+		template<typename T, typename Count>
+		bool get(const LevelSection& section, const T*& out, Count& count) {
+			if (section.recordSize != sizeof(T)) return fail("section type " + std::to_string(section.type) + " has the wrong record size");
+			out = (const T*)(data + section.offset);
+			count = (Count)section.count;
+			return true;
+		}
+
+	#ifdef _WIN32
+		bool map(const std::string& path) {
+			HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) return fail("can't open " + path);
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+				CloseHandle(file);
+				return fail("can't map " + path);
+			}
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			CloseHandle(file);
+			if (mapping == nullptr) return fail("can't map " + path);
+			// the view keeps the mapping alive.
+			data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+			if (data == nullptr) return fail("can't map " + path);
+			size = (size_t)fileSize.QuadPart;
+			return true;
+		}
+
+		void unmap() { UnmapViewOfFile(data); }
+	#else
+		bool map(const std::string& path) {
+			int file = ::open(path.c_str(), O_RDONLY);
+			if (file < 0) return fail("can't open " + path);
+			struct stat status;
+			if (fstat(file, &status) != 0 || status.st_size == 0) {
+				::close(file);
+				return fail("can't map " + path);
+			}
+			void* mapped = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_SHARED, file, 0);
+			// the mapping keeps the file alive.
+			::close(file);
+			if (mapped == MAP_FAILED) return fail("can't map " + path);
+			data = (const char*)mapped;
+			size = (size_t)status.st_size;
+			return true;
+		}
+
+		void unmap() { munmap((void*)data, size); }
+	#endif
+
+	private: // Fields:
+		const char* data = nullptr;
+		size_t size = 0;
+		std::string error;
+
+		StaticGeometry staticGeometry;
+		const LevelTileLayer* tileLayers = nullptr;
+		const uint16_t* tiles = nullptr;
+		const LevelSpawnPoint* spawnPoints = nullptr;
+		const LevelEntity* entities = nullptr;
+		size_t tileLayerCount = 0, tileCount = 0, spawnPointCount = 0, entityCount = 0;
+	};
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "LevelFile.h"
+#include "PlatformPhysics.h"
+#include "Stopwatch.h"
+
+#include<cstdio>
+#include<vector>
+
+// Run with: PixelPlatformer --bench-level [boxes]
+namespace LevelFileBenchmark {
+	using JesseRussell::Diagnostics::Clock;
+
+	inline double millisecondsSince(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	inline int run(size_t boxCount) {
+		const char* path = "bench_level.ppl";
+		const size_t rowLength = 1000;
+
+		// rows of 30x10 blocks with gaps, 1000 to a row.
+		phy::LevelWriter writer;
+		for (size_t i = 0; i < boxCount; ++i)
+			writer.addStaticBox((float)(i % rowLength) * 40, (float)(i / rowLength) * 50, 30, 10);
+		writer.addSpawnPoint(0, 5, -30);
+		std::printf("%zu boxes\n", boxCount);
+
+		Clock::time_point start = Clock::now();
+		writer.mergeStaticBoxes();
+		std::printf("  merge:              %9.3f ms (%zu boxes left)\n", millisecondsSince(start), writer.getStaticBoxCount());
+
+		start = Clock::now();
+		if (!writer.save(path)) {
+			std::printf("couldn't write %s\n", path);
+			return 1;
+		}
+		std::printf("  write:              %9.3f ms\n", millisecondsSince(start));
+
+		// open is the whole load: nothing is parsed, so it doesn't matter how big the level is.
+		const int opens = 20;
+		phy::LevelFile level;
+		start = Clock::now();
+		for (int i = 0; i < opens; ++i) {
+			if (!level.open(path)) {
+				std::printf("couldn't open %s: %s\n", path, level.getError().c_str());
+				return 1;
+			}
+		}
+		std::printf("  open (mmap):        %9.3f ms\n", millisecondsSince(start) / opens);
+
+		// something falling onto the first row, so the collision passes go through the grid.
+		phy::Engine engine;
+		engine.setStaticGeometry(&level.getStaticGeometry());
+		phy::DynamicEntity* body = new phy::DynamicEntity({ 5, -30 }, phy::Box(8, 8), 1);
+		engine.entities_add(body);
+		const int steps = 120;
+		start = Clock::now();
+		for (int step = 0; step < steps; ++step) {
+			body->addForce({ 0, 30 });
+			engine.update(phy::scalar(1) / 60);
+		}
+		std::printf("  engine.update:      %9.3f ms/step (%zu boxes tested in the last step, body at y = %.1f)\n",
+			millisecondsSince(start) / steps, engine.getStats().pairsTested, (double)body->getY1());
+
+		// the old way, one heap allocated Entity per box:
+		{
+			phy::Engine entityEngine;
+			start = Clock::now();
+			std::vector<phy::Entity*> batch;
+			batch.reserve(boxCount);
+			const phy::StaticGeometry& geometry = level.getStaticGeometry();
+			for (size_t i = 0; i < geometry.boxCount; ++i) {
+				const phy::StaticBox& box = geometry.boxes[i];
+				batch.push_back(new phy::Entity({ box.x, box.y }, phy::Box(box.width, box.height)));
+			}
+			entityEngine.entities_addBatch(batch);
+			std::printf("  as Entity objects:  %9.3f ms\n", millisecondsSince(start));
+		}
+
+		level.close();
+		std::remove(path);
+		return 0;
+	}
+}
@@ -1,7 +1,21 @@
 #define OLC_PGE_APPLICATION
 #include "olcPixelGameEngine.h"
 #include "PlatformPhysics.h"
+#include "PhysicsThread.h"
+#include "Viewport.h"
+#include "ChunkedWorld.h"
+#include "LevelFile.h"
+#include "GeometryOptimizer.h"
+#include "LevelFileBenchmark.h"
+#include "JobSystem.h"
+#include "JobSystemBenchmark.h"
+#include "RasterBenchmark.h"
+#include "DirtyRegions.h"
+#include "LayerCache.h"
+#include "TiledRenderer.h"
 #include "Stopwatch.h"
+#define PERF_OVERLAY_COUNT_ALLOCATIONS
+#include "PerfOverlay.h"
 #include "MyMathUtils.h"
 
 using namespace JesseRussell;
@@ -11,10 +25,14 @@ using namespace JesseRussell::Diagnostics;
 #include <thread>
 #include <chrono>
 #include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
 
 class Player : public phy::DynamicEntity {
 public:
-	Player(fvector2 position, fvector2 size, float mass)
+	Player(phy::vector2 position, phy::vector2 size, phy::scalar mass)
 		: phy::DynamicEntity(position, phy::Box(size), mass) {}
 public:
 	void pre_update_horizontal(phy::Engine& engine) override {
@@ -37,12 +55,19 @@ public:
 		auto iter = engine.entities_cbegin();
 		do {
 			if (*iter == this) continue;
-			const phy::DynamicEntity& e = **iter;
+			const phy::Entity& e = **iter;
 			if (phy::vectorRangeIntersection(getPosition(), getPosition2().plusY(5), e.getPosition(), e.getPosition2())) {
 				canJump = true;
 				break;
 			}
 		} while (++iter != engine.entities_cend());
+
+		if (!canJump && engine.getStaticGeometry() != nullptr) {
+			engine.getStaticGeometry()->query((float)getX1(), (float)getY2(), (float)getX2(), (float)getY2() + 5, [&](const phy::StaticBox& box) {
+				if (phy::vectorRangeIntersection(getPosition(), getPosition2().plusY(5), phy::vector2(box.x, box.y), phy::vector2(box.x + box.width, box.y + box.height)))
+					canJump = true;
+			});
+		}
 	}
 	void post_update(phy::Engine& engine) override {}
 
@@ -67,117 +92,497 @@ public:
 	}
 
 public:
+	// What the keyboard and mouse asked for this frame. Applied straight away, or sent to the physics thread.
+	struct Controls {
+		bool moveLeft = false;
+		bool moveRight = false;
+		bool jump = false;
+		bool reset = false;
+		bool addWall = false;
+		phy::vector2 wallA, wallB;
+	};
+
 	bool OnUserCreate() override
 	{
 		// Called once at the start, so create things here
+		if (!levelPath.empty()) return loadLevel();
+
 		player = new Player({ 200, 200 }, { 20, 20 }, 30);
 		player->setBounciness(.2);
 		engine.entities_add(player);
-		engine.entities_add(new phy::DynamicEntity({ 0,390 }, phy::Box(400, 10)));
-		engine.entities_add(new phy::DynamicEntity({ 0,0 }, phy::Box(10, 400)));
-		engine.entities_add(new phy::DynamicEntity({ 390,0 }, phy::Box(10, 400)));
-		engine.entities_add(new phy::DynamicEntity({ 10, 310 }, phy::Box(100, 10)));
+		engine.entities_add(new phy::Entity({ 0,390 }, phy::Box(400, 10)));
+		engine.entities_add(new phy::Entity({ 0,0 }, phy::Box(10, 400)));
+		engine.entities_add(new phy::Entity({ 10, 310 }, phy::Box(100, 10)));
+		geometry.mergeStaticEntities(engine);
+		setUp();
 		return true;
 	}
 
-	fvector2 createA, createB;
-	float moveSpeed = 80;
-	phy::Engine engine;
-	Player* player;
+	// Plays a level file instead of the built in room (and the streamed level right of it).
+	bool loadLevel() {
+		if (!level.open(levelPath)) {
+			std::cerr << levelPath << ": " << level.getError() << std::endl;
+			return false;
+		}
 
-	bool OnUserUpdate(float fElapsedTime) override
-	{
+		const phy::LevelSpawnPoint* start = level.findSpawnPoint(SPAWN_PLAYER);
+		player = new Player(start != nullptr ? phy::vector2(start->x, start->y) : phy::vector2(200, 200), { 20, 20 }, 30);
+		player->setBounciness(.2);
+		engine.entities_add(player);
+		engine.setStaticGeometry(&level.getStaticGeometry());
+
+		for (size_t i = 0; i < level.getEntityCount(); ++i) {
+			const phy::LevelEntity& e = level.getEntities()[i];
+			if (e.kind != ENTITY_CRATE) continue;
+			phy::DynamicEntity* crate = new phy::DynamicEntity({ e.x, e.y }, phy::Box(e.width, e.height), e.mass);
+			crate->setBounciness(e.bounciness);
+			engine.entities_add(crate);
+		}
+		setUp();
+		return true;
+	}
 
+	// Whatever doesn't depend on where the level came from.
+	void setUp() {
+		camera.size = phy::vector2(phy::scalar(ScreenWidth()), phy::scalar(ScreenHeight()));
+		dirty.setScreenSize(ScreenWidth(), ScreenHeight());
+		staticLayer.create(*this);
 
-		//fElapsedTime = 0.01;
+		// Held keys carry over between steps, presses are used up by the next step.
+		physicsThread.setInputHandler([this](phy::Engine&, const Controls& controls) {
+			threadControls.moveLeft = controls.moveLeft;
+			threadControls.moveRight = controls.moveRight;
+			threadControls.jump |= controls.jump;
+			threadControls.reset |= controls.reset;
+			if (controls.addWall) addWall(controls.wallA, controls.wallB);
+		});
+		physicsThread.setStepHandler([this](phy::Engine&) {
+			world.update(player->getPosition());
+			applyControls(threadControls);
+			threadControls.jump = false;
+			threadControls.reset = false;
+		});
+	}
 
-		//std::this_thread::sleep_for(std::chrono::milliseconds(200));
-		Clear(olc::BLACK);
+	// Sets up the player's forces for the next engine update.
+	void applyControls(const Controls& controls) {
 		player->setNetForce({ 0, 0 });
 		// add gravity.
 		player->addForce({ 0, 30 });
-		if (player->getVelocity_x() < 0) {
-			bool trash = true;
-		}
 
 		// add air resistance.
-		player->addForce(player->getVelocity()
-			.timesX(std::abs(player->getVelocity_x()))
-			.timesY(std::abs(player->getVelocity_y())) 
-			* 0.5 * -0.0005
-		);
+		// (vector arithmetic is lazy, so this whole chain is evaluated once, straight into addForce's argument.)
+		phy::vector2 velocity = player->getVelocity();
+		player->addForce(velocity.timesX(velocity.abs()).timesY(velocity.abs()) * 0.5 * -0.0005);
 		
 
 		// add controls:
-		bool moveLeft = GetKey(olc::LEFT).bHeld;
-		bool moveRight = GetKey(olc::RIGHT).bHeld;
-		if (moveLeft) player->subtractForce_x(player->isTouchingSouth() ? moveSpeed : moveSpeed * 0.3f);
-		if (moveRight) player->addForce_x(player->isTouchingSouth() ? moveSpeed : moveSpeed * 0.3f);
-		if (GetKey(olc::SPACE).bPressed) {
+		if (controls.moveLeft) player->subtractForce_x(player->isTouchingSouth() ? moveSpeed : moveSpeed * 0.3f);
+		if (controls.moveRight) player->addForce_x(player->isTouchingSouth() ? moveSpeed : moveSpeed * 0.3f);
+		if (controls.jump) {
 			if (player->CanJump()) {
 				player->CanJump(false);
 				player->addForce({ 0, -9600});
 			}
 		}
 
+		if (controls.reset) {
+			player->setPosition({100,100});
+		}
+	}
+
+	// Merged with the walls it overlaps or touches, so drawing a wall in several strokes still makes one box.
+	void addWall(const phy::vector2& a, const phy::vector2& b) {
+		geometry.addStaticEntity(engine, a, phy::Box(b - a));
+	}
+
+	// Everything right of the starting room: an endless floor with a few platforms over it, made up region by region.
+	void generateRegion(int32_t x, int32_t y, phy::RegionData& out) {
+		if (y != 0 || x < 1 || !levelPath.empty()) return;
+		const float size = regionSize;
+		float left = x * size;
+		out.statics.push_back({ { left, 390 }, { size, 10 } });
+
+		// the same region always gets the same platforms.
+		uint32_t seed = (uint32_t)x * 2654435761u;
+		auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+		int platforms = 2 + next() % 4;
+		for (int i = 0; i < platforms; ++i) {
+			float width = 40.0f + next() % 120;
+			float px = left + next() % (uint32_t)(size - width);
+			float py = 120.0f + next() % 240;
+			out.statics.push_back({ { px, py }, { width, 10 } });
+		}
+	}
+
+	phy::vector2 createA, createB;
+	float moveSpeed = 80;
+	// J lets the engine spread its collision passes over these threads.
+	Threading::JobSystem jobs;
+	phy::Engine engine;
+	phy::GeometryOptimizer geometry;
+	Player* player;
+	PerfOverlay overlay;
+	Stopwatch drawWatch;
+	// Only what's inside the camera's view gets drawn. The camera follows the player once it gets near an edge.
+	phy::Camera camera;
+	phy::RenderGrid renderGrid;
+	size_t drawnCount = 0;
+	// Only the parts of the screen that changed since the last frame are cleared and redrawn. D turns it off.
+	Graphics::DirtyRegionTracker dirty;
+	// Static entities and the level's geometry are drawn into a layer of their own, under everything else, and only
+	// drawn again when the camera moves or entities come or go. C turns it off.
+	Graphics::LayerCache staticLayer;
+	phy::vector2 staticLayerCamera;
+	size_t staticLayerVersion = (size_t)-1;
+	// What paint draws can be recorded and drawn on the job system's threads instead, each taking bands of the
+	// screen. M turns it on.
+	Graphics::TiledRenderer tiled{ jobs };
+	bool tiledRendering = false;
+	// Regions of the level are loaded around the player as it goes, and dropped again once it's far enough away.
+	static constexpr float regionSize = 400;
+	phy::ChunkedWorld world{ engine, regionSize, [this](int32_t x, int32_t y, phy::RegionData& out) { generateRegion(x, y, out); } };
+	// Set by --level. The level's static geometry is used straight from the mapped file.
+	std::string levelPath;
+	phy::LevelFile level;
+	enum LevelIds : uint32_t { SPAWN_PLAYER = 0, ENTITY_CRATE = 1 };
+	// T moves the simulation onto its own thread, at a fixed 1/60 s step, and back again.
+	phy::PhysicsThread<Controls> physicsThread{ engine, phy::scalar(1) / 60 };
+	Controls threadControls; // Only touched by the physics thread.
+
+	bool OnUserUpdate(float fElapsedTime) override
+	{
+		PROFILE_ZONE("OnUserUpdate");
+		// F1 shows the performance overlay.
+		if (GetKey(olc::F1).bPressed) overlay.toggle();
+		overlay.beginFrame(fElapsedTime);
+
+		if (GetKey(olc::J).bPressed && !physicsThread.isRunning()) {
+			engine.setJobSystem(engine.getJobSystem() == nullptr ? &jobs : nullptr);
+		}
+
+		if (GetKey(olc::D).bPressed) dirty.setEnabled(!dirty.isEnabled());
+		if (GetKey(olc::M).bPressed) tiledRendering = !tiledRendering;
+		if (GetKey(olc::C).bPressed) {
+			staticLayer.setEnabled(*this, !staticLayer.isEnabled());
+			dirty.invalidateAll();
+		}
+
+		if (GetKey(olc::T).bPressed) {
+			if (physicsThread.isRunning())
+				physicsThread.stop();
+			else {
+				threadControls = Controls();
+				physicsThread.start();
+			}
+		}
+
+		//fElapsedTime = 0.01;
+
+		//std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+		// read controls:
+		Controls controls;
+		controls.moveLeft = GetKey(olc::LEFT).bHeld;
+		controls.moveRight = GetKey(olc::RIGHT).bHeld;
+		controls.jump = GetKey(olc::SPACE).bPressed;
+		controls.reset = GetKey(olc::R).bPressed;
 
 		if (GetMouse(0).bPressed) {
-			createA = fvector2(GetMouseX(), GetMouseY());
+			createA = camera.toWorld(phy::vector2(phy::scalar(GetMouseX()), phy::scalar(GetMouseY())));
 		}
 
 		if (GetMouse(0).bReleased) {
-			createB = fvector2(GetMouseX(), GetMouseY());
+			createB = camera.toWorld(phy::vector2(phy::scalar(GetMouseX()), phy::scalar(GetMouseY())));
 
-			engine.entities_add(new phy::DynamicEntity(createA, createB - createA));
+			controls.addWall = true;
+			controls.wallA = createA;
+			controls.wallB = createB;
 		}
 
-		if (GetMouse(0).bHeld) {
-			DrawRect(createA.x, createA.y, GetMouseX() - createA.x, GetMouseY() - createA.y, olc::GREEN);
+		if (physicsThread.isRunning()) {
+			physicsThread.pushInput(controls);
 		}
+		else {
+			if (controls.addWall) addWall(controls.wallA, controls.wallB);
+			world.update(player->getPosition());
+			applyControls(controls);
 
-		if (GetKey(olc::R).bPressed) {
-			player->setPosition({100,100});
+			phy::vector2 player_force = player->getNetForce();
+
+			{
+				PROFILE_ZONE("engine.update");
+				engine.update(fElapsedTime);
+			}
+
+
+			//// add friction:
+			//if (!moveLeft && !moveRight) {
+			//	if (player->isTouchingSouth() || player->isTouchingNorth()) {
+			//		float frictionForce = std::abs(player_force.y) * 0.9;
+			//		if (frictionForce > std::abs(player_force.x)) {
+			//			player->addForce_x(frictionForce * cmp::sign(player_force.x));
+			//		}
+			//	}
+
+			//	if (player->isTouchingEast() || player->isTouchingWest()) {
+			//		float frictionForce = std::abs(player_force.x) * 0.9;
+			//		if (frictionForce > std::abs(player_force.y)) {
+			//			player->addForce_y(frictionForce * cmp::sign(player_force.y));
+			//		}
+			//	}
+			//}
+			////
 		}
-		//
-		
-		fvector2 player_force = player->getNetForce();
 
-		engine.update(fElapsedTime);
+		const phy::EngineStats* stats = &engine.getStats();
+		dirty.beginFrame();
+		const phy::Snapshot* snapshot = nullptr;
+		bool cacheStatics = staticLayer.isEnabled();
+		{
+			PROFILE_ZONE("cull colliders");
+			drawnCount = 0;
+			if (physicsThread.isRunning()) {
+				// the engine belongs to the physics thread, draw its latest snapshot instead.
+				// (snapshots are a flat list, so these are culled one by one rather than through the grid.)
+				snapshot = &physicsThread.getSnapshot();
+				// the player was added first and entities are only ever appended, so it's always body 0.
+				camera.follow(snapshot->bodies[0].position, snapshot->bodies[0].size, 60);
+				phy::CollisionBox view = camera.getView();
+				for (size_t i = 0; i < snapshot->bodies.size(); ++i) {
+					const phy::Snapshot::Body& body = snapshot->bodies[i];
+					if (cacheStatics && !body.dynamic) continue;
+					if (phy::CollisionBox(body.position, phy::Box(body.size)).intersects(view)) {
+						// bodies have no address of their own that lasts between snapshots, but their order doesn't change.
+						DrawCollider((const void*)(uintptr_t)(i + 1), body);
+						++drawnCount;
+					}
+				}
+				stats = &snapshot->stats;
+			}
+			else {
+				camera.follow(player->getPosition(), player->getSize(), 60);
+				renderGrid.update(engine);
+				auto draw = [this](const phy::Entity& e) {
+					DrawCollider(&e, e);
+					++drawnCount;
+				};
+				if (cacheStatics) renderGrid.queryDynamic(camera.getView(), draw);
+				else renderGrid.query(camera.getView(), draw);
+			}
+			// the level's geometry never changes, so it can be read while the physics thread runs.
+			if (!cacheStatics) {
+				phy::CollisionBox view = camera.getView();
+				level.getStaticGeometry().queryDistinct((float)view.getX1(), (float)view.getY1(), (float)view.getX2(), (float)view.getY2(), [this](const phy::StaticBox& box) {
+					DrawCollider(&box, phy::CollisionBox({ box.x, box.y }, phy::Box(box.width, box.height)));
+					++drawnCount;
+				});
+			}
+		}
+		if (cacheStatics) {
+			PROFILE_ZONE("static layer");
+			updateStaticLayer(snapshot);
+		}
 
+		Graphics::Rect drag;
+		if (GetMouse(0).bHeld) {
+			phy::vector2 screenA = camera.toScreen(createA);
+			int32_t ax = (int32_t)screenA.x, ay = (int32_t)screenA.y;
+			drag = { std::min(ax, GetMouseX()), std::min(ay, GetMouseY()), std::abs(GetMouseX() - ax) + 1, std::abs(GetMouseY() - ay) + 1 };
+			dirty.invalidate(drag);
+		}
 
-		//// add friction:
-		//if (!moveLeft && !moveRight) {
-		//	if (player->isTouchingSouth() || player->isTouchingNorth()) {
-		//		float frictionForce = std::abs(player_force.y) * 0.9;
-		//		if (frictionForce > std::abs(player_force.x)) {
-		//			player->addForce_x(frictionForce * cmp::sign(player_force.x));
-		//		}
-		//	}
+		if (overlay.isVisible()) {
+			overlay.addTiming(physicsThread.isRunning() ? "physics (thread)" : "physics", stats->total);
+			overlay.addTiming(" collisions", stats->getCollisionsTime());
+			overlay.addTiming(" hooks", stats->getHooksTime());
+			overlay.addTiming("draw", std::chrono::duration<double, std::milli>(drawWatch.getElapsed()).count());
+			overlay.addCount("entities", stats->staticEntities + stats->dynamicEntities);
+			overlay.addCount("active", stats->dynamicEntities);
+			overlay.addCount("drawn", drawnCount);
+			overlay.addCount("regions", world.getActiveRegionCount());
+			overlay.addCount("pairs tested", stats->pairsTested);
+			overlay.addCount("collisions", stats->collisionsResolved);
+			overlay.addCount("redrawn pixels", (size_t)dirty.getDirtyArea());
+			overlay.addCount("static layer redraws", staticLayer.getRedrawCount());
+			dirty.invalidate({ 2, 2, overlay.getWidth(), overlay.getHeight() });
+		}
 
-		//	if (player->isTouchingEast() || player->isTouchingWest()) {
-		//		float frictionForce = std::abs(player_force.x) * 0.9;
-		//		if (frictionForce > std::abs(player_force.y)) {
-		//			player->addForce_y(frictionForce * cmp::sign(player_force.y));
-		//		}
-		//	}
-		//}
-		////
+		{
+			PROFILE_ZONE("draw");
+			if (overlay.isVisible()) drawWatch.restart();
+			paint();
+			if (overlay.isVisible()) drawWatch.stop();
+		}
+		if (!drag.isEmpty()) DrawRect(drag.x, drag.y, drag.width - 1, drag.height - 1, olc::GREEN);
+		overlay.draw(*this);
 
-		auto iter = engine.entities_cbegin();
-		do  {
-			DrawCollider(**iter);
-		} while (++iter != engine.entities_cend());
+		// P starts recording a profile, pressing it again saves it as trace.json (open in chrome://tracing).
+		if (GetKey(olc::P).bPressed) {
+			if (Profiler::isEnabled()) {
+				Profiler::setEnabled(false);
+				Profiler::saveChromeTrace("trace.json");
+			}
+			else {
+				Profiler::clear();
+				Profiler::setEnabled(true);
+			}
+		}
 		return true;
 	}
 public:
-	void DrawCollider(const phy::Collider& c, olc::Pixel color = olc::WHITE) {
-		DrawRect(c.getX1(), c.getY1(), c.getWidth(), c.getHeight(), color);
+	// Colliders aren't drawn straight away, they're handed to the dirty region tracker and drawn by paint.
+	// id has to stay the same from frame to frame. (DrawRect covers one pixel more than the size each way.)
+	void DrawCollider(const void* id, const phy::CollisionBox& c, olc::Pixel color = olc::WHITE) {
+		dirty.add(id, toScreen(c.getPosition(), c.getSize()), color.n);
+	}
+
+	void DrawCollider(const void* id, const phy::Snapshot::Body& b, olc::Pixel color = olc::WHITE) {
+		dirty.add(id, toScreen(b.position, b.size), color.n);
+	}
+
+	Graphics::Rect toScreen(const phy::vector2& position, const phy::vector2& size) const {
+		phy::vector2 screen = camera.toScreen(position);
+		return { (int32_t)screen.x, (int32_t)screen.y, (int32_t)size.x + 1, (int32_t)size.y + 1 };
+	}
+
+	// Draws the static entities and the level's geometry into the static layer, if the camera moved or entities came or
+	// went since it was last drawn. snapshot is what's being drawn while the physics thread runs, null otherwise.
+	void updateStaticLayer(const phy::Snapshot* snapshot) {
+		size_t entitiesVersion = snapshot != nullptr ? snapshot->entitiesVersion : engine.entities_getVersion();
+		if (camera.position.x != staticLayerCamera.x || camera.position.y != staticLayerCamera.y || entitiesVersion != staticLayerVersion) {
+			staticLayer.invalidate();
+			staticLayerCamera = camera.position;
+			staticLayerVersion = entitiesVersion;
+		}
+
+		staticLayer.update(*this, [this, snapshot]() {
+			phy::CollisionBox view = camera.getView();
+			auto draw = [this](const Graphics::Rect& rect) { DrawRect(rect.x, rect.y, rect.width - 1, rect.height - 1, olc::WHITE); };
+			if (snapshot != nullptr) {
+				for (const phy::Snapshot::Body& body : snapshot->bodies)
+					if (!body.dynamic && phy::CollisionBox(body.position, phy::Box(body.size)).intersects(view)) draw(toScreen(body.position, body.size));
+			}
+			else {
+				renderGrid.queryStatic(view, [&](const phy::Entity& e) { draw(toScreen(e.getPosition(), e.getSize())); });
+			}
+			level.getStaticGeometry().queryDistinct((float)view.getX1(), (float)view.getY1(), (float)view.getX2(), (float)view.getY2(), [&](const phy::StaticBox& box) {
+				draw(toScreen(phy::vector2(box.x, box.y), phy::vector2(box.width, box.height)));
+			});
+		});
+	}
+
+	// Clears and redraws what changed, and only uploads the rows it touched. Layer 0 is cleared to see-through, so the
+	// static layer (or, without it, the black the screen is cleared to) shows through.
+	void paint() {
+		dirty.endFrame();
+		if (tiledRendering) {
+			if (dirty.isFullRedraw())
+				tiled.clear(olc::BLANK);
+			else
+				for (const Graphics::Rect& rect : dirty.getDirty()) tiled.fillRect(rect.x, rect.y, rect.width, rect.height, olc::BLANK);
+
+			dirty.forEachToRedraw([this](const Graphics::DirtyRegionTracker::Item& item) {
+				tiled.drawRect(item.bounds.x, item.bounds.y, item.bounds.width - 1, item.bounds.height - 1, olc::Pixel(item.style));
+			});
+			tiled.execute(GetDrawTarget());
+		}
+		else {
+			if (dirty.isFullRedraw())
+				Clear(olc::BLANK);
+			else
+				for (const Graphics::Rect& rect : dirty.getDirty()) FillRect(rect.x, rect.y, rect.width, rect.height, olc::BLANK);
+
+			dirty.forEachToRedraw([this](const Graphics::DirtyRegionTracker::Item& item) {
+				DrawRect(item.bounds.x, item.bounds.y, item.bounds.width - 1, item.bounds.height - 1, olc::Pixel(item.style));
+			});
+		}
+
+		if (!dirty.isFullRedraw()) SetLayerUpdateRows(0, dirty.getDirtyTop(), dirty.getDirtyBottom() - dirty.getDirtyTop());
 	}
 };
 
-int main()
+// --write-level <path> [steps]: the built in room, followed by a long staircase of small blocks and a few crates.
+bool writeLevel(const std::string& path, size_t steps) {
+	phy::LevelWriter writer;
+	writer.addStaticBox(0, 390, 400, 10);
+	writer.addStaticBox(0, 0, 10, 400);
+	writer.addStaticBox(10, 310, 100, 10);
+	writer.addSpawnPoint(Example::SPAWN_PLAYER, 200, 200);
+
+	for (size_t i = 0; i < steps; ++i) {
+		float x = 400 + i * 40.0f;
+		float y = 390 - (i % 8) * 10.0f;
+		writer.addStaticBox(x, y, 40, 400 - y);
+		if (i % 50 == 25) writer.addEntity({ Example::ENTITY_CRATE, x, y - 100, 16, 16, 10, 0.3f, 0 });
+	}
+	writer.mergeStaticBoxes();
+
+	if (!writer.save(path)) {
+		std::cerr << "couldn't write " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+#if defined(OLC_PLATFORM_HEADLESS)
+// --headless [frames] [path]: built with OLC_PLATFORM_HEADLESS there's no window, so the demo plays itself instead, at
+// 60 fps: it walks right and jumps every second. Prints the time it took per frame, and the last frame's checksum to
+// compare against a known good run. With a path that frame is also written out as a binary PPM.
+int playHeadless(Example& demo, uint32_t frames, const char* path) {
+	olc::HeadlessScript script;
+	script.nFrames = frames;
+	script.AddKey(30, olc::RIGHT, true);
+	for (uint32_t frame = 60; frame < frames; frame += 60)
+		script.AddKey(frame, olc::SPACE, true).AddKey(frame + 1, olc::SPACE, false);
+	demo.SetHeadlessScript(script);
+	Stopwatch watch;
+	watch.start();
+	if (demo.Start() != olc::OK) return 1;
+	watch.stop();
+
+	const olc::Sprite* frame = demo.GetFrameBuffer();
+	if (frame == nullptr) return 1;
+	// FNV-1a over the colours, the frame is always opaque.
+	uint64_t hash = 14695981039346656037ull;
+	for (int32_t i = 0; i < frame->width * frame->height; ++i)
+		for (uint8_t channel : { frame->pColData[i].r, frame->pColData[i].g, frame->pColData[i].b })
+			hash = (hash ^ channel) * 1099511628211ull;
+	std::printf("%u frames, %.3f ms each\n", frames, std::chrono::duration<double, std::milli>(watch.getElapsed()).count() / std::max(frames, 1u));
+	std::printf("last frame %016llx\n", (unsigned long long)hash);
+
+	if (path != nullptr) {
+		std::ofstream file(path, std::ios::binary);
+		file << "P6\n" << frame->width << " " << frame->height << "\n255\n";
+		for (int32_t i = 0; i < frame->width * frame->height; ++i)
+			file.put((char)frame->pColData[i].r).put((char)frame->pColData[i].g).put((char)frame->pColData[i].b);
+		if (!file) {
+			std::cerr << "couldn't write " << path << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
+#endif
+
+int main(int argc, char* argv[])
 {
+	if (argc > 1 && std::string(argv[1]) == "--bench-jobs")
+		return JobSystemBenchmark::run(argc > 2 ? (unsigned)std::atoi(argv[2]) : 0);
+	if (argc > 1 && std::string(argv[1]) == "--bench-level")
+		return LevelFileBenchmark::run(argc > 2 ? (size_t)std::atoll(argv[2]) : 1000000);
+	if (argc > 1 && std::string(argv[1]) == "--bench-raster")
+		return RasterBenchmark::run(argc > 2 ? (int32_t)std::atoi(argv[2]) : 400);
+	if (argc > 2 && std::string(argv[1]) == "--write-level")
+		return writeLevel(argv[2], argc > 3 ? (size_t)std::atoll(argv[3]) : 1000) ? 0 : 1;
+
 	Example demo;
+	if (argc > 2 && std::string(argv[1]) == "--level")
+		demo.levelPath = argv[2];
+#if defined(OLC_PLATFORM_HEADLESS)
+	if (argc > 1 && std::string(argv[1]) == "--headless")
+		return demo.Construct(400, 400, 1, 1) ? playHeadless(demo, argc > 2 ? (uint32_t)std::atoi(argv[2]) : 300, argc > 3 ? argv[3] : nullptr) : 1;
+#endif
 	if (demo.Construct(400, 400, 1, 1))
 		demo.Start();
 	return 0;
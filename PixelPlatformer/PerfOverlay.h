@@ -0,0 +1,184 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+
+#include<array>
+#include<atomic>
+#include<cstdio>
+#include<cstdlib>
+#include<new>
+
+namespace JesseRussell {
+	namespace Diagnostics {
+		// o------------------o
+		// | allocation count |
+		// o------------------o
+
+		// Calls to the global operator new so far. Stays 0 unless PERF_OVERLAY_COUNT_ALLOCATIONS is defined before
+		// including this header, in exactly one .cpp (the same way OLC_PGE_APPLICATION works).
+		inline std::atomic<size_t>& allocationCounter() {
+			static std::atomic<size_t> counter{ 0 };
+			return counter;
+		}
+
+		inline bool& isCountingAllocations() {
+			static bool value = false;
+			return value;
+		}
+
+		inline size_t getAllocationCount() { return allocationCounter().load(std::memory_order_relaxed); }
+
+
+
+		// o-------------o
+		// | PerfOverlay |
+		// o-------------o
+
+		// Draws a rolling graph of frame times, plus whatever timings and counts the game reports each frame.
+		//
+		// Usage, each frame: beginFrame(fElapsedTime), then addTiming/addCount, then draw(*this) last.
+		// While hidden every one of those returns straight away. Nothing in here allocates, visible or not: the history and
+		// rows are fixed arrays and text is formatted into a buffer on the stack.
+		class PerfOverlay {
+		public: // constants:
+			static constexpr size_t historyLength = 256;
+			static constexpr size_t maxRows = 16;
+
+		private: // types:
+			struct Row {
+				const char* label; // Not copied, string literals are ideal.
+				double value;
+				bool isTiming;
+			};
+
+		public: // Properties:
+			bool isVisible() const { return visible; }
+			void setVisible(bool value) { visible = value; }
+			void toggle() { visible = !visible; }
+
+		public: // Methods:
+			void beginFrame(float fElapsedTime) {
+				if (!visible) return;
+				history[historyNext] = fElapsedTime * 1000.0f;
+				historyNext = (historyNext + 1) % historyLength;
+				if (historyCount < historyLength) ++historyCount;
+
+				size_t allocations = getAllocationCount();
+				allocationsLastFrame = allocations - allocationsBefore;
+				allocationsBefore = allocations;
+
+				rowCount = 0;
+			}
+
+			void addTiming(const char* label, double milliseconds) {
+				if (!visible || rowCount == maxRows) return;
+				rows[rowCount++] = { label, milliseconds, true };
+			}
+
+			void addCount(const char* label, size_t value) {
+				if (!visible || rowCount == maxRows) return;
+				rows[rowCount++] = { label, (double)value, false };
+			}
+
+			// Size of what draw covers, with the rows added so far.
+			int32_t getWidth() const { return (int32_t)historyLength + 4; }
+			int32_t getHeight() const { return graphHeight + 4 + (2 + (int32_t)rowCount + (isCountingAllocations() ? 1 : 0)) * lineHeight; }
+
+			void draw(olc::PixelGameEngine& pge, int32_t x = 2, int32_t y = 2) {
+				if (!visible) return;
+
+				pge.FillRect(x, y, getWidth(), getHeight(), olc::VERY_DARK_GREY);
+
+				// graph:
+				int32_t graphBottom = y + 2 + graphHeight;
+				float last = 0, average = 0, worst = 0;
+				for (size_t i = 0; i < historyCount; ++i) {
+					// oldest on the left.
+					size_t index = (historyNext + historyLength - historyCount + i) % historyLength;
+					float ms = history[index];
+					int32_t height = (int32_t)(ms / graphMilliseconds * graphHeight);
+					if (height > graphHeight) height = graphHeight;
+					olc::Pixel color = ms <= 1000.0f / 60 ? olc::GREEN : ms <= 1000.0f / 30 ? olc::YELLOW : olc::RED;
+					pge.DrawLine(x + 2 + (int32_t)i, graphBottom, x + 2 + (int32_t)i, graphBottom - height, color);
+
+					average += ms;
+					if (ms > worst) worst = ms;
+					last = ms;
+				}
+				if (historyCount != 0) average /= historyCount;
+
+				// 60 and 30 fps lines:
+				for (float ms : { 1000.0f / 60, 1000.0f / 30 }) {
+					int32_t lineY = graphBottom - (int32_t)(ms / graphMilliseconds * graphHeight);
+					pge.DrawLine(x + 2, lineY, x + 2 + (int32_t)historyLength, lineY, olc::DARK_GREY, 0xF0F0F0F0);
+				}
+
+				// text:
+				int32_t textY = graphBottom + 4;
+				print(pge, x + 2, textY, "frame %6.2f ms %5.0f fps", last, last > 0 ? 1000.0f / last : 0.0f);
+				textY += lineHeight;
+				print(pge, x + 2, textY, "avg %6.2f max %6.2f", average, worst);
+				textY += lineHeight;
+				for (size_t i = 0; i < rowCount; ++i, textY += lineHeight) {
+					if (rows[i].isTiming)
+						print(pge, x + 2, textY, "%-16.16s%7.3f ms", rows[i].label, rows[i].value);
+					else
+						print(pge, x + 2, textY, "%-16.16s%7.0f", rows[i].label, rows[i].value);
+				}
+				if (isCountingAllocations())
+					print(pge, x + 2, textY, "%-16.16s%7u", "allocs/frame", (unsigned)allocationsLastFrame);
+			}
+
+		private:
+			template<typename... Args>
+			void print(olc::PixelGameEngine& pge, int32_t x, int32_t y, const char* format, Args... args) {
+				char buffer[64];
+				if (std::snprintf(buffer, sizeof(buffer), format, args...) < 0) return;
+				pge.DrawString(x, y, buffer, olc::WHITE);
+			}
+
+		private: // Fields:
+			static constexpr int32_t graphHeight = 50;
+			static constexpr int32_t lineHeight = 10;
+			static constexpr float graphMilliseconds = 50.0f; // frame time at the top of the graph.
+
+			bool visible = false;
+
+			std::array<float, historyLength> history{};
+			size_t historyNext = 0;
+			size_t historyCount = 0;
+
+			std::array<Row, maxRows> rows{};
+			size_t rowCount = 0;
+
+			size_t allocationsBefore = 0;
+			size_t allocationsLastFrame = 0;
+		};
+	}
+}
+
+#ifdef PERF_OVERLAY_COUNT_ALLOCATIONS
+// Replacement global new/delete, counting every allocation. The nothrow forms forward to these.
+// Once these are inlined g++ sees std::free on memory from operator new and warns (-Wmismatched-new-delete), even
+// though every form here is malloc/free underneath. That pairing is the whole point of the block, so it's silenced.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(size_t size) {
+	JesseRussell::Diagnostics::allocationCounter().fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+	const bool perfOverlayCountingAllocations = (JesseRussell::Diagnostics::isCountingAllocations() = true);
+}
+#endif
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "PlatformPhysics.h"
+#include "Stopwatch.h"
+
+#include<atomic>
+#include<thread>
+#include<functional>
+#include<vector>
+#include<chrono>
+
+namespace phy {
+	// o--------------o
+	// | TripleBuffer |
+	// o--------------o
+
+	// Hands the newest value from one writer thread to one reader thread without either of them ever waiting.
+	// The writer fills back() and calls publish(). The reader calls front() and gets the newest published value,
+	// which stays untouched until it calls front() again. Values the reader never got to are simply skipped.
+	template<typename T>
+	class TripleBuffer {
+	public: // writer:
+		T& back() { return slots[backIndex]; }
+
+		void publish() {
+			backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX;
+		}
+
+	public: // reader:
+		const T& front() {
+			if (middle.load(std::memory_order_relaxed) & FRESH)
+				frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX;
+			return slots[frontIndex];
+		}
+
+	private:
+		static constexpr unsigned INDEX = 0b011;
+		static constexpr unsigned FRESH = 0b100;
+
+		T slots[3];
+		unsigned backIndex = 0;
+		std::atomic<unsigned> middle{ 1 };
+		unsigned frontIndex = 2;
+	};
+
+
+
+	// o-----------o
+	// | SpscQueue |
+	// o-----------o
+
+	// Fixed-size lock-free queue for exactly one producer thread and one consumer thread.
+	template<typename T, size_t Capacity>
+	class SpscQueue {
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+	public:
+		// Returns false, dropping the value, if the queue is full.
+		bool push(const T& value) {
+			size_t t = tail.load(std::memory_order_relaxed);
+			if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+			items[t & (Capacity - 1)] = value;
+			tail.store(t + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool pop(T& out) {
+			size_t h = head.load(std::memory_order_relaxed);
+			if (h == tail.load(std::memory_order_acquire)) return false;
+			out = items[h & (Capacity - 1)];
+			head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+		T items[Capacity];
+		// On separate cache lines, so the two threads don't invalidate each other's line on every push and pop.
+		alignas(64) std::atomic<size_t> head{ 0 };
+		alignas(64) std::atomic<size_t> tail{ 0 };
+	};
+
+
+
+	// o----------o
+	// | Snapshot |
+	// o----------o
+
+	// Everything the renderer needs from one simulation step. Bodies are in the same order as the engine's entities.
+	struct Snapshot {
+		struct Body {
+			vector2 position;
+			vector2 size;
+			bool dynamic;
+		};
+
+		std::vector<Body> bodies;
+		EngineStats stats;
+		size_t entitiesVersion = 0; // The engine's entities_getVersion(), so the renderer can tell when entities came or went.
+		size_t step = 0; // Steps taken by the PhysicsThread, so the renderer can tell whether it's seen this one.
+
+		// Reuses the bodies vector's storage, so once it has grown to fit, taking a snapshot doesn't allocate.
+		void capture(const Engine& engine) {
+			bodies.clear();
+			for (auto iter = engine.entities_cbegin(); iter != engine.entities_cend(); ++iter) {
+				Entity* e = *iter;
+				bodies.push_back({ e->getPosition(), e->getSize(), e->isDynamic() });
+			}
+			stats = engine.getStats();
+			entitiesVersion = engine.entities_getVersion();
+		}
+	};
+
+
+
+	// o---------------o
+	// | PhysicsThread |
+	// o---------------o
+
+	// Steps an Engine on its own thread at a fixed time step, so simulating the next frame overlaps with drawing this one.
+	//
+	// While running, the thread owns the engine: nothing else may touch it or its entities. Input goes in through
+	// pushInput (any Input type, copied through a lock-free queue) and is handed to the input handler on the simulation
+	// thread. The step handler runs before every engine.update. After every step the renderer can pick up an immutable
+	// Snapshot of positions and sizes through getSnapshot.
+	template<typename Input, size_t InputCapacity = 256>
+	class PhysicsThread {
+	public: // types:
+		using InputHandler = std::function<void(Engine&, const Input&)>;
+		using StepHandler = std::function<void(Engine&)>;
+
+	public: // Constructors:
+		PhysicsThread(Engine& engine, scalar timeStep)
+			: engine(engine), timeStep(timeStep),
+			stepDuration(std::chrono::duration_cast<JesseRussell::Diagnostics::Clock::duration>(std::chrono::duration<double>((double)timeStep))) {}
+
+		~PhysicsThread() { stop(); }
+
+		PhysicsThread(const PhysicsThread&) = delete;
+		PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+	public: // Properties:
+		// Handlers can only be changed while stopped.
+		void setInputHandler(InputHandler handler) { if (!isRunning()) onInput = handler; }
+		void setStepHandler(StepHandler handler) { if (!isRunning()) onStep = handler; }
+
+		bool isRunning() const { return thread.joinable(); }
+		scalar getTimeStep() const { return timeStep; }
+
+	public: // Methods:
+		void start() {
+			if (isRunning()) return;
+			// The first snapshot is taken here so there's something to draw before the first step finishes.
+			snapshots.back().capture(engine);
+			snapshots.back().step = step;
+			snapshots.publish();
+			running.store(true, std::memory_order_release);
+			thread = std::thread(&PhysicsThread::run, this);
+		}
+
+		// Returns once the thread has finished its current step. The engine belongs to the caller again afterwards.
+		void stop() {
+			if (!isRunning()) return;
+			running.store(false, std::memory_order_release);
+			thread.join();
+
+			// Whatever input the thread didn't get to is stale by the time it's started again.
+			Input input;
+			while (inputs.pop(input)) {}
+		}
+
+		// Returns false if the queue is full and the input was dropped.
+		bool pushInput(const Input& input) { return inputs.push(input); }
+
+		// Newest published snapshot. Only one thread may call this (normally the render thread).
+		const Snapshot& getSnapshot() { return snapshots.front(); }
+
+	private:
+		void run() {
+			using namespace JesseRussell::Diagnostics;
+			Profiler::setThreadName("physics");
+
+			Clock::time_point next = Clock::now();
+			while (running.load(std::memory_order_acquire)) {
+				{
+					PROFILE_ZONE("physics step");
+					Input input;
+					while (inputs.pop(input))
+						if (onInput) onInput(engine, input);
+
+					if (onStep) onStep(engine);
+					engine.update(timeStep);
+
+					Snapshot& snapshot = snapshots.back();
+					snapshot.capture(engine);
+					snapshot.step = ++step;
+					snapshots.publish();
+				}
+
+				next += stepDuration;
+				Clock::time_point now = Clock::now();
+				// If we've fallen more than a few steps behind, slow the simulation down rather than spiralling.
+				if (now - next > stepDuration * 4) next = now;
+				std::this_thread::sleep_until(next);
+			}
+		}
+
+	private: // Fields:
+		Engine& engine;
+		scalar timeStep;
+		JesseRussell::Diagnostics::Clock::duration stepDuration;
+
+		InputHandler onInput;
+		StepHandler onStep;
+
+		SpscQueue<Input, InputCapacity> inputs;
+		TripleBuffer<Snapshot> snapshots;
+
+		size_t step = 0;
+		std::atomic<bool> running{ false };
+		std::thread thread;
+	};
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "MyMathUtils.h"
+#include "Fixed.h"
+#include "JobSystem.h"
 
 #include<iostream>
 #include<cmath>
@@ -8,6 +10,10 @@
 #include<vector>
 #include<map>
 #include<typeinfo>
+#include<chrono>
+#include<algorithm>
+#include<cstdint>
+#include<functional>
 
 namespace phy {
 	// o--------o
@@ -19,6 +25,21 @@ namespace phy {
 	using namespace JesseRussell::vectors;
 	using namespace JesseRussell;
 
+	// o--------o
+	// | scalar |
+	// o--------o
+
+	// Number type used for every position, size, velocity, force and mass in the engine.
+	// Define PHY_FIXED_POINT to simulate in fixed point instead of float. Fixed-point results are bit-identical
+	// across machines, compilers and build flags, which replays and lockstep networking depend on.
+	// 48.16 rather than 16.16: velocity squared (air resistance) and jump forces overflow 16 integer bits.
+#ifdef PHY_FIXED_POINT
+	using scalar = fixed48_16;
+#else
+	using scalar = float;
+#endif
+	using vector2 = vec2<scalar>;
+
 	// o-------------------o
 	// | CardinalDirection |
 	// o-------------------o
@@ -39,44 +60,44 @@ namespace phy {
 	// o--------------------o
 
 
-	float slopeY(const fvector2& a, const fvector2& b, const float& x) {
-		fvector2 s = b - a;
+	scalar slopeY(const vector2& a, const vector2& b, const scalar& x) {
+		vector2 s = b - a;
 		return (x - a.x) / s.x * s.y + a.y;
 	}
 
-	float slopeX(const fvector2& a, const fvector2& b, const float& y) {
-		fvector2 s = b - a;
+	scalar slopeX(const vector2& a, const vector2& b, const scalar& y) {
+		vector2 s = b - a;
 		return (y - a.y) / s.y * s.x + a.x;
 	}
 
-	float slopeY(const float& slope, const float& x) {
+	scalar slopeY(const scalar& slope, const scalar& x) {
 		return x * slope;
 	}
 
-	float slopeX(const float& slope, const float& y) {
+	scalar slopeX(const scalar& slope, const scalar& y) {
 		return y * (1 / slope);
 	}
 
 	bool isVertical(const CardinalDirection& dir) { return dir & 0b1010; }
 	bool isHorizontal(const CardinalDirection& dir) { return dir & 0b0101; }
 
-	bool pointsNorth(const fvector2& vector) {
+	bool pointsNorth(const vector2& vector) {
 		return vector.y < 0;
 	}
 
-	bool pointsSouth(const fvector2& vector) {
+	bool pointsSouth(const vector2& vector) {
 		return vector.y > 0;
 	}	
 
-	bool pointsEast(const fvector2& vector) {
+	bool pointsEast(const vector2& vector) {
 		return vector.x > 0;
 	}
 
-	bool pointsWest(const fvector2& vector) {
+	bool pointsWest(const vector2& vector) {
 		return vector.x < 0;
 	}
 
-	unsigned char points(const fvector2& vector) {
+	unsigned char points(const vector2& vector) {
 		unsigned char result = 0b0000;
 		if (pointsNorth(vector)) result |= NORTH;
 		else if (pointsSouth(vector)) result |= SOUTH;
@@ -93,43 +114,43 @@ namespace phy {
 	struct Box {
 		// Constructors:
 		Box() { size = { 0,0 }; }
-		Box(const fvector2& size) { this->size = size; }
-		Box(const float& width, const float& height) { size.x = width; size.y = height; }
+		Box(const vector2& size) { this->size = size; }
+		Box(const scalar& width, const scalar& height) { size.x = width; size.y = height; }
 
 		// Fields:
-		fvector2 size;
+		vector2 size;
 
 		// Properties:
 			//width:
-		float getWidth() const { return size.x; }
-		void  setWidth(const float& value) { size.x = value; }
+		scalar getWidth() const { return size.x; }
+		void  setWidth(const scalar& value) { size.x = value; }
 
 			//height:
-		float getHeight() const { return size.y; }
-		void  setHeight(const float& value) { size.y = value; }
+		scalar getHeight() const { return size.y; }
+		void  setHeight(const scalar& value) { size.y = value; }
 
 			//center:
-		fvector2 getCenter() const { return size / 2; }
-		float getCenter_x() const { return size.x / 2; }
-		float getCenter_y() const { return size.y / 2; }
+		vector2 getCenter() const { return size / 2; }
+		scalar getCenter_x() const { return size.x / 2; }
+		scalar getCenter_y() const { return size.y / 2; }
 		
 			//corners:
-		fvector2 getNW() const { return { 0, 0 }; }
-		fvector2 getNE() const { return { size.x , 0 }; }
-		fvector2 getSE() const { return { size.x, size.y }; }
-		fvector2 getSW() const { return { 0, size.y }; }
+		vector2 getNW() const { return { 0, 0 }; }
+		vector2 getNE() const { return { size.x , 0 }; }
+		vector2 getSE() const { return { size.x, size.y }; }
+		vector2 getSW() const { return { 0, size.y }; }
 
-		float getNW_x() const { return 0; }
-		float getNW_y() const { return 0; }
+		scalar getNW_x() const { return 0; }
+		scalar getNW_y() const { return 0; }
 
-		float getNE_x() const { return size.x; }
-		float getNE_y() const { return 0; }
+		scalar getNE_x() const { return size.x; }
+		scalar getNE_y() const { return 0; }
 
-		float getSE_x() const { return size.x; }
-		float getSE_y() const { return size.y; }
+		scalar getSE_x() const { return size.x; }
+		scalar getSE_y() const { return size.y; }
 
-		float getSW_x() const { return 0; }
-		float getSW_y() const { return size.y; }
+		scalar getSW_x() const { return 0; }
+		scalar getSW_y() const { return size.y; }
 	};
 
 
@@ -138,11 +159,11 @@ namespace phy {
 	// | Collider |
 	// o----------o
 	class CollisionBox {
-		friend class DynamicEntity;
+		friend class Entity;
 		friend class DynamicEntity;
 		friend class Engine;
 	public: // constructors:
-		CollisionBox(const fvector2& position, const Box& collisionBox) {
+		CollisionBox(const vector2& position, const Box& collisionBox) {
 			this->position = position;
 			this->collisionBox = collisionBox;
 
@@ -158,7 +179,7 @@ namespace phy {
 		}
 
 	private: // fields:
-		fvector2 position;
+		vector2 position;
 		Box collisionBox;
 
 	public: // Properties
@@ -167,71 +188,71 @@ namespace phy {
 		void setCollisionBox(const Box& value) { collisionBox = value; }
 
 		//corners:
-		fvector2 getNW() const { return position; }
-		fvector2 getNE() const { return position.plusX(collisionBox.size); }
-		fvector2 getSE() const { return position + collisionBox.size; }
-		fvector2 getSW() const { return position.plusY(collisionBox.size); }
+		vector2 getNW() const { return position; }
+		vector2 getNE() const { return position.plusX(collisionBox.size); }
+		vector2 getSE() const { return position + collisionBox.size; }
+		vector2 getSW() const { return position.plusY(collisionBox.size); }
 
-		float getNW_x() const { return position.x; }
-		float getNW_y() const { return position.y; }
+		scalar getNW_x() const { return position.x; }
+		scalar getNW_y() const { return position.y; }
 
-		float getNE_x() const { return position.x + collisionBox.size.x; }
-		float getNE_y() const { return position.y; }
+		scalar getNE_x() const { return position.x + collisionBox.size.x; }
+		scalar getNE_y() const { return position.y; }
 
-		float getSE_x() const { return position.x + collisionBox.size.x; }
-		float getSE_y() const { return position.y + collisionBox.size.y; }
+		scalar getSE_x() const { return position.x + collisionBox.size.x; }
+		scalar getSE_y() const { return position.y + collisionBox.size.y; }
 
-		float getSW_x() const { return position.x; }
-		float getSW_y() const { return position.y + collisionBox.size.y; }
+		scalar getSW_x() const { return position.x; }
+		scalar getSW_y() const { return position.y + collisionBox.size.y; }
 
 		//size:
-		fvector2 getSize() const { return collisionBox.size; }
-		void     setSize(const fvector2& value) { collisionBox.size = value; }
+		vector2 getSize() const { return collisionBox.size; }
+		void     setSize(const vector2& value) { collisionBox.size = value; }
 
-		float getSize_x() const { return collisionBox.size.x; }
-		void  setSize_x(const float& value) { collisionBox.size.x = value; }
-		float getSize_y() const { return collisionBox.size.y; }
+		scalar getSize_x() const { return collisionBox.size.x; }
+		void  setSize_x(const scalar& value) { collisionBox.size.x = value; }
+		scalar getSize_y() const { return collisionBox.size.y; }
 
-		void  setSize_y(const float& value) { collisionBox.size.y = value; }
+		void  setSize_y(const scalar& value) { collisionBox.size.y = value; }
 
 		//center:
-		fvector2 getCenter() const { return position + collisionBox.size / 2; }
-		float getCenter_x() const { return position.x + collisionBox.size.x / 2; }
-		float getCenter_y() const { return position.y + collisionBox.size.y / 2; }
+		vector2 getCenter() const { return position + collisionBox.size / 2; }
+		scalar getCenter_x() const { return position.x + collisionBox.size.x / 2; }
+		scalar getCenter_y() const { return position.y + collisionBox.size.y / 2; }
 		
 			//width:
-		float getWidth() const { return collisionBox.size.x; }
-		void  setWidth(const float& value) { collisionBox.size.x = value; }
+		scalar getWidth() const { return collisionBox.size.x; }
+		void  setWidth(const scalar& value) { collisionBox.size.x = value; }
 
 		//height:
-		float getHeight() const { return collisionBox.size.y; }
-		void  setHeight(const float& value) { collisionBox.size.y = value; }
+		scalar getHeight() const { return collisionBox.size.y; }
+		void  setHeight(const scalar& value) { collisionBox.size.y = value; }
 
 		//position1:
-		fvector2 getPosition() const { return position; }
-		void     setPosition(const fvector2& value) { position = value; }
+		vector2 getPosition() const { return position; }
+		void     setPosition(const vector2& value) { position = value; }
 
-		float getPosition_x() const { return position.x; }
-		void  setPosition_x(const float& value) { position.x = value; }
+		scalar getPosition_x() const { return position.x; }
+		void  setPosition_x(const scalar& value) { position.x = value; }
 
-		float getPosition_y() const { return position.y; }
-		void  setPosition_y(const float& value) { position.y = value; }
+		scalar getPosition_y() const { return position.y; }
+		void  setPosition_y(const scalar& value) { position.y = value; }
 
 		//position2:
-		fvector2 getPosition2() const { return position + collisionBox.size; }
-		void     setPosition2(const fvector2& value) { collisionBox.size = value - position; }
+		vector2 getPosition2() const { return position + collisionBox.size; }
+		void     setPosition2(const vector2& value) { collisionBox.size = value - position; }
 
-		float getPosition2_x() const { return position.x + collisionBox.size.x; }
-		void  setPosition2_x(const float& value) { collisionBox.size.x = value - position.x; }
+		scalar getPosition2_x() const { return position.x + collisionBox.size.x; }
+		void  setPosition2_x(const scalar& value) { collisionBox.size.x = value - position.x; }
 
-		float getPosition2_y() const { return position.y + collisionBox.size.y; }
-		void  setPosition2_y(const float& value) { collisionBox.size.y = value - position.y; }
+		scalar getPosition2_y() const { return position.y + collisionBox.size.y; }
+		void  setPosition2_y(const scalar& value) { collisionBox.size.y = value - position.y; }
 
 		//x and y:
-		float getX1() const { return position.x; }
-		float getX2() const { return position.x + collisionBox.size.x; }
-		float getY1() const { return position.y; }
-		float getY2() const { return position.y + collisionBox.size.y; }
+		scalar getX1() const { return position.x; }
+		scalar getX2() const { return position.x + collisionBox.size.x; }
+		scalar getY1() const { return position.y; }
+		scalar getY2() const { return position.y + collisionBox.size.y; }
 
 		// methods:
 		bool intersects(const CollisionBox& other) const {
@@ -259,24 +280,25 @@ namespace phy {
 	// o--------o
 	// | Entity |
 	// o--------o
-	class DynamicEntity : public CollisionBox{
+	class Entity : public CollisionBox{
 		friend class DynamicEntity;
 		friend class Engine;
 
 	public: // Constructors:
-		DynamicEntity(const fvector2& position, const Box& collisionBox)
+		Entity(const vector2& position, const Box& collisionBox)
 			: CollisionBox(position, collisionBox) {}
+		virtual ~Entity() = default;
 
 	public: // Properties:
 		// velocity:
-		fvector2 getVelocity() const { return velocity; }
-		void     setVelocity(const fvector2& value) { velocity = value; }
+		vector2 getVelocity() const { return velocity; }
+		void     setVelocity(const vector2& value) { velocity = value; }
 
-		float getVelocity_x() const { return velocity.x; }
-		void  setVelocity_x(const float value) { velocity.x = value; }
+		scalar getVelocity_x() const { return velocity.x; }
+		void  setVelocity_x(const scalar value) { velocity.x = value; }
 
-		float getVelocity_y() const { return velocity.y; }
-		void  setVelocity_y(const float value) { velocity.y = value; }
+		scalar getVelocity_y() const { return velocity.y; }
+		void  setVelocity_y(const scalar value) { velocity.y = value; }
 
 		virtual bool isDynamic() { return false; }
 
@@ -287,35 +309,35 @@ namespace phy {
 		//front: direction of movement. east and south are assumed in the case of no movement.
 		//back: the opposite of front.
 			// front:
-		fvector2 getFrontNorth() const {
+		vector2 getFrontNorth() const {
 			if (velocity.x < 0)
 				return getNW();
 			else
 				return getNE();
 		}
 
-		fvector2 getFrontSouth() const {
+		vector2 getFrontSouth() const {
 			if (velocity.x < 0)
 				return getSW();
 			else
 				return getSE();
 		}
 
-		fvector2 getFrontEast() const {
+		vector2 getFrontEast() const {
 			if (velocity.y < 0)
 				return getNE();
 			else
 				return getSE();
 		}
 
-		fvector2 getFrontWest() const {
+		vector2 getFrontWest() const {
 			if (velocity.y < 0)
 				return getNW();
 			else
 				return getSW();
 		}
 
-		fvector2 getFrontCorner() const {
+		vector2 getFrontCorner() const {
 			if (velocity.y < 0) {
 				if (velocity.x < 0)
 					return getNW();
@@ -331,35 +353,35 @@ namespace phy {
 		}
 
 			// back:
-		fvector2 getBackNorth() {
+		vector2 getBackNorth() {
 			if (velocity.x < 0)
 				return getNE();
 			else
 				return getNW();
 		}
 
-		fvector2 getBackSouth() {
+		vector2 getBackSouth() {
 			if (velocity.x < 0)
 				return getSE();
 			else
 				return getSW();
 		}
 
-		fvector2 getBackEast() {
+		vector2 getBackEast() {
 			if (velocity.y < 0)
 				return getSE();
 			else
 				return getNE();
 		}
 
-		fvector2 getBackWest() {
+		vector2 getBackWest() {
 			if (velocity.y < 0)
 				return getSW();
 			else
 				return getNW();
 		}
 
-		fvector2 getBackCorner() {
+		vector2 getBackCorner() {
 			if (velocity.y < 0) {
 				if (velocity.x < 0)
 					return getSE();
@@ -382,19 +404,19 @@ namespace phy {
 		
 		virtual void post_update(Engine& engine);
 
-		void updatePosition(float timeScale) {
+		void updatePosition(scalar timeScale) {
 			position += velocity * timeScale;
 		}
-		void updatePosition_horizontal(float timeScale) {
+		void updatePosition_horizontal(scalar timeScale) {
 			position.x += velocity.x * timeScale;
 		}
 
-		void updatePosition_vertical(float timeScale) {
+		void updatePosition_vertical(scalar timeScale) {
 			position.y += velocity.y * timeScale;
 		}
 
 	private: // Fields:
-		fvector2 velocity = { 0, 0 };
+		vector2 velocity = { 0, 0 };
 	};
 
 
@@ -402,17 +424,17 @@ namespace phy {
 	// o---------------o
 	// | DynamicEntity |
 	// o---------------o
-	class DynamicEntity : public DynamicEntity {
+	class DynamicEntity : public Entity {
 		friend class Engine;
 	public: // Constructors:
-		DynamicEntity(const fvector2& position, const Box& collisionBox, const float& mass) : DynamicEntity(position, collisionBox) {
+		DynamicEntity(const vector2& position, const Box& collisionBox, const scalar& mass) : Entity(position, collisionBox) {
 			this->mass = mass;
 		}
 
 	public: // Properties:
 		// bounciness:
-		float getBounciness() const { return bounciness; }
-		void  setBounciness(const float& value) { bounciness = value; }
+		scalar getBounciness() const { return bounciness; }
+		void  setBounciness(const scalar& value) { bounciness = value; }
 
 		virtual bool isDynamic() { return true; }
 
@@ -450,30 +472,30 @@ namespace phy {
 				touching &= ~(0b0001);
 		}
 		// netForce:
-		fvector2 getNetForce() const { return netForce; }
-		void     setNetForce(const fvector2 value) { netForce = value; }
+		vector2 getNetForce() const { return netForce; }
+		void     setNetForce(const vector2 value) { netForce = value; }
 
-		float getNetForce_x() const { return netForce.x; }
-		void  setNetForce_x(const float& value) { netForce.x = value; }
+		scalar getNetForce_x() const { return netForce.x; }
+		void  setNetForce_x(const scalar& value) { netForce.x = value; }
 
-		float getNetForce_y() const { return netForce.y; }
-		void  setNetForce_y(const float& value) { netForce.y = value; }
+		scalar getNetForce_y() const { return netForce.y; }
+		void  setNetForce_y(const scalar& value) { netForce.y = value; }
 
 		// mass:
-		float getMass() const { return mass; }
-		void  setMass(const float& value) { mass = value; }
+		scalar getMass() const { return mass; }
+		void  setMass(const scalar& value) { mass = value; }
 
 	public: // Methods:
 		// netForce:
-		void addForce(const fvector2& force) { netForce += force; }
-		void subtractForce(const fvector2& force) { netForce -= force; }
-		void netForce_scale(const float& scaler) { netForce *= scaler; }
-		void netForce_transform(const fvector2& i, const fvector2& j) { netForce.transform(i, j); }
+		void addForce(const vector2& force) { netForce += force; }
+		void subtractForce(const vector2& force) { netForce -= force; }
+		void netForce_scale(const scalar& scaler) { netForce *= scaler; }
+		void netForce_transform(const vector2& i, const vector2& j) { netForce.transform(i, j); }
 
-		void addForce_x(const float& force_x) { netForce.x += force_x; }
-		void addForce_y(const float& force_y) { netForce.y += force_y; }
-		void subtractForce_x(const float& force_x) { netForce.x -= force_x; }
-		void subtractForce_y(const float& force_y) { netForce.y -= force_y; }
+		void addForce_x(const scalar& force_x) { netForce.x += force_x; }
+		void addForce_y(const scalar& force_y) { netForce.y += force_y; }
+		void subtractForce_x(const scalar& force_x) { netForce.x -= force_x; }
+		void subtractForce_y(const scalar& force_y) { netForce.y -= force_y; }
 
 		// update:
 		virtual void pre_update(Engine& engine) override;
@@ -483,22 +505,22 @@ namespace phy {
 		virtual void post_update_horizontal(Engine& engine);
 		virtual void post_update_vertical(Engine& engine);
 
-		void updateVelocity(const float& timeScale) {
+		void updateVelocity(const scalar& timeScale) {
 			velocity += netForce / mass;
 		}
 
 		void resetForce() { netForce = { 0, 0 }; }
 
-		void updateVelocity_horizontal(const float& timeScale) {
+		void updateVelocity_horizontal(const scalar& timeScale) {
 			velocity.x += netForce.x / mass;
 		}
 
-		void updateVelocity_vertical(const float& timeScale) {
+		void updateVelocity_vertical(const scalar& timeScale) {
 			velocity.y += netForce.y / mass;
 		}
 
 		// collision:
-		bool collidesHorizontal_stationary(const CollisionBox& other, const float& timeScale, float& collisionSpot_out) {
+		bool collidesHorizontal_stationary(const CollisionBox& other, const scalar& timeScale, scalar& collisionSpot_out) {
 			if (vectorRangeIntersection(
 				getBackNorth(),
 				getFrontSouth().plusX(velocity * timeScale),
@@ -518,7 +540,7 @@ namespace phy {
 			else return false;
 		}
 
-		bool collidesVertical_stationary(const CollisionBox& other, const float& timeScale, float& collisionSpot_out) {
+		bool collidesVertical_stationary(const CollisionBox& other, const scalar& timeScale, scalar& collisionSpot_out) {
 			if (vectorRangeIntersection(
 				getBackWest(),
 				getFrontEast().plusY(velocity * timeScale),
@@ -539,22 +561,183 @@ namespace phy {
 		}
 
 	protected: // Fields:
-		fvector2 netForce = { 0, 0 };
-		float mass;
-		float bounciness = 0.5;
+		vector2 netForce = { 0, 0 };
+		scalar mass;
+		scalar bounciness = 0.5;
 
 		char touching = 0b0000;
 	};
 
 
 
+	// o-------------o
+	// | EngineStats |
+	// o-------------o
+
+	// What the last Engine::update cost, phase by phase. Times are in milliseconds.
+	// Define PHY_NO_STATS to compile the recording out. The struct stays so callers still build, but it stays zeroed,
+	// and update() has no clock reads or counter increments left in it.
+	struct EngineStats {
+	#ifdef PHY_NO_STATS
+		static constexpr bool enabled = false;
+	#else
+		static constexpr bool enabled = true;
+	#endif
+
+		// phase times:
+		double pre_update = 0;
+		double pre_update_horizontal = 0;
+		double horizontalCollisions = 0;
+		double post_update_horizontal = 0;
+		double pre_update_vertical = 0;
+		double verticalCollisions = 0;
+		double post_update_vertical = 0;
+		double post_update = 0;
+		double total = 0;
+
+		// counters:
+		size_t pairsTested = 0;
+		size_t collisionsResolved = 0;
+		size_t hooksInvoked = 0;
+
+		// entities by type:
+		size_t staticEntities = 0;
+		size_t dynamicEntities = 0;
+
+		// Time spent in entity hooks (pre/post update, both axes), as opposed to the engine's own collision loops.
+		double getHooksTime() const {
+			return pre_update + pre_update_horizontal + post_update_horizontal + pre_update_vertical + post_update_vertical + post_update;
+		}
+
+		double getCollisionsTime() const { return horizontalCollisions + verticalCollisions; }
+
+	public: // recording (no-ops with PHY_NO_STATS):
+	#ifdef PHY_NO_STATS
+		class Timer {
+		public:
+			explicit Timer(double&) {}
+		};
+
+		static void count(size_t&, size_t) {}
+	#else
+		// Writes the time between its construction and destruction into out.
+		class Timer {
+		public:
+			explicit Timer(double& out) : out(out), start(std::chrono::steady_clock::now()) {}
+			~Timer() { out = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); }
+
+			Timer(const Timer&) = delete;
+			Timer& operator=(const Timer&) = delete;
+
+		private:
+			double& out;
+			std::chrono::steady_clock::time_point start;
+		};
+
+		static void count(size_t& counter, size_t amount) { counter += amount; }
+	#endif
+	};
+	constexpr bool EngineStats::enabled;
+
+
+
+	// o----------------o
+	// | StaticGeometry |
+	// o----------------o
+
+	// Static boxes dynamic entities collide with, without an Entity (or a heap allocation) for each one.
+	// Only a view: it points at arrays owned by someone else, normally a memory-mapped LevelFile, which must outlive it.
+	//
+	// Boxes are found through a uniform grid: cell (column, row) lists the boxes it overlaps at
+	// indices[cellStarts[row * columns + column]] up to indices[cellStarts[row * columns + column + 1]]. A box appears in
+	// every cell it overlaps, so a query may report it more than once.
+	struct StaticBox {
+		float x, y, width, height;
+	};
+
+	struct StaticGeometry {
+		const StaticBox* boxes = nullptr;
+		size_t boxCount = 0;
+
+		float originX = 0, originY = 0;
+		float cellSize = 1;
+		uint32_t columns = 0, rows = 0;
+		const uint32_t* cellStarts = nullptr; // columns * rows + 1 of them.
+		const uint32_t* indices = nullptr;
+
+		bool isEmpty() const { return boxCount == 0 || columns == 0 || rows == 0; }
+
+		// Calls action(box) for the boxes in every cell that overlaps x1..x2, y1..y2. Fast, but boxes spanning several of
+		// those cells are reported once per cell, and boxes that only share a cell with the area are reported too.
+		template<typename Action>
+		void query(float x1, float y1, float x2, float y2, Action action) const {
+			forEachCell(x1, y1, x2, y2, [&](int64_t, int64_t, size_t cell) {
+				for (uint32_t i = cellStarts[cell]; i < cellStarts[cell + 1]; ++i)
+					action(boxes[indices[i]]);
+			});
+		}
+
+		// Calls action(box) exactly once for every box that overlaps x1..x2, y1..y2. For when duplicates matter, like
+		// drawing or counting.
+		template<typename Action>
+		void queryDistinct(float x1, float y1, float x2, float y2, Action action) const {
+			forEachCell(x1, y1, x2, y2, [&](int64_t column, int64_t row, size_t cell) {
+				for (uint32_t i = cellStarts[cell]; i < cellStarts[cell + 1]; ++i) {
+					const StaticBox& box = boxes[indices[i]];
+					if (box.x >= x2 || box.x + box.width <= x1 || box.y >= y2 || box.y + box.height <= y1) continue;
+					// every cell the box shares with the area lists it, so only take it from the one holding the top left
+					// corner of the overlap.
+					if (clampColumn(cellOf((box.x > x1 ? box.x : x1) - originX)) != column) continue;
+					if (clampRow(cellOf((box.y > y1 ? box.y : y1) - originY)) != row) continue;
+					action(box);
+				}
+			});
+		}
+
+	private:
+		template<typename Action>
+		void forEachCell(float x1, float y1, float x2, float y2, Action action) const {
+			if (isEmpty()) return;
+			int64_t column1 = cellOf(x1 - originX), column2 = cellOf(x2 - originX);
+			int64_t row1 = cellOf(y1 - originY), row2 = cellOf(y2 - originY);
+			if (column2 < 0 || row2 < 0 || column1 >= columns || row1 >= rows) return;
+			column1 = clampColumn(column1);
+			column2 = clampColumn(column2);
+			row1 = clampRow(row1);
+			row2 = clampRow(row2);
+
+			for (int64_t row = row1; row <= row2; ++row)
+				for (int64_t column = column1; column <= column2; ++column)
+					action(column, row, (size_t)(row * columns + column));
+		}
+
+		int64_t cellOf(float offset) const { return (int64_t)std::floor(offset / cellSize); }
+		int64_t clampColumn(int64_t column) const { return column < 0 ? 0 : column >= columns ? columns - 1 : column; }
+		int64_t clampRow(int64_t row) const { return row < 0 ? 0 : row >= rows ? rows - 1 : row; }
+	};
+
+
+
 	// o-------------------o
 	// | Engine definition |
 	// o-------------------o
 	class Engine {
 	public: // properties:
-		float getTimeScale() const { return timeScale; }
-		void  setTimeScale(float value) { timeScale = value; }
+		scalar getTimeScale() const { return timeScale; }
+		void  setTimeScale(scalar value) { timeScale = value; }
+
+		// Costs of the last update(). Always zero when compiled with PHY_NO_STATS.
+		const EngineStats& getStats() const { return stats; }
+
+		// With a job system, each pass finds every dynamic entity's collision in parallel, then applies them all.
+		// Everything is checked against where it was at the start of the pass, so unlike the serial passes, dynamic
+		// entities don't see each other's corrections until the next pass. nullptr (the default) runs serially.
+		JesseRussell::Threading::JobSystem* getJobSystem() const { return jobs; }
+		void setJobSystem(JesseRussell::Threading::JobSystem* value) { jobs = value; }
+
+		// Checked in the collision passes alongside the static entities. nullptr (the default) for none.
+		const StaticGeometry* getStaticGeometry() const { return staticGeometry; }
+		void setStaticGeometry(const StaticGeometry* value) { staticGeometry = value; }
 
 	public: // destructors:
 		~Engine() {
@@ -562,66 +745,114 @@ namespace phy {
 		}
 
 	public: // entities methods:
-		void entities_add(DynamicEntity* entity) {
+		void entities_add(Entity* entity) {
 			entities.push_back(entity);
 			if (entity->isDynamic())
-				dynamicEntities.insert(std::pair<DynamicEntity*, size_t>((DynamicEntity*)entity, entities.size() - 1));
+				dynamicEntities.push_back((DynamicEntity*)entity);
+			++entitiesVersion;
 		}
 
 		void entities_remove(size_t index) {
-			DynamicEntity* e = entities[index];
+			Entity* e = entities[index];
 
 			if (e->isDynamic())
-				dynamicEntities.erase((DynamicEntity*)e);
+				dynamicEntities.erase(std::find(dynamicEntities.begin(), dynamicEntities.end(), (DynamicEntity*)e));
 
 			entities.erase(entities.begin() + index);
+			++entitiesVersion;
 		}
 		
-		//Deletes from the heap the entity at the supplied index, then removes it from the list of entities.
+		//Removes the entity at the supplied index from the list of entities, then deletes it from the heap.
 		void entities_delete(size_t index) {
-			auto ep = entities.begin() + index;
-			delete (*ep);
+			Entity* e = entities[index];
 			entities_remove(index);
+			delete e;
+		}
+
+		// Adds every entity in batch, bumping the version once.
+		// (no reserve: reserving exactly size() + batch.size() on every batch would defeat push_back's geometric growth.)
+		void entities_addBatch(const std::vector<Entity*>& batch) {
+			for (Entity* e : batch) {
+				entities.push_back(e);
+				if (e->isDynamic())
+					dynamicEntities.push_back((DynamicEntity*)e);
+			}
+			++entitiesVersion;
+		}
+
+		// Removes every entity in batch from the list of entities and deletes it from the heap, in one pass over the list
+		// rather than one erase per entity. The order of the remaining entities is kept.
+		// The batch is sorted in a scratch vector the engine keeps, so once it has grown to fit this doesn't allocate.
+		// (sorted with std::less, since < isn't defined between unrelated pointers.)
+		void entities_deleteBatch(const std::vector<Entity*>& batch) {
+			deleteBatchSorted.assign(batch.begin(), batch.end());
+			std::sort(deleteBatchSorted.begin(), deleteBatchSorted.end(), std::less<Entity*>());
+			auto end = std::remove_if(entities.begin(), entities.end(), [this](Entity* e) {
+				return std::binary_search(deleteBatchSorted.begin(), deleteBatchSorted.end(), e, std::less<Entity*>());
+			});
+			entities.erase(end, entities.end());
+			auto dynamicEnd = std::remove_if(dynamicEntities.begin(), dynamicEntities.end(), [this](DynamicEntity* de) {
+				return std::binary_search(deleteBatchSorted.begin(), deleteBatchSorted.end(), (Entity*)de, std::less<Entity*>());
+			});
+			dynamicEntities.erase(dynamicEnd, dynamicEntities.end());
+
+			for (Entity* e : batch)
+				delete e;
+			++entitiesVersion;
 		}
 
 		//Deletes from the heap all entities.
 		void entities_deleteAll() {
-			for (DynamicEntity* e : entities) {
+			for (Entity* e : entities) {
 				delete e;
 			}
 			entities.clear();
 			dynamicEntities.clear();
+			++entitiesVersion;
 		}
 
 		void entities_clear() {
 			entities.clear();
 			dynamicEntities.clear();
+			++entitiesVersion;
 		}
 
-		DynamicEntity* entities_get(size_t index) const { return entities[index]; }
+		// Changes whenever an entity is added or removed, so caches built from the entity list (like a RenderGrid) know
+		// to rebuild. Moving an entity doesn't change it.
+		size_t entities_getVersion() const { return entitiesVersion; }
 
-		std::vector<DynamicEntity*>::const_iterator entities_cbegin() const { return entities.cbegin(); }
-		std::vector<DynamicEntity*>::const_iterator entities_cend() const { return entities.cend(); }
+		Entity* entities_get(size_t index) const { return entities[index]; }
+
+		std::vector<Entity*>::const_iterator entities_cbegin() const { return entities.cbegin(); }
+		std::vector<Entity*>::const_iterator entities_cend() const { return entities.cend(); }
 
 		// o------------o
 		// | Collisions |
 		// o------------o
 		void handleHorizontalCollisions() {
-			for (auto de_pair : dynamicEntities) {
-				DynamicEntity* de = de_pair.first;
+			EngineStats::Timer timer(stats.horizontalCollisions);
+			if (jobs != nullptr) {
+				handleCollisions_parallel<true>();
+				return;
+			}
+
+			for (DynamicEntity* de : dynamicEntities) {
+				EngineStats::count(stats.pairsTested, entities.size() - 1);
 
-				float collisionSpot_out;
-				float closestCollisionSpot;
+				scalar collisionSpot_out;
+				scalar closestCollisionSpot;
 				bool collisionDetected = false;
 
-				for (DynamicEntity* e : entities) {
+				for (Entity* e : entities) {
 					if (e != de && de->collidesHorizontal_stationary(*e, timeScale, collisionSpot_out)) {
 						closestCollisionSpot = collisionDetected ? cmp::closest(closestCollisionSpot, collisionSpot_out, de->position.x) : collisionSpot_out;
 						collisionDetected = true;
 					}
 				}
+				EngineStats::count(stats.pairsTested, collideStaticGeometry<true>(de, closestCollisionSpot, collisionDetected));
 
 				if (collisionDetected) {
+					EngineStats::count(stats.collisionsResolved, 1);
 					de->position.x = closestCollisionSpot;
 					de->velocity.x *= -de->bounciness;
 				}
@@ -629,27 +860,106 @@ namespace phy {
 		}
 
 		void handleVerticalCollisions() {
-			for (auto de_pair : dynamicEntities) {
-				DynamicEntity* de = de_pair.first;
+			EngineStats::Timer timer(stats.verticalCollisions);
+			if (jobs != nullptr) {
+				handleCollisions_parallel<false>();
+				return;
+			}
+
+			for (DynamicEntity* de : dynamicEntities) {
+				EngineStats::count(stats.pairsTested, entities.size() - 1);
 
-				float collisionSpot_out;
-				float closestCollisionSpot;
+				scalar collisionSpot_out;
+				scalar closestCollisionSpot;
 				bool collisionDetected = false;
 
-				for (DynamicEntity* e : entities) {
+				for (Entity* e : entities) {
 					if (e != de && de->collidesVertical_stationary(*e, timeScale, collisionSpot_out)) {
 						closestCollisionSpot = collisionDetected ? cmp::closest(closestCollisionSpot, collisionSpot_out, de->position.y) : collisionSpot_out;
 						collisionDetected = true;
 					}
 				}
+				EngineStats::count(stats.pairsTested, collideStaticGeometry<false>(de, closestCollisionSpot, collisionDetected));
 
 				if (collisionDetected) {
+					EngineStats::count(stats.collisionsResolved, 1);
 					de->position.y = closestCollisionSpot;
 					de->velocity.y *= -de->bounciness;
 				}
 			}
 		}
 
+		template<bool horizontal>
+		void handleCollisions_parallel() {
+			collisionResults.resize(dynamicEntities.size());
+			CollisionResult* results = collisionResults.data();
+
+			// find (only writes to the entity itself and its own result):
+			jobs->parallel_for(0, dynamicEntities.size(), 16, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					DynamicEntity* de = dynamicEntities[i];
+					scalar collisionSpot_out;
+					CollisionResult result = { false, 0, 0 };
+
+					for (Entity* e : entities) {
+						if (e != de && (horizontal
+							? de->collidesHorizontal_stationary(*e, timeScale, collisionSpot_out)
+							: de->collidesVertical_stationary(*e, timeScale, collisionSpot_out))) {
+							result.spot = result.detected ? cmp::closest(result.spot, collisionSpot_out, horizontal ? de->position.x : de->position.y) : collisionSpot_out;
+							result.detected = true;
+						}
+					}
+					result.staticTests = collideStaticGeometry<horizontal>(de, result.spot, result.detected);
+					results[i] = result;
+				}
+			});
+
+			// apply:
+			for (size_t i = 0; i < dynamicEntities.size(); ++i) {
+				DynamicEntity* de = dynamicEntities[i];
+				EngineStats::count(stats.pairsTested, entities.size() - 1 + results[i].staticTests);
+				if (results[i].detected) {
+					EngineStats::count(stats.collisionsResolved, 1);
+					if (horizontal) {
+						de->position.x = results[i].spot;
+						de->velocity.x *= -de->bounciness;
+					}
+					else {
+						de->position.y = results[i].spot;
+						de->velocity.y *= -de->bounciness;
+					}
+				}
+			}
+		}
+
+		// Tests de against the static geometry around where it's heading this pass, folding any collision into
+		// closestCollisionSpot and collisionDetected the same way the entity loops do. Returns how many boxes it tested.
+		template<bool horizontal>
+		size_t collideStaticGeometry(DynamicEntity* de, scalar& closestCollisionSpot, bool& collisionDetected) {
+			if (staticGeometry == nullptr) return 0;
+
+			scalar x1 = de->getX1(), y1 = de->getY1(), x2 = de->getX2(), y2 = de->getY2();
+			scalar move = (horizontal ? de->velocity.x : de->velocity.y) * timeScale;
+			scalar& low = horizontal ? x1 : y1;
+			scalar& high = horizontal ? x2 : y2;
+			if (move < 0) low += move;
+			else high += move;
+
+			size_t tested = 0;
+			staticGeometry->query((float)x1, (float)y1, (float)x2, (float)y2, [&](const StaticBox& box) {
+				++tested;
+				CollisionBox other(vector2(scalar(box.x), scalar(box.y)), Box(scalar(box.width), scalar(box.height)));
+				scalar collisionSpot_out;
+				if (horizontal
+					? de->collidesHorizontal_stationary(other, timeScale, collisionSpot_out)
+					: de->collidesVertical_stationary(other, timeScale, collisionSpot_out)) {
+					closestCollisionSpot = collisionDetected ? cmp::closest(closestCollisionSpot, collisionSpot_out, horizontal ? de->position.x : de->position.y) : collisionSpot_out;
+					collisionDetected = true;
+				}
+			});
+			return tested;
+		}
+
 		void runCollisions() {
 			pre_update_horizontal_allDynamicEntities();
 			handleHorizontalCollisions();
@@ -664,40 +974,55 @@ namespace phy {
 		// | pre and post update of entities |
 		// o---------------------------------o
 		void pre_updateAllEntities() {
-			for (DynamicEntity* e : entities)
+			EngineStats::Timer timer(stats.pre_update);
+			EngineStats::count(stats.hooksInvoked, entities.size());
+			for (Entity* e : entities)
 				e->pre_update(*this);
 		}
 
 		void post_updateAllEntities() {
-			for (DynamicEntity* e : entities)
+			EngineStats::Timer timer(stats.post_update);
+			EngineStats::count(stats.hooksInvoked, entities.size());
+			for (Entity* e : entities)
 				e->post_update(*this);
 		}
 
 		void pre_update_horizontal_allDynamicEntities() {
-			for (auto de_pair : dynamicEntities)
-				de_pair.first->pre_update_horizontal(*this);
+			EngineStats::Timer timer(stats.pre_update_horizontal);
+			EngineStats::count(stats.hooksInvoked, dynamicEntities.size());
+			for (DynamicEntity* de : dynamicEntities)
+				de->pre_update_horizontal(*this);
 		}
 
 		void pre_update_vertical_allDynamicEntities() {
-			for (auto de_pair : dynamicEntities)
-				de_pair.first->pre_update_vertical(*this);
+			EngineStats::Timer timer(stats.pre_update_vertical);
+			EngineStats::count(stats.hooksInvoked, dynamicEntities.size());
+			for (DynamicEntity* de : dynamicEntities)
+				de->pre_update_vertical(*this);
 		}
 
 		void post_update_horizontal_allDynamicEntities() {
-			for (auto de_pair : dynamicEntities)
-				de_pair.first->post_update_horizontal(*this);
+			EngineStats::Timer timer(stats.post_update_horizontal);
+			EngineStats::count(stats.hooksInvoked, dynamicEntities.size());
+			for (DynamicEntity* de : dynamicEntities)
+				de->post_update_horizontal(*this);
 		}
 
 		void post_update_vertical_allDynamicEntities() {
-			for (auto de_pair : dynamicEntities)
-				de_pair.first->post_update_vertical(*this);
+			EngineStats::Timer timer(stats.post_update_vertical);
+			EngineStats::count(stats.hooksInvoked, dynamicEntities.size());
+			for (DynamicEntity* de : dynamicEntities)
+				de->post_update_vertical(*this);
 		}
 
 		// o--------o
 		// | update |
 		// o--------o
 
-		void update(float timeScale) {
+		void update(scalar timeScale) {
+			resetStats();
+			EngineStats::Timer timer(stats.total);
+
 			this->timeScale = timeScale;
 			pre_updateAllEntities();
 
@@ -706,14 +1031,37 @@ namespace phy {
 			post_updateAllEntities();
 		}
 
+	private: // stats
+		// Counters accumulate until the next update(), so runCollisions() etc. can also be measured on their own.
+		void resetStats() {
+			if (!EngineStats::enabled) return;
+			stats = EngineStats();
+			stats.dynamicEntities = dynamicEntities.size();
+			stats.staticEntities = entities.size() - dynamicEntities.size();
+		}
+
 	private: // fields
-		float timeScale = 1.0;
-		std::vector<DynamicEntity*> entities;
-		std::map<DynamicEntity*, size_t> dynamicEntities;
+		scalar timeScale = 1.0;
+		EngineStats stats;
+		JesseRussell::Threading::JobSystem* jobs = nullptr;
+		const StaticGeometry* staticGeometry = nullptr;
+		size_t entitiesVersion = 0;
+		// scratch for the parallel passes, kept so they don't allocate every update:
+		struct CollisionResult {
+			bool detected;
+			scalar spot;
+			size_t staticTests;
+		};
+		std::vector<CollisionResult> collisionResults;
+		std::vector<Entity*> entities;
+		// In the order they were added, which is the order the serial passes resolve them in. (Not keyed by address: that
+		// order would depend on the allocator, and so would the results.)
+		std::vector<DynamicEntity*> dynamicEntities;
+		std::vector<Entity*> deleteBatchSorted;
 	};
 
-	void DynamicEntity::pre_update(Engine& engine) { updatePosition(engine.getTimeScale()); }
-	void DynamicEntity::post_update(Engine& engine) { updatePosition(engine.getTimeScale()); }
+	void Entity::pre_update(Engine& engine) { updatePosition(engine.getTimeScale()); }
+	void Entity::post_update(Engine& engine) { updatePosition(engine.getTimeScale()); }
 
 	void DynamicEntity::pre_update(Engine& engine) { touching = 0; }
 	void DynamicEntity::post_update(Engine& engine) { resetForce(); }
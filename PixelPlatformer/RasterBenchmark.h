@@ -0,0 +1,1020 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+#include "DrawList.h"
+#include "SpriteAtlas.h"
+#include "Stopwatch.h"
+#include "TiledRenderer.h"
+
+#include<cstdint>
+#include<cstdio>
+#include<cstring>
+#include<functional>
+#include<memory>
+#include<string>
+#include<thread>
+#include<utility>
+#include<vector>
+
+// Run with: PixelPlatformer --bench-raster [size]. Exits with 1 if any output check fails.
+namespace RasterBenchmark {
+	using JesseRussell::Diagnostics::Clock;
+
+	inline double secondsSince(Clock::time_point start) {
+		return std::chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	// Checks that failed since run() started. Any makes run() return 1, so scripts and builds notice.
+	inline int& failures() {
+		static int value = 0;
+		return value;
+	}
+
+	// Inexact comparisons blend shapes over each other many times, and each blend may be off by one or two, so the
+	// differences add up a little. A broken kernel is off by far more.
+	constexpr int inexactTolerance = 8;
+
+	// o-----------o
+	// | reference |
+	// o-----------o
+
+	// The way these were drawn before the span kernels and blitter: a bounds checked Draw per pixel, column by column,
+	// ALPHA blending in float and CUSTOM modes with a GetPixel per pixel. Kept to measure against, and to check the
+	// kernels draw the same pixels.
+	namespace PerPixel {
+		// What the engine's pixel blend and custom mode are set to, since they can't be read back.
+		inline float& blendFactor() {
+			static float value = 1.0f;
+			return value;
+		}
+
+		inline std::function<olc::Pixel(const int, const int, const olc::Pixel&, const olc::Pixel&)>& customMode() {
+			static std::function<olc::Pixel(const int, const int, const olc::Pixel&, const olc::Pixel&)> value;
+			return value;
+		}
+
+		inline bool draw(olc::PixelGameEngine& pge, int32_t x, int32_t y, olc::Pixel p) {
+			olc::Sprite* target = pge.GetDrawTarget();
+			if (pge.GetPixelMode() == olc::Pixel::CUSTOM) return target->SetPixel(x, y, customMode()(x, y, p, target->GetPixel(x, y)));
+			if (pge.GetPixelMode() != olc::Pixel::ALPHA) return pge.Draw(x, y, p);
+			olc::Pixel d = target->GetPixel(x, y);
+			float a = (float)(p.a / 255.0f) * blendFactor();
+			float c = 1.0f - a;
+			float r = a * (float)p.r + c * (float)d.r;
+			float g = a * (float)p.g + c * (float)d.g;
+			float b = a * (float)p.b + c * (float)d.b;
+			return target->SetPixel(x, y, olc::Pixel((uint8_t)r, (uint8_t)g, (uint8_t)b));
+		}
+
+		inline void clear(olc::PixelGameEngine& pge, olc::Pixel p) {
+			int pixels = pge.GetDrawTargetWidth() * pge.GetDrawTargetHeight();
+			olc::Pixel* m = pge.GetDrawTarget()->GetData();
+			for (int i = 0; i < pixels; i++) m[i] = p;
+		}
+
+		inline void fillRect(olc::PixelGameEngine& pge, int32_t x, int32_t y, int32_t w, int32_t h, olc::Pixel p) {
+			int32_t width = pge.GetDrawTargetWidth(), height = pge.GetDrawTargetHeight();
+			int32_t x2 = std::min(std::max(x + w, 0), width), y2 = std::min(std::max(y + h, 0), height);
+			x = std::min(std::max(x, 0), width);
+			y = std::min(std::max(y, 0), height);
+			for (int i = x; i < x2; i++)
+				for (int j = y; j < y2; j++)
+					draw(pge, i, j, p);
+		}
+
+		inline void drawLine(olc::PixelGameEngine& pge, int32_t x1, int32_t y1, int32_t x2, int32_t y2, olc::Pixel p) {
+			int32_t dx = x2 - x1, dy = y2 - y1;
+			if (dx == 0) {
+				if (y2 < y1) std::swap(y1, y2);
+				for (int32_t y = y1; y <= y2; y++) draw(pge, x1, y, p);
+				return;
+			}
+			if (dy == 0) {
+				if (x2 < x1) std::swap(x1, x2);
+				for (int32_t x = x1; x <= x2; x++) draw(pge, x, y1, p);
+				return;
+			}
+
+			// Bresenham, pixel by pixel.
+			int32_t dx1 = std::abs(dx), dy1 = std::abs(dy);
+			int32_t step = (dx < 0 && dy < 0) || (dx > 0 && dy > 0) ? 1 : -1;
+			if (dy1 <= dx1) {
+				int32_t x = dx >= 0 ? x1 : x2, y = dx >= 0 ? y1 : y2, xe = dx >= 0 ? x2 : x1;
+				int32_t px = 2 * dy1 - dx1;
+				draw(pge, x, y, p);
+				while (x < xe) {
+					x++;
+					if (px < 0) px += 2 * dy1;
+					else {
+						y += step;
+						px += 2 * (dy1 - dx1);
+					}
+					draw(pge, x, y, p);
+				}
+			}
+			else {
+				int32_t x = dy >= 0 ? x1 : x2, y = dy >= 0 ? y1 : y2, ye = dy >= 0 ? y2 : y1;
+				int32_t py = 2 * dx1 - dy1;
+				draw(pge, x, y, p);
+				while (y < ye) {
+					y++;
+					if (py <= 0) py += 2 * dx1;
+					else {
+						x += step;
+						py += 2 * (dx1 - dy1);
+					}
+					draw(pge, x, y, p);
+				}
+			}
+		}
+
+		inline void drawCircle(olc::PixelGameEngine& pge, int32_t x, int32_t y, int32_t radius, olc::Pixel p, uint8_t mask) {
+			if (radius < 0 || x < -radius || y < -radius || x - pge.GetDrawTargetWidth() > radius || y - pge.GetDrawTargetHeight() > radius) return;
+			if (radius == 0) {
+				draw(pge, x, y, p);
+				return;
+			}
+			int x0 = 0, y0 = radius, d = 3 - 2 * radius;
+			while (y0 >= x0) {
+				if (mask & 0x01) draw(pge, x + x0, y - y0, p);
+				if (mask & 0x04) draw(pge, x + y0, y + x0, p);
+				if (mask & 0x10) draw(pge, x - x0, y + y0, p);
+				if (mask & 0x40) draw(pge, x - y0, y - x0, p);
+				if (x0 != 0 && x0 != y0) {
+					if (mask & 0x02) draw(pge, x + y0, y - x0, p);
+					if (mask & 0x08) draw(pge, x + x0, y + y0, p);
+					if (mask & 0x20) draw(pge, x - y0, y + x0, p);
+					if (mask & 0x80) draw(pge, x - x0, y - y0, p);
+				}
+				if (d < 0) d += 4 * x0++ + 6;
+				else d += 4 * (x0++ - y0--) + 10;
+			}
+		}
+
+		inline void fillCircle(olc::PixelGameEngine& pge, int32_t x, int32_t y, int32_t radius, olc::Pixel p) {
+			if (radius < 0 || x < -radius || y < -radius || x - pge.GetDrawTargetWidth() > radius || y - pge.GetDrawTargetHeight() > radius) return;
+			if (radius == 0) {
+				draw(pge, x, y, p);
+				return;
+			}
+			auto drawline = [&](int sx, int ex, int y) { for (int x = sx; x <= ex; x++) draw(pge, x, y, p); };
+			int x0 = 0, y0 = radius, d = 3 - 2 * radius;
+			while (y0 >= x0) {
+				drawline(x - y0, x + y0, y - x0);
+				if (x0 > 0) drawline(x - y0, x + y0, y + x0);
+				if (d < 0) d += 4 * x0++ + 6;
+				else {
+					if (x0 != y0) {
+						drawline(x - x0, x + x0, y - y0);
+						drawline(x - x0, x + x0, y + y0);
+					}
+					d += 4 * (x0++ - y0--) + 10;
+				}
+			}
+		}
+
+		// As it was, gotos and all (from https://www.avrfreaks.net/sites/default/files/triangles.c).
+		inline void fillTriangle(olc::PixelGameEngine& pge, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, olc::Pixel p) {
+			auto drawline = [&](int sx, int ex, int ny) { for (int i = sx; i <= ex; i++) draw(pge, i, ny, p); };
+
+			int t1x, t2x, y, minx, maxx, t1xp, t2xp;
+			bool changed1 = false;
+			bool changed2 = false;
+			int signx1, signx2, dx1, dy1, dx2, dy2;
+			int e1, e2;
+			// Sort vertices
+			if (y1 > y2) { std::swap(y1, y2); std::swap(x1, x2); }
+			if (y1 > y3) { std::swap(y1, y3); std::swap(x1, x3); }
+			if (y2 > y3) { std::swap(y2, y3); std::swap(x2, x3); }
+
+			t1x = t2x = x1; y = y1;   // Starting points
+			dx1 = (int)(x2 - x1);
+			if (dx1 < 0) { dx1 = -dx1; signx1 = -1; }
+			else signx1 = 1;
+			dy1 = (int)(y2 - y1);
+
+			dx2 = (int)(x3 - x1);
+			if (dx2 < 0) { dx2 = -dx2; signx2 = -1; }
+			else signx2 = 1;
+			dy2 = (int)(y3 - y1);
+
+			if (dy1 > dx1) { std::swap(dx1, dy1); changed1 = true; }
+			if (dy2 > dx2) { std::swap(dy2, dx2); changed2 = true; }
+
+			e2 = (int)(dx2 >> 1);
+			// Flat top, just process the second half
+			if (y1 == y2) goto next;
+			e1 = (int)(dx1 >> 1);
+
+			for (int i = 0; i < dx1;) {
+				t1xp = 0; t2xp = 0;
+				if (t1x < t2x) { minx = t1x; maxx = t2x; }
+				else { minx = t2x; maxx = t1x; }
+				// process first line until y value is about to change
+				while (i < dx1) {
+					i++;
+					e1 += dy1;
+					while (e1 >= dx1) {
+						e1 -= dx1;
+						if (changed1) t1xp = signx1;//t1x += signx1;
+						else          goto next1;
+					}
+					if (changed1) break;
+					else t1x += signx1;
+				}
+				// Move line
+			next1:
+				// process second line until y value is about to change
+				while (1) {
+					e2 += dy2;
+					while (e2 >= dx2) {
+						e2 -= dx2;
+						if (changed2) t2xp = signx2;//t2x += signx2;
+						else          goto next2;
+					}
+					if (changed2)     break;
+					else              t2x += signx2;
+				}
+			next2:
+				if (minx > t1x) minx = t1x;
+				if (minx > t2x) minx = t2x;
+				if (maxx < t1x) maxx = t1x;
+				if (maxx < t2x) maxx = t2x;
+				drawline(minx, maxx, y);    // Draw line from min to max points found on the y
+											// Now increase y
+				if (!changed1) t1x += signx1;
+				t1x += t1xp;
+				if (!changed2) t2x += signx2;
+				t2x += t2xp;
+				y += 1;
+				if (y == y2) break;
+
+			}
+		next:
+			// Second half
+			dx1 = (int)(x3 - x2); if (dx1 < 0) { dx1 = -dx1; signx1 = -1; }
+			else signx1 = 1;
+			dy1 = (int)(y3 - y2);
+			t1x = x2;
+
+			if (dy1 > dx1) {   // swap values
+				std::swap(dy1, dx1);
+				changed1 = true;
+			}
+			else changed1 = false;
+
+			e1 = (int)(dx1 >> 1);
+
+			for (int i = 0; i <= dx1; i++) {
+				t1xp = 0; t2xp = 0;
+				if (t1x < t2x) { minx = t1x; maxx = t2x; }
+				else { minx = t2x; maxx = t1x; }
+				// process first line until y value is about to change
+				while (i < dx1) {
+					e1 += dy1;
+					while (e1 >= dx1) {
+						e1 -= dx1;
+						if (changed1) { t1xp = signx1; break; }//t1x += signx1;
+						else          goto next3;
+					}
+					if (changed1) break;
+					else   	   	  t1x += signx1;
+					if (i < dx1) i++;
+				}
+			next3:
+				// process second line until y value is about to change
+				while (t2x != x3) {
+					e2 += dy2;
+					while (e2 >= dx2) {
+						e2 -= dx2;
+						if (changed2) t2xp = signx2;
+						else          goto next4;
+					}
+					if (changed2)     break;
+					else              t2x += signx2;
+				}
+			next4:
+
+				if (minx > t1x) minx = t1x;
+				if (minx > t2x) minx = t2x;
+				if (maxx < t1x) maxx = t1x;
+				if (maxx < t2x) maxx = t2x;
+				drawline(minx, maxx, y);
+				if (!changed1) t1x += signx1;
+				t1x += t1xp;
+				if (!changed2) t2x += signx2;
+				t2x += t2xp;
+				y += 1;
+				if (y > y3) return;
+			}
+		}
+
+		inline void drawRect(olc::PixelGameEngine& pge, int32_t x, int32_t y, int32_t w, int32_t h, olc::Pixel p) {
+			drawLine(pge, x, y, x + w, y, p);
+			drawLine(pge, x + w, y, x + w, y + h, p);
+			drawLine(pge, x + w, y + h, x, y + h, p);
+			drawLine(pge, x, y + h, x, y, p);
+		}
+
+		inline void drawSprite(olc::PixelGameEngine& pge, int32_t x, int32_t y, olc::Sprite* sprite, uint32_t scale, uint8_t flip) {
+			int32_t fxs = 0, fxm = 1, fx = 0;
+			int32_t fys = 0, fym = 1, fy = 0;
+			if (flip & olc::Sprite::Flip::HORIZ) { fxs = sprite->width - 1; fxm = -1; }
+			if (flip & olc::Sprite::Flip::VERT) { fys = sprite->height - 1; fym = -1; }
+			if (scale < 1) scale = 1;
+
+			fx = fxs;
+			for (int32_t i = 0; i < sprite->width; i++, fx += fxm) {
+				fy = fys;
+				for (int32_t j = 0; j < sprite->height; j++, fy += fym)
+					for (uint32_t is = 0; is < scale; is++)
+						for (uint32_t js = 0; js < scale; js++)
+							draw(pge, x + (i * scale) + is, y + (j * scale) + js, sprite->GetPixel(fx, fy));
+			}
+		}
+
+		// DrawString and DrawStringProp as they were: a GetPixel from the font sheet per texel, a Draw per lit one, in
+		// MASK mode, or ALPHA if the colour isn't opaque. Glyph widths are the engine's.
+		inline void drawString(olc::PixelGameEngine& pge, int32_t x, int32_t y, const std::string& text, olc::Pixel col, uint32_t scale, bool proportional) {
+			static const uint8_t spacing[96] = {
+				0x03,0x25,0x16,0x08,0x07,0x08,0x08,0x04,0x15,0x15,0x08,0x07,0x15,0x07,0x24,0x08,
+				0x08,0x17,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x24,0x15,0x06,0x07,0x16,0x17,
+				0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x17,0x08,0x08,0x17,0x08,0x08,0x08,
+				0x08,0x08,0x08,0x08,0x17,0x08,0x08,0x08,0x08,0x17,0x08,0x15,0x08,0x15,0x08,0x08,
+				0x24,0x18,0x17,0x17,0x17,0x17,0x17,0x17,0x17,0x33,0x17,0x17,0x33,0x18,0x17,0x17,
+				0x17,0x17,0x17,0x17,0x07,0x17,0x17,0x18,0x18,0x17,0x17,0x07,0x33,0x07,0x08,0x00 };
+			const olc::Sprite* font = pge.GetFontSprite();
+			olc::Pixel::Mode mode = pge.GetPixelMode();
+			pge.SetPixelMode(col.a != 255 ? olc::Pixel::ALPHA : olc::Pixel::MASK);
+			int32_t sx = 0, sy = 0;
+			for (char c : text) {
+				if (c == '\n') {
+					sx = 0;
+					sy += 8 * scale;
+					continue;
+				}
+				int32_t ox = (c - 32) % 16, oy = (c - 32) / 16;
+				int32_t first = proportional ? spacing[c - 32] >> 4 : 0, width = proportional ? spacing[c - 32] & 15 : 8;
+				for (int32_t i = 0; i < width; i++)
+					for (int32_t j = 0; j < 8; j++)
+						if (font->GetPixel(i + ox * 8 + first, j + oy * 8).r > 0)
+							for (uint32_t is = 0; is < std::max(scale, 1u); is++)
+								for (uint32_t js = 0; js < std::max(scale, 1u); js++)
+									draw(pge, x + sx + (i * std::max(scale, 1u)) + is, y + sy + (j * std::max(scale, 1u)) + js, col);
+				sx += width * scale;
+			}
+			pge.SetPixelMode(mode);
+		}
+	}
+
+
+
+	// o-----o
+	// | run |
+	// o-----o
+
+	// Shapes at made up but repeatable positions, some of them hanging off the edges so clipping is exercised too.
+	struct Shape {
+		int32_t x, y, w, h;
+	};
+
+	inline std::vector<Shape> makeShapes(int32_t size, int32_t maxShapeSize, size_t count) {
+		std::vector<Shape> shapes;
+		uint32_t seed = 12345;
+		auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+		for (size_t i = 0; i < count; ++i) {
+			int32_t w = 1 + (int32_t)(next() % (uint32_t)maxShapeSize), h = 1 + (int32_t)(next() % (uint32_t)maxShapeSize);
+			int32_t x = (int32_t)(next() % (uint32_t)(size + w)) - w / 2, y = (int32_t)(next() % (uint32_t)(size + h)) - h / 2;
+			shapes.push_back({ x, y, w, h });
+		}
+		return shapes;
+	}
+
+	// Times draw(shape, colour) over every shape, the old way and the new way, and prints pixels per second for both.
+	// pixels is how many pixels one pass over the shapes asks for (clipped or not). Then both draw once more onto the
+	// same background and the results are compared. They must be identical if exact, otherwise within inexactTolerance
+	// in every channel, and the largest difference is reported. Returns whether they were, counting a failure if not.
+	template<typename Old, typename New>
+	bool compare(const char* name, olc::PixelGameEngine& pge, olc::Sprite& a, olc::Sprite& b, const std::vector<Shape>& shapes, double pixels, Old drawOld, New drawNew, bool exact = true) {
+		auto time = [&](olc::Sprite& target, auto draw) {
+			pge.SetDrawTarget(&target);
+			int passes = 0;
+			Clock::time_point start = Clock::now();
+			double seconds;
+			do {
+				uint32_t colour = 0xFF000000u | (uint32_t)passes * 2654435761u;
+				for (const Shape& shape : shapes) draw(shape, olc::Pixel(colour));
+				++passes;
+				seconds = secondsSince(start);
+			} while (seconds < 0.25);
+			return pixels * passes / seconds;
+		};
+		double oldRate = time(a, drawOld);
+		double newRate = time(b, drawNew);
+
+		// a gradient underneath, so blending has something to mix with.
+		for (olc::Sprite* target : { &a, &b })
+			for (int32_t i = 0; i < target->width * target->height; ++i)
+				target->GetData()[i] = olc::Pixel((uint8_t)(i % target->width), (uint8_t)(i / target->width), (uint8_t)(i * 7), 255);
+		// translucent, for when the mode is ALPHA.
+		auto colourOf = [&](const Shape& shape) { return olc::Pixel(0x3000FF00u + (uint32_t)(&shape - &shapes[0]) * 0x01030507u); };
+		pge.SetDrawTarget(&a);
+		for (const Shape& shape : shapes) drawOld(shape, colourOf(shape));
+		pge.SetDrawTarget(&b);
+		for (const Shape& shape : shapes) drawNew(shape, colourOf(shape));
+
+		int maxError = 0;
+		for (int32_t i = 0; i < a.width * a.height; ++i) {
+			olc::Pixel p = a.GetData()[i], q = b.GetData()[i];
+			maxError = std::max({ maxError, std::abs(p.r - q.r), std::abs(p.g - q.g), std::abs(p.b - q.b), std::abs(p.a - q.a) });
+		}
+
+		std::printf("  %-20s %9.1f Mpixels/s -> %9.1f Mpixels/s  (x%.1f)", name, oldRate / 1e6, newRate / 1e6, newRate / oldRate);
+		bool matched = maxError <= (exact ? 0 : inexactTolerance);
+		if (!exact) std::printf("  max error %d", maxError);
+		if (!matched) std::printf("  DIFFERENT OUTPUT (max error %d)", maxError);
+		std::printf("\n");
+		if (!matched) ++failures();
+		return matched;
+	}
+
+	// Random texels, about a quarter of them see-through, so MASK has something to skip.
+	inline void fillSprite(olc::Sprite& sprite) {
+		uint32_t seed = 777;
+		for (int32_t i = 0; i < sprite.width * sprite.height; ++i) {
+			seed = seed * 1664525u + 1013904223u;
+			sprite.GetData()[i] = olc::Pixel(seed | 0xFF000000u);
+			if ((seed >> 28) < 4) sprite.GetData()[i].a = 0;
+		}
+	}
+
+	inline void sprites(olc::PixelGameEngine& pge, olc::Sprite& a, olc::Sprite& b, int32_t size) {
+		for (int32_t spriteSize : { 16, 64 }) {
+			olc::Sprite sprite(spriteSize, spriteSize);
+			fillSprite(sprite);
+			for (uint32_t scale : { 1u, 2u, 4u }) {
+				int32_t drawn = spriteSize * (int32_t)scale;
+				std::vector<Shape> shapes = makeShapes(size, 1, 200);
+				double pixels = (double)shapes.size() * drawn * drawn;
+				for (olc::Pixel::Mode mode : { olc::Pixel::NORMAL, olc::Pixel::MASK }) {
+					char name[32];
+					std::snprintf(name, sizeof(name), "%dx%d x%u %s", spriteSize, spriteSize, scale, mode == olc::Pixel::NORMAL ? "NORMAL" : "MASK");
+					pge.SetPixelMode(mode);
+					// every fourth one flipped each way, so the flipped paths are timed and checked too.
+					auto flipOf = [&](const Shape& s) { return (uint8_t)((&s - &shapes[0]) % 4); };
+					compare(name, pge, a, b, shapes, pixels,
+						[&](const Shape& s, olc::Pixel) { PerPixel::drawSprite(pge, s.x - drawn / 2, s.y - drawn / 2, &sprite, scale, flipOf(s)); },
+						[&](const Shape& s, olc::Pixel) { pge.DrawSprite(s.x - drawn / 2, s.y - drawn / 2, &sprite, scale, flipOf(s)); });
+				}
+				pge.SetPixelMode(olc::Pixel::NORMAL);
+			}
+		}
+	}
+
+	// Every source channel value, alpha and destination channel value, blended once by DrawSprite, against the float
+	// formula. Returns the largest difference in any channel.
+	inline int alphaErrorBound(olc::PixelGameEngine& pge) {
+		olc::Sprite source(256, 256), target(256, 256);
+		for (int32_t y = 0; y < 256; ++y)
+			for (int32_t x = 0; x < 256; ++x)
+				source.SetPixel(x, y, olc::Pixel((uint8_t)x, (uint8_t)(255 - x), (uint8_t)x, (uint8_t)y));
+
+		int maxError = 0;
+		// target is gone when this returns, so the engine gets its old draw target back.
+		olc::Sprite* previousTarget = pge.GetDrawTarget();
+		pge.SetDrawTarget(&target);
+		for (int32_t d = 0; d < 256; ++d) {
+			olc::Pixel background((uint8_t)d, (uint8_t)d, (uint8_t)(255 - d));
+			std::fill(target.GetData(), target.GetData() + 256 * 256, background);
+			pge.DrawSprite(0, 0, &source);
+			for (int32_t i = 0; i < 256 * 256; ++i) {
+				olc::Pixel p = source.GetData()[i], q = target.GetData()[i];
+				float alpha = (float)(p.a / 255.0f) * PerPixel::blendFactor(), c = 1.0f - alpha;
+				int r = (uint8_t)(alpha * p.r + c * background.r), g = (uint8_t)(alpha * p.g + c * background.g), b = (uint8_t)(alpha * p.b + c * background.b);
+				maxError = std::max({ maxError, std::abs(r - q.r), std::abs(g - q.g), std::abs(b - q.b), 255 - q.a });
+			}
+		}
+		pge.SetDrawTarget(previousTarget);
+		return maxError;
+	}
+
+	inline void alpha(olc::PixelGameEngine& pge, olc::Sprite& a, olc::Sprite& b, int32_t size) {
+		pge.SetPixelMode(olc::Pixel::ALPHA);
+		olc::Sprite sprite(64, 64);
+		fillSprite(sprite);
+		for (int32_t i = 0; i < 64 * 64; ++i) sprite.GetData()[i].a = (uint8_t)(i * 37);
+
+		// where DrawString's font has pixels, found by drawing the text opaque onto a blank target. (The font is normally
+		// made when the engine starts.)
+		pge.olc_ConstructFontSheet();
+		const std::string text = "The quick brown fox, 0123456789";
+		std::vector<std::pair<int32_t, int32_t>> glyphPixels;
+		{
+			pge.SetPixelMode(olc::Pixel::NORMAL);
+			olc::Sprite scratch(8 * (int32_t)text.size() * 2, 16);
+			olc::Sprite* previousTarget = pge.GetDrawTarget();
+			pge.SetDrawTarget(&scratch);
+			PerPixel::clear(pge, olc::BLANK);
+			pge.DrawString(0, 0, text, olc::WHITE, 2);
+			for (int32_t y = 0; y < scratch.height; ++y)
+				for (int32_t x = 0; x < scratch.width; ++x)
+					if (scratch.GetPixel(x, y).a != 0) glyphPixels.push_back({ x, y });
+			pge.SetDrawTarget(previousTarget);
+			pge.SetPixelMode(olc::Pixel::ALPHA);
+		}
+
+		// Differences add up where shapes overlap, so the max errors here are after many blends, not one.
+		for (float blend : { 1.0f, 0.6f }) {
+			pge.SetPixelBlend(blend);
+			PerPixel::blendFactor() = blend;
+			// the blend factor is rounded to 1/256ths, which costs one more below full blend.
+			int bound = alphaErrorBound(pge), allowed = blend == 1.0f ? 1 : 2;
+			std::printf(" ALPHA pixel mode, blend %.1f (one blend is at most %d from the float formula):\n", blend, bound);
+			if (bound > allowed) {
+				std::printf("  ONE BLEND IS OFF BY MORE THAN %d\n", allowed);
+				++failures();
+			}
+
+			std::vector<Shape> shapes = makeShapes(size, 64, 1000);
+			double area = 0;
+			for (const Shape& s : shapes) area += (double)s.w * s.h;
+			compare("FillRect", pge, a, b, shapes, area,
+				[&](const Shape& s, olc::Pixel p) { PerPixel::fillRect(pge, s.x, s.y, s.w, s.h, p); },
+				[&](const Shape& s, olc::Pixel p) { pge.FillRect(s.x, s.y, s.w, s.h, p); }, false);
+
+			std::vector<Shape> points = makeShapes(size, 1, 200);
+			compare("64x64 sprite", pge, a, b, points, (double)points.size() * 64 * 64,
+				[&](const Shape& s, olc::Pixel) { PerPixel::drawSprite(pge, s.x - 32, s.y - 32, &sprite, 1, 0); },
+				[&](const Shape& s, olc::Pixel) { pge.DrawSprite(s.x - 32, s.y - 32, &sprite, 1, 0); }, false);
+
+			compare("DrawString x2", pge, a, b, points, (double)points.size() * glyphPixels.size(),
+				[&](const Shape& s, olc::Pixel p) { for (auto& g : glyphPixels) PerPixel::draw(pge, s.x + g.first, s.y + g.second, p); },
+				[&](const Shape& s, olc::Pixel p) { pge.DrawString(s.x, s.y, text, p, 2); }, false);
+		}
+		pge.SetPixelBlend(1.0f);
+		PerPixel::blendFactor() = 1.0f;
+		pge.SetPixelMode(olc::Pixel::NORMAL);
+	}
+
+	// Corners of a triangle made from a shape: some flat topped, some leaning either way.
+	struct Triangle {
+		int32_t x1, y1, x2, y2, x3, y3;
+	};
+
+	inline Triangle triangleOf(const Shape& s, size_t i) {
+		return { s.x, s.y, s.x + s.w, s.y + (i % 3 == 0 ? 0 : s.h / 2), s.x + (i % 2 == 0 ? s.w / 3 : -s.w / 2), s.y + s.h };
+	}
+
+	inline void primitives(olc::PixelGameEngine& pge, olc::Sprite& a, olc::Sprite& b, int32_t size) {
+		std::vector<Shape> shapes = makeShapes(size, 64, 1000);
+		double circleArea = 0, circumference = 0, triangleArea = 0, linePixels = 0;
+		for (const Shape& s : shapes) {
+			circleArea += 3.14159 * (s.w / 2) * (s.w / 2);
+			circumference += 2 * 3.14159 * (s.w / 2);
+			triangleArea += (double)s.w * s.h / 2;
+			linePixels += std::max(std::abs(s.w - 32), std::abs(s.h - 32)) + 1;
+		}
+		auto index = [&](const Shape& s) { return (size_t)(&s - &shapes[0]); };
+		// some circles with only a few octants.
+		auto maskOf = [&](const Shape& s) { static const uint8_t masks[] = { 0xFF, 0xFF, 0x0F, 0xA5, 0x3C }; return masks[index(s) % 5]; };
+
+		for (olc::Pixel::Mode mode : { olc::Pixel::NORMAL, olc::Pixel::ALPHA }) {
+			pge.SetPixelMode(mode);
+			bool exact = mode != olc::Pixel::ALPHA;
+			std::printf(" circles, triangles and lines, %s pixel mode:\n", exact ? "NORMAL" : "ALPHA");
+			compare("FillCircle", pge, a, b, shapes, circleArea,
+				[&](const Shape& s, olc::Pixel p) { PerPixel::fillCircle(pge, s.x, s.y, s.w / 2, p); },
+				[&](const Shape& s, olc::Pixel p) { pge.FillCircle(s.x, s.y, s.w / 2, p); }, exact);
+			compare("DrawCircle", pge, a, b, shapes, circumference,
+				[&](const Shape& s, olc::Pixel p) { PerPixel::drawCircle(pge, s.x, s.y, s.w / 2, p, maskOf(s)); },
+				[&](const Shape& s, olc::Pixel p) { pge.DrawCircle(s.x, s.y, s.w / 2, p, maskOf(s)); }, exact);
+			compare("FillTriangle", pge, a, b, shapes, triangleArea,
+				[&](const Shape& s, olc::Pixel p) { Triangle t = triangleOf(s, index(s)); PerPixel::fillTriangle(pge, t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, p); },
+				[&](const Shape& s, olc::Pixel p) { Triangle t = triangleOf(s, index(s)); pge.FillTriangle(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, p); }, exact);
+			compare("DrawLine diagonal", pge, a, b, shapes, linePixels,
+				[&](const Shape& s, olc::Pixel p) { PerPixel::drawLine(pge, s.x, s.y, s.x + s.w - 32, s.y + s.h - 32, p); },
+				[&](const Shape& s, olc::Pixel p) { pge.DrawLine(s.x, s.y, s.x + s.w - 32, s.y + s.h - 32, p); }, exact);
+		}
+		pge.SetPixelMode(olc::Pixel::NORMAL);
+
+		std::printf(" half-space triangles:\n");
+		// 4 x 4 tiles, drawn one after the other, must add up to the whole triangle.
+		int32_t tile = (size + 3) / 4;
+		compare("16 tiles", pge, a, b, shapes, triangleArea,
+			[&](const Shape& s, olc::Pixel p) { Triangle t = triangleOf(s, index(s)); pge.FillTriangleHalfSpace(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, p); },
+			[&](const Shape& s, olc::Pixel p) {
+				Triangle t = triangleOf(s, index(s));
+				for (int32_t ty = 0; ty < size; ty += tile)
+					for (int32_t tx = 0; tx < size; tx += tile)
+						pge.FillTriangleHalfSpace(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, p, tx, ty, tile, tile);
+			});
+
+		// Only pixel centres inside count, so edges differ from FillTriangle's.
+		int64_t onlyOld = 0, onlyNew = 0, both = 0;
+		for (const Shape& s : shapes) {
+			Triangle t = triangleOf(s, index(s));
+			pge.SetDrawTarget(&a);
+			PerPixel::clear(pge, olc::BLANK);
+			pge.FillTriangle(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, olc::WHITE);
+			pge.SetDrawTarget(&b);
+			PerPixel::clear(pge, olc::BLANK);
+			pge.FillTriangleHalfSpace(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, olc::WHITE);
+			for (int32_t i = 0; i < size * size; ++i) {
+				bool inOld = a.GetData()[i].a != 0, inNew = b.GetData()[i].a != 0;
+				onlyOld += inOld && !inNew;
+				onlyNew += inNew && !inOld;
+				both += inOld && inNew;
+			}
+		}
+		std::printf("  coverage vs FillTriangle: %lld pixels in both, %lld only in FillTriangle, %lld only in half-space\n", (long long)both, (long long)onlyOld, (long long)onlyNew);
+
+		// Each rectangle as two triangles sharing a diagonal, counting how often each pixel is drawn: every pixel of it
+		// must be drawn exactly once.
+		pge.SetPixelMode([](const int, const int, const olc::Pixel&, const olc::Pixel& dest) { return olc::Pixel(dest.r + 1, 0, 0); });
+		int64_t wrong = 0;
+		pge.SetDrawTarget(&a);
+		for (const Shape& s : shapes) {
+			int32_t x = std::max(std::min(s.x, size - 1 - s.w), 0), y = std::max(std::min(s.y, size - 1 - s.h), 0);
+			PerPixel::clear(pge, olc::Pixel(0, 0, 0));
+			pge.FillTriangleHalfSpace(x, y, x + s.w, y, x + s.w, y + s.h, olc::WHITE);
+			pge.FillTriangleHalfSpace(x, y, x + s.w, y + s.h, x, y + s.h, olc::WHITE);
+			int64_t once = 0;
+			for (int32_t i = 0; i < size * size; ++i) {
+				once += a.GetData()[i].r == 1;
+				wrong += a.GetData()[i].r > 1;
+			}
+			wrong += std::abs(once - (int64_t)s.w * s.h);
+		}
+		pge.SetPixelMode(olc::Pixel::NORMAL);
+		if (wrong > 0) {
+			std::printf("  TRIANGLE PAIRS OVERLAP OR LEAVE GAPS (%lld pixels)\n", (long long)wrong);
+			++failures();
+		}
+		else std::printf("  triangle pairs cover every rectangle exactly once\n");
+	}
+
+	// The engine's drawing routines under the TiledRenderer's names, so the same scene can be drawn either way.
+	struct Direct {
+		olc::PixelGameEngine& pge;
+		void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, olc::Pixel p) { pge.FillRect(x, y, w, h, p); }
+		void drawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, olc::Pixel p) { pge.DrawLine(x1, y1, x2, y2, p); }
+		void drawCircle(int32_t x, int32_t y, int32_t radius, olc::Pixel p) { pge.DrawCircle(x, y, radius, p); }
+		void fillCircle(int32_t x, int32_t y, int32_t radius, olc::Pixel p) { pge.FillCircle(x, y, radius, p); }
+		void fillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, olc::Pixel p) { pge.FillTriangle(x1, y1, x2, y2, x3, y3, p); }
+		void drawSprite(int32_t x, int32_t y, olc::Sprite* sprite, uint32_t scale, uint8_t flip) { pge.DrawSprite(x, y, sprite, scale, flip); }
+		void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, olc::Pixel p) { pge.DrawRect(x, y, w, h, p); }
+		void drawString(int32_t x, int32_t y, const std::string& text, olc::Pixel p) { pge.DrawString(x, y, text, p); }
+		void setPixelMode(olc::Pixel::Mode mode) { pge.SetPixelMode(mode); }
+		// drawn straight away, so layers have to be drawn in order.
+		void setLayer(uint8_t) {}
+	};
+
+	// A bit of everything, overlapping. Returns how many pixels it asks for.
+	template<typename Api>
+	double drawScene(Api& api, const std::vector<Shape>& shapes, olc::Sprite& sprite, olc::Pixel p) {
+		double pixels = 0;
+		for (size_t i = 0; i < shapes.size(); ++i) {
+			const Shape& s = shapes[i];
+			switch (i % 6) {
+			case 0: api.fillRect(s.x, s.y, s.w, s.h, p); pixels += (double)s.w * s.h; break;
+			case 1: api.fillCircle(s.x, s.y, s.w / 2, p); pixels += 3.14159 * (s.w / 2) * (s.w / 2); break;
+			case 2: { Triangle t = triangleOf(s, i); api.fillTriangle(t.x1, t.y1, t.x2, t.y2, t.x3, t.y3, p); pixels += (double)s.w * s.h / 2; break; }
+			case 3: api.drawLine(s.x, s.y, s.x + s.w - 64, s.y + s.h - 64, p); pixels += std::max(std::abs(s.w - 64), std::abs(s.h - 64)) + 1; break;
+			case 4: api.drawCircle(s.x, s.y, s.w / 2, p); pixels += 2 * 3.14159 * (s.w / 2); break;
+			case 5: api.drawSprite(s.x, s.y, &sprite, 1 + (uint32_t)(i / 6 % 2), (uint8_t)(i % 4)); pixels += 64.0 * 64 * (1 + i / 6 % 2) * (1 + i / 6 % 2); break;
+			}
+		}
+		return pixels;
+	}
+
+	// A full HD target (where the engine at pixel size 1 runs out of fill rate), drawn straight through the engine, then
+	// through the TiledRenderer on one thread and on all of them. The output must be the same to the pixel.
+	inline void tiled(olc::PixelGameEngine& pge) {
+		const int32_t width = 1920, height = 1080;
+		olc::Sprite a(width, height), b(width, height);
+		olc::Sprite sprite(64, 64);
+		fillSprite(sprite);
+		for (int32_t i = 0; i < 64 * 64; ++i) sprite.GetData()[i].a = (uint8_t)(i * 37);
+
+		std::vector<Shape> shapes = makeShapes(width, 128, 3000);
+		for (Shape& s : shapes) s.y = s.y * height / width;
+		Direct direct{ pge };
+		// drawn once onto a single pixel, just for the count.
+		olc::Sprite counter(1, 1);
+		olc::Sprite* previousTarget = pge.GetDrawTarget();
+		pge.SetDrawTarget(&counter);
+		double pixels = drawScene(direct, shapes, sprite, olc::WHITE);
+
+		// at least 4 threads, so the bands really are shared out, however many cores there are.
+		JesseRussell::Threading::JobSystem one(1), all(std::max(std::thread::hardware_concurrency(), 4u));
+		std::vector<Shape> whole = { { 0, 0, width, height } };
+		for (float blend : { 1.0f, 0.6f }) {
+			olc::Pixel::Mode mode = blend == 1.0f ? olc::Pixel::NORMAL : olc::Pixel::ALPHA;
+			std::printf(" %d x %d, %s pixel mode, tiled:\n", width, height, mode == olc::Pixel::NORMAL ? "NORMAL" : "ALPHA, blend 0.6");
+			pge.SetPixelMode(mode);
+			pge.SetPixelBlend(blend);
+			for (JesseRussell::Threading::JobSystem* jobs : { &one, &all }) {
+				JesseRussell::Graphics::TiledRenderer renderer(*jobs);
+				renderer.setPixelMode(mode);
+				renderer.setPixelBlend(blend);
+				char name[32];
+				std::snprintf(name, sizeof(name), "%u thread%s", jobs->getThreadCount(), jobs->getThreadCount() == 1 ? "" : "s");
+				compare(name, pge, a, b, whole, pixels,
+					[&](const Shape&, olc::Pixel p) { drawScene(direct, shapes, sprite, p); },
+					[&](const Shape&, olc::Pixel p) { drawScene(renderer, shapes, sprite, p); renderer.execute(pge.GetDrawTarget()); });
+			}
+		}
+		pge.SetPixelBlend(1.0f);
+		pge.SetPixelMode(olc::Pixel::NORMAL);
+		// a and b are gone when this returns.
+		pge.SetDrawTarget(previousTarget);
+	}
+
+	// Something like a HUD, drawn in layer order: a background of 8 x 8 cells in blocks of colour, reaching a cell past
+	// every edge, then panel outlines, then icons from three sprites, then a label on each panel. Nothing overlaps
+	// anything else on its layer. Returns how many pixels it asks for.
+	template<typename Api>
+	double drawHud(Api& api, int32_t size, olc::Sprite* icons) {
+		double pixels = 0;
+		api.setLayer(0);
+		for (int32_t y = -8; y < size + 8; y += 8)
+			for (int32_t x = -8; x < size + 8; x += 8) {
+				api.fillRect(x, y, 8, 8, olc::Pixel(40 + (uint8_t)(x / 64 * 16), 40, 40 + (uint8_t)(y / 32 * 16)));
+				pixels += 64;
+			}
+
+		api.setLayer(1);
+		for (int32_t y = 0; y < size; y += 64)
+			for (int32_t x = 0; x < size; x += 64) {
+				api.drawRect(x + 2, y + 2, 59, 59, olc::GREY);
+				pixels += 4 * 59;
+			}
+
+		api.setLayer(2);
+		api.setPixelMode(olc::Pixel::MASK);
+		for (int32_t y = 16; y < size; y += 32)
+			for (int32_t x = 8; x < size; x += 32) {
+				api.drawSprite(x, y, &icons[(x + y) / 32 % 3], 1, olc::Sprite::NONE);
+				pixels += 16 * 16;
+			}
+		api.setPixelMode(olc::Pixel::NORMAL);
+
+		api.setLayer(3);
+		for (int32_t y = 0; y < size; y += 64)
+			for (int32_t x = 0; x < size; x += 64) {
+				char label[32];
+				std::snprintf(label, sizeof(label), "%d,%d", x / 64, y / 64);
+				api.drawString(x + 6, y + 6, label, olc::WHITE);
+				pixels += 64.0 * std::strlen(label);
+			}
+		return pixels;
+	}
+
+	// The HUD drawn straight through the engine every frame, then recorded into a DrawList once and executed every
+	// frame, and recorded again every frame. The output must be the same to the pixel.
+	inline void drawList(olc::PixelGameEngine& pge, olc::Sprite& a, olc::Sprite& b, int32_t size) {
+		olc::Sprite icons[3] = { { 16, 16 }, { 16, 16 }, { 16, 16 } };
+		for (olc::Sprite& icon : icons) fillSprite(icon);
+		Direct direct{ pge };
+		olc::Sprite counter(1, 1);
+		pge.SetDrawTarget(&counter);
+		double pixels = drawHud(direct, size, icons);
+
+		JesseRussell::Graphics::DrawList list;
+		drawHud(list, size, icons);
+		std::printf(" DrawList, a HUD:\n");
+		std::vector<Shape> whole = { { 0, 0, size, size } };
+		compare("recorded once", pge, a, b, whole, pixels,
+			[&](const Shape&, olc::Pixel) { drawHud(direct, size, icons); },
+			[&](const Shape&, olc::Pixel) { list.execute(pge); });
+		std::printf("  %zu commands, %zu drawn after culling and merging\n", list.getCommandCount(), list.getDrawnCount());
+		compare("recorded every frame", pge, a, b, whole, pixels,
+			[&](const Shape&, olc::Pixel) { drawHud(direct, size, icons); },
+			[&](const Shape&, olc::Pixel) { list.clear(); drawHud(list, size, icons); list.execute(pge); });
+	}
+
+	// Lots of small sprites of mixed sizes, each its own allocation, drawn one DrawSprite at a time, then packed into an
+	// atlas and drawn in one batch. The atlas is saved and loaded back, and must come back the same.
+	inline void atlas(olc::PixelGameEngine& pge, olc::Sprite& a, olc::Sprite& b, int32_t size) {
+		std::vector<Shape> sizes = makeShapes(1, 24, 256);
+		std::vector<std::unique_ptr<olc::Sprite>> sprites;
+		JesseRussell::Graphics::SpriteAtlasBuilder builder;
+		int64_t area = 0;
+		for (const Shape& s : sizes) {
+			sprites.emplace_back(new olc::Sprite(8 + s.w, 8 + s.h));
+			fillSprite(*sprites.back());
+			builder.add(sprites.back().get());
+			area += (int64_t)(8 + s.w) * (8 + s.h);
+		}
+		JesseRussell::Graphics::SpriteAtlas atlas, loaded;
+		builder.build(atlas);
+
+		bool same = true;
+		for (uint32_t i = 0; i < sprites.size(); ++i) {
+			const JesseRussell::Graphics::AtlasRegion& r = atlas.getRegion(i);
+			for (int32_t y = 0; y < r.height; ++y)
+				for (int32_t x = 0; x < r.width; ++x)
+					same = same && atlas.getSprite()->GetPixel(r.x + x, r.y + y) == sprites[i]->GetPixel(x, y);
+		}
+		const char* path = "raster_benchmark.atlas";
+		if (!atlas.save(path) || !loaded.load(path)) same = false;
+		std::remove(path);
+		same = same && loaded.getWidth() == atlas.getWidth() && loaded.getHeight() == atlas.getHeight() && loaded.getRegionCount() == atlas.getRegionCount() &&
+			std::memcmp(loaded.getSprite()->pColData, atlas.getSprite()->pColData, (size_t)atlas.getWidth() * atlas.getHeight() * sizeof(olc::Pixel)) == 0;
+
+		std::printf(" sprite atlas, MASK pixel mode:\n");
+		std::printf("  %zu sprites packed into %d x %d, %.0f%% used%s\n", sprites.size(), atlas.getWidth(), atlas.getHeight(),
+			100.0 * area / ((double)atlas.getWidth() * atlas.getHeight()), same ? "" : "  ATLAS DIFFERENT FROM ITS SPRITES");
+
+		std::vector<Shape> points = makeShapes(size, 1, 4000);
+		std::vector<JesseRussell::Graphics::AtlasDraw> draws;
+		double pixels = 0;
+		for (size_t i = 0; i < points.size(); ++i) {
+			uint32_t region = (uint32_t)(i * 7 % sprites.size());
+			draws.push_back({ region, points[i].x - 16, points[i].y - 16, (uint8_t)(i % 4) });
+			pixels += (double)sprites[region]->width * sprites[region]->height;
+		}
+		std::vector<Shape> whole = { { 0, 0, size, size } };
+		pge.SetPixelMode(olc::Pixel::MASK);
+		compare("DrawSprite each", pge, a, b, whole, pixels,
+			[&](const Shape&, olc::Pixel) { for (const auto& d : draws) pge.DrawSprite(d.x, d.y, sprites[d.region].get(), 1, d.flip); },
+			[&](const Shape&, olc::Pixel) { atlas.drawBatch(pge, draws.data(), draws.size()); });
+		pge.SetPixelMode(olc::Pixel::NORMAL);
+	}
+
+	// Character sprites, mostly transparent: a solid blob in the middle of each, with a few stray texels. MASK mode
+	// drawn by scanning every row's alpha (the blitter as it was), then from the sprites' cached opaque runs. Then
+	// SetPixel changes some texels, and the runs have to follow.
+	inline void masked(olc::PixelGameEngine& pge, olc::Sprite& a, olc::Sprite& b, int32_t size) {
+		std::vector<Shape> points = makeShapes(size, 1, 2000);
+		for (int32_t spriteSize : { 16, 48 }) {
+			olc::Sprite sprite(spriteSize, spriteSize);
+			fillSprite(sprite);
+			int32_t opaque = 0;
+			for (int32_t y = 0; y < spriteSize; ++y)
+				for (int32_t x = 0; x < spriteSize; ++x) {
+					int32_t dx = 2 * x - spriteSize, dy = 2 * y - spriteSize;
+					olc::Pixel& t = sprite.GetData()[y * spriteSize + x];
+					t.a = dx * dx * 4 + dy * dy * 2 < spriteSize * spriteSize || (x * 7 + y * 3) % 29 == 0 ? 255 : 0;
+					opaque += t.a == 255;
+				}
+
+			auto flipOf = [&](const Shape& s) { return (uint8_t)((&s - &points[0]) % 4); };
+			std::vector<olc::Pixel> scratch;
+			auto scanned = [&](const Shape& s, olc::Pixel) {
+				olc::Sprite* target = pge.GetDrawTarget();
+				olc::PixelGameEngine::olc_BlitRows(s.x - spriteSize / 2, s.y - spriteSize / 2, &sprite, 0, 0, spriteSize, spriteSize, 1, flipOf(s),
+					0, 0, target->width, target->height, scratch, [&](int32_t dx, int32_t dy, const olc::Pixel* row, int32_t count) {
+						olc::PixelGameEngine::olc_WriteRow(target->GetData() + dy * target->width + dx, row, count, olc::Pixel::MASK, 1.0f);
+					});
+			};
+			auto runs = [&](const Shape& s, olc::Pixel) { pge.DrawSprite(s.x - spriteSize / 2, s.y - spriteSize / 2, &sprite, 1, flipOf(s)); };
+
+			char name[32];
+			std::printf(" %dx%d character sprites, %d%% opaque, MASK pixel mode:\n", spriteSize, spriteSize, opaque * 100 / (spriteSize * spriteSize));
+			double pixels = (double)points.size() * spriteSize * spriteSize;
+			pge.SetPixelMode(olc::Pixel::MASK);
+			compare("opaque runs", pge, a, b, points, pixels, scanned, runs);
+			for (int32_t i = 0; i < spriteSize; ++i) {
+				sprite.SetPixel(i, spriteSize / 2, olc::BLANK);
+				sprite.SetPixel(i, i, olc::Pixel(255, 255, 255));
+			}
+			std::snprintf(name, sizeof(name), "after SetPixel");
+			compare(name, pge, a, b, points, pixels, scanned, runs);
+			pge.SetPixelMode(olc::Pixel::NORMAL);
+		}
+	}
+
+	// A debug overlay's worth of text, formatted every frame into a buffer: the old per texel DrawString against the glyph
+	// masks, monospaced and proportional, at scales 1 and 2. Opaque text must come out the same; translucent text is
+	// blended in float one way and in integers the other.
+	inline void text(olc::PixelGameEngine& pge, olc::Sprite& a, olc::Sprite& b, int32_t size) {
+		std::vector<Shape> lines = makeShapes(size, 1, 200);
+		auto format = [&](char* buffer, size_t length, const Shape& s) {
+			size_t i = (size_t)(&s - &lines[0]);
+			std::snprintf(buffer, length, "frame %6.2f ms %5.0f fps\nentities %zu", 16.0 + i * 0.01, 1000.0 / (16.0 + i * 0.01), i * 37);
+		};
+		for (olc::Pixel col : { olc::WHITE, olc::Pixel(255, 255, 0, 160) }) {
+			bool exact = col.a == 255;
+			std::printf(" text, %s:\n", exact ? "opaque" : "translucent");
+			for (uint32_t scale : { 1u, 2u })
+				for (bool proportional : { false, true }) {
+					char name[32];
+					std::snprintf(name, sizeof(name), "%s x%u", proportional ? "DrawStringProp" : "DrawString", scale);
+					// about a third of each glyph's 8 x 8 is lit.
+					double pixels = lines.size() * 32 * 22.0 * scale * scale;
+					compare(name, pge, a, b, lines, pixels,
+						[&](const Shape& s, olc::Pixel) { char buffer[64]; format(buffer, sizeof(buffer), s); PerPixel::drawString(pge, s.x - 64, s.y, buffer, col, scale, proportional); },
+						[&](const Shape& s, olc::Pixel) {
+							char buffer[64];
+							format(buffer, sizeof(buffer), s);
+							if (proportional) pge.DrawStringProp(s.x - 64, s.y, buffer, col, scale);
+							else pge.DrawString(s.x - 64, s.y, buffer, col, scale);
+						}, exact);
+				}
+		}
+	}
+
+	// A multiply blend, the sort of thing a custom pixel mode is for.
+	struct Multiply {
+		olc::Pixel operator()(const int, const int, const olc::Pixel& source, const olc::Pixel& dest) const {
+			return olc::Pixel((uint8_t)(source.r * dest.r / 255), (uint8_t)(source.g * dest.g / 255), (uint8_t)(source.b * dest.b / 255));
+		}
+	};
+
+	// Each shape drawn three ways: the old CUSTOM mode, then CUSTOM mode through the span path (still a std::function
+	// call per pixel), then the templated span shader.
+	inline void shaders(olc::PixelGameEngine& pge, olc::Sprite& a, olc::Sprite& b, int32_t size) {
+		Multiply multiply;
+		PerPixel::customMode() = multiply;
+		pge.SetPixelMode(PerPixel::customMode());
+		std::printf(" CUSTOM pixel mode (multiply), old -> std::function, old -> span shader:\n");
+
+		std::vector<Shape> shapes = makeShapes(size, 64, 1000);
+		double area = 0, linePixels = 0;
+		for (const Shape& s : shapes) {
+			area += (double)s.w * s.h;
+			linePixels += std::max(std::abs(s.w - 32), std::abs(s.h - 32)) + 1;
+		}
+		auto oldRect = [&](const Shape& s, olc::Pixel p) { PerPixel::fillRect(pge, s.x, s.y, s.w, s.h, p); };
+		compare("FillRect", pge, a, b, shapes, area, oldRect,
+			[&](const Shape& s, olc::Pixel p) { pge.FillRect(s.x, s.y, s.w, s.h, p); });
+		compare("FillRectShaded", pge, a, b, shapes, area, oldRect,
+			[&](const Shape& s, olc::Pixel p) { pge.FillRectShaded(s.x, s.y, s.w, s.h, p, multiply); });
+
+		// every direction, steep and shallow.
+		auto oldLine = [&](const Shape& s, olc::Pixel p) { PerPixel::drawLine(pge, s.x, s.y, s.x + s.w - 32, s.y + s.h - 32, p); };
+		compare("DrawLine", pge, a, b, shapes, linePixels, oldLine,
+			[&](const Shape& s, olc::Pixel p) { pge.DrawLine(s.x, s.y, s.x + s.w - 32, s.y + s.h - 32, p); });
+		compare("DrawLineShaded", pge, a, b, shapes, linePixels, oldLine,
+			[&](const Shape& s, olc::Pixel p) { pge.DrawLineShaded(s.x, s.y, s.x + s.w - 32, s.y + s.h - 32, p, multiply); });
+
+		olc::Sprite sprite(64, 64);
+		fillSprite(sprite);
+		std::vector<Shape> points = makeShapes(size, 1, 200);
+		for (uint32_t scale : { 1u, 2u }) {
+			int32_t drawn = 64 * (int32_t)scale;
+			auto flipOf = [&](const Shape& s) { return (uint8_t)((&s - &points[0]) % 4); };
+			auto oldSprite = [&](const Shape& s, olc::Pixel) { PerPixel::drawSprite(pge, s.x - drawn / 2, s.y - drawn / 2, &sprite, scale, flipOf(s)); };
+			char name[32];
+			std::snprintf(name, sizeof(name), "DrawSprite x%u", scale);
+			compare(name, pge, a, b, points, (double)points.size() * drawn * drawn, oldSprite,
+				[&](const Shape& s, olc::Pixel) { pge.DrawSprite(s.x - drawn / 2, s.y - drawn / 2, &sprite, scale, flipOf(s)); });
+			std::snprintf(name, sizeof(name), "DrawSpriteShaded x%u", scale);
+			compare(name, pge, a, b, points, (double)points.size() * drawn * drawn, oldSprite,
+				[&](const Shape& s, olc::Pixel) { pge.DrawSpriteShaded(s.x - drawn / 2, s.y - drawn / 2, &sprite, multiply, scale, flipOf(s)); });
+		}
+		pge.SetPixelMode(olc::Pixel::NORMAL);
+	}
+
+	inline int run(int32_t size) {
+		if (size < 16) size = 16;
+		// The engine isn't started, it's only used for its drawing routines.
+		olc::PixelGameEngine pge;
+		olc::Sprite a(size, size), b(size, size);
+		failures() = 0;
+		std::printf("%d x %d target\n", size, size);
+
+		std::vector<Shape> whole = { { 0, 0, size, size } };
+		std::printf(" NORMAL pixel mode:\n");
+		compare("Clear", pge, a, b, whole, (double)size * size,
+			[&](const Shape&, olc::Pixel p) { PerPixel::clear(pge, p); },
+			[&](const Shape&, olc::Pixel p) { pge.Clear(p); });
+
+		for (int32_t shapeSize : { 8, 64, 256 }) {
+			std::vector<Shape> shapes = makeShapes(size, shapeSize, 1000);
+			double area = 0, outline = 0, spans = 0;
+			for (const Shape& s : shapes) {
+				area += (double)s.w * s.h;
+				outline += 2.0 * (s.w + 1) + 2.0 * (s.h + 1);
+				spans += s.w + 1;
+			}
+
+			std::printf(" shapes up to %d pixels across:\n", shapeSize);
+			compare("FillRect", pge, a, b, shapes, area,
+				[&](const Shape& s, olc::Pixel p) { PerPixel::fillRect(pge, s.x, s.y, s.w, s.h, p); },
+				[&](const Shape& s, olc::Pixel p) { pge.FillRect(s.x, s.y, s.w, s.h, p); });
+			compare("DrawRect", pge, a, b, shapes, outline,
+				[&](const Shape& s, olc::Pixel p) { PerPixel::drawRect(pge, s.x, s.y, s.w, s.h, p); },
+				[&](const Shape& s, olc::Pixel p) { pge.DrawRect(s.x, s.y, s.w, s.h, p); });
+			compare("horizontal", pge, a, b, shapes, spans,
+				[&](const Shape& s, olc::Pixel p) { PerPixel::drawLine(pge, s.x, s.y, s.x + s.w, s.y, p); },
+				[&](const Shape& s, olc::Pixel p) { pge.DrawLine(s.x, s.y, s.x + s.w, s.y, p); });
+			compare("vertical", pge, a, b, shapes, spans,
+				[&](const Shape& s, olc::Pixel p) { PerPixel::drawLine(pge, s.x, s.y, s.x, s.y + s.w, p); },
+				[&](const Shape& s, olc::Pixel p) { pge.DrawLine(s.x, s.y, s.x, s.y + s.w, p); });
+		}
+
+		std::printf(" sprites (DrawSprite):\n");
+		sprites(pge, a, b, size);
+		alpha(pge, a, b, size);
+		primitives(pge, a, b, size);
+		shaders(pge, a, b, size);
+		drawList(pge, a, b, size);
+		atlas(pge, a, b, size);
+		masked(pge, a, b, size);
+		text(pge, a, b, size);
+		tiled(pge);
+		if (failures() != 0) std::printf("%d check%s FAILED\n", failures(), failures() == 1 ? "" : "s");
+		return failures() != 0 ? 1 : 0;
+	}
+}
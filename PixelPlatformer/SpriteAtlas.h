@@ -0,0 +1,361 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+
+#include<algorithm>
+#include<cstdint>
+#include<cstring>
+#include<fstream>
+#include<string>
+#include<vector>
+
+namespace JesseRussell {
+	namespace Graphics {
+		// o--------------o
+		// | Atlas format |
+		// o--------------o
+
+		// An atlas file is:
+		//   AtlasHeader
+		//   AtlasRegion[regionCount]
+		//   the atlas's pixels, width * height olc::Pixels, row by row.
+		//
+		// Like level files, everything is stored as it's laid out in memory, in the byte order of the machine that wrote
+		// it. Changing a record's layout means bumping atlasFileVersion.
+		const uint32_t atlasFileVersion = 1;
+		const uint32_t atlasFileByteOrder = 0x01020304;
+
+		struct AtlasHeader {
+			char magic[4];
+			uint32_t version;
+			uint32_t byteOrder;
+			uint32_t regionCount;
+			int32_t width, height;
+		};
+
+		// Where a sprite ended up in the atlas.
+		struct AtlasRegion {
+			int32_t x, y;
+			int32_t width, height;
+		};
+
+		// One sprite to draw from an atlas. region is the handle the builder gave it.
+		struct AtlasDraw {
+			uint32_t region;
+			int32_t x, y;
+			uint8_t flip;
+		};
+
+
+
+		// o-------------o
+		// | SpriteAtlas |
+		// o-------------o
+
+		// Lots of small sprites packed into one big one, so drawing them reads from one block of memory instead of a
+		// separate allocation per sprite. Made by a SpriteAtlasBuilder, or loaded from a file one saved, so the packing can
+		// be done offline.
+		class SpriteAtlas {
+		public: // Constructors:
+			SpriteAtlas() = default;
+
+			SpriteAtlas(const SpriteAtlas&) = delete;
+			SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+		public: // Properties:
+			// To draw from or read. Changing its texels would leave drawBatch's opaque runs out of date.
+			olc::Sprite* getSprite() { return &sprite; }
+			const olc::Sprite* getSprite() const { return &sprite; }
+			int32_t getWidth() const { return sprite.width; }
+			int32_t getHeight() const { return sprite.height; }
+
+			size_t getRegionCount() const { return regions.size(); }
+			const AtlasRegion& getRegion(uint32_t handle) const { return regions[handle]; }
+
+			// Why the last load failed.
+			const std::string& getError() const { return error; }
+
+		public: // Methods:
+			// Draws a region the way DrawPartialSprite would.
+			void draw(olc::PixelGameEngine& pge, uint32_t handle, int32_t x, int32_t y, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE) {
+				const AtlasRegion& r = regions[handle];
+				pge.DrawPartialSprite(x, y, &sprite, r.x, r.y, r.width, r.height, scale, flip);
+			}
+
+			// Draws each of draws in order, the same as calling draw for each of them, but in one pass: the pixel mode is
+			// looked at once, and every row goes straight from the atlas to the draw target.
+			void drawBatch(olc::PixelGameEngine& pge, const AtlasDraw* draws, size_t count, uint32_t scale = 1) {
+				olc::Sprite* target = pge.GetDrawTarget();
+				olc::Pixel::Mode mode = pge.GetPixelMode();
+				if (target == nullptr || mode == olc::Pixel::CUSTOM) {
+					for (size_t i = 0; i < count; ++i) draw(pge, draws[i].region, draws[i].x, draws[i].y, scale, draws[i].flip);
+					return;
+				}
+
+				using Engine = olc::PixelGameEngine;
+				float blend = pge.GetPixelBlend();
+				int32_t s = (int32_t)std::max(scale, 1u);
+				olc::Pixel* data = target->GetData();
+				const int32_t width = target->width;
+				for (size_t i = 0; i < count; ++i) {
+					const AtlasDraw& d = draws[i];
+					const AtlasRegion& r = regions[d.region];
+					if (mode == olc::Pixel::MASK && s == 1) {
+						Engine::olc_BlitOpaqueRuns(target, d.x, d.y, sprite.pColData + r.y * sprite.width + r.x, sprite.width, runs.data(), runRows.data() + regionRows[d.region],
+							0, 0, r.width, r.height, d.flip, 0, 0, width, target->height);
+						continue;
+					}
+					Engine::olc_BlitRows(d.x, d.y, &sprite, r.x, r.y, r.width, r.height, s, d.flip, 0, 0, width, target->height, scratch,
+						[&](int32_t dx, int32_t dy, const olc::Pixel* row, int32_t n) {
+							Engine::olc_WriteRow(data + dy * width + dx, row, n, mode, blend);
+						});
+				}
+			}
+
+			// Returns false if the file couldn't be written.
+			bool save(const std::string& path) const {
+				AtlasHeader header;
+				std::memcpy(header.magic, "PPAT", 4);
+				header.version = atlasFileVersion;
+				header.byteOrder = atlasFileByteOrder;
+				header.regionCount = (uint32_t)regions.size();
+				header.width = sprite.width;
+				header.height = sprite.height;
+
+				std::ofstream file(path, std::ios::binary | std::ios::trunc);
+				if (!file) return false;
+				file.write((const char*)&header, sizeof(header));
+				file.write((const char*)regions.data(), (std::streamsize)(regions.size() * sizeof(AtlasRegion)));
+				file.write((const char*)sprite.pColData, (std::streamsize)((size_t)sprite.width * sprite.height * sizeof(olc::Pixel)));
+				return (bool)file;
+			}
+
+			// Returns false, and leaves the atlas as it was, if the file can't be read or isn't an atlas this version can
+			// read.
+			bool load(const std::string& path) {
+				std::ifstream file(path, std::ios::binary);
+				if (!file) return fail("can't open " + path);
+				AtlasHeader header;
+				if (!file.read((char*)&header, sizeof(header))) return fail("too small to be an atlas file");
+				if (std::memcmp(header.magic, "PPAT", 4) != 0) return fail("not an atlas file");
+				if (header.byteOrder != atlasFileByteOrder) return fail("written on a machine with a different byte order");
+				if (header.version != atlasFileVersion) return fail("unsupported version " + std::to_string(header.version));
+				if (header.width < 0 || header.height < 0 || (uint64_t)header.width * (uint64_t)header.height > (1u << 28))
+					return fail("bad size");
+				// the counts come from the file, so they're checked against what's left of it before anything is allocated.
+				std::streamoff start = file.tellg();
+				if (!file.seekg(0, std::ios::end)) return fail("can't read " + path);
+				uint64_t left = (uint64_t)(file.tellg() - start);
+				file.seekg(start);
+				if ((uint64_t)header.regionCount * sizeof(AtlasRegion) + (uint64_t)header.width * header.height * sizeof(olc::Pixel) > left)
+					return fail("truncated");
+
+				std::vector<AtlasRegion> loaded(header.regionCount);
+				std::vector<olc::Pixel> pixels((size_t)header.width * header.height);
+				if (!file.read((char*)loaded.data(), (std::streamsize)(loaded.size() * sizeof(AtlasRegion))) ||
+					!file.read((char*)pixels.data(), (std::streamsize)(pixels.size() * sizeof(olc::Pixel))))
+					return fail("truncated");
+				for (size_t i = 0; i < loaded.size(); ++i) {
+					const AtlasRegion& r = loaded[i];
+					if (r.x < 0 || r.y < 0 || r.width < 0 || r.height < 0 ||
+						(int64_t)r.x + r.width > header.width || (int64_t)r.y + r.height > header.height)
+						return fail("region " + std::to_string(i) + " isn't inside the atlas");
+				}
+
+				resize(header.width, header.height);
+				std::copy(pixels.begin(), pixels.end(), sprite.pColData);
+				regions = std::move(loaded);
+				findOpaqueRuns();
+				return true;
+			}
+
+		private:
+			friend class SpriteAtlasBuilder;
+
+			bool fail(const std::string& message) {
+				error = message;
+				return false;
+			}
+
+			// Contents are left undefined.
+			void resize(int32_t width, int32_t height) {
+				delete[] sprite.pColData;
+				sprite.width = width;
+				sprite.height = height;
+				sprite.pColData = new olc::Pixel[(size_t)width * height];
+				sprite.InvalidateOpaqueRuns();
+			}
+
+			// Each region's opaque runs, for drawing it in MASK mode. A region's own rather than the atlas's, so a row
+			// of a region doesn't start with a search through the runs of every region to its left.
+			void findOpaqueRuns() {
+				runs.clear();
+				runRows.clear();
+				regionRows.clear();
+				for (const AtlasRegion& r : regions) {
+					regionRows.push_back((uint32_t)runRows.size());
+					for (int32_t y = 0; y < r.height; ++y) {
+						runRows.push_back((uint32_t)runs.size());
+						const olc::Pixel* row = sprite.pColData + (r.y + y) * sprite.width + r.x;
+						for (int32_t x = 0; x < r.width;) {
+							while (x < r.width && row[x].a != 255) ++x;
+							int32_t start = x;
+							while (x < r.width && row[x].a == 255) ++x;
+							if (x > start) runs.push_back({ start, x - start });
+						}
+					}
+					runRows.push_back((uint32_t)runs.size());
+				}
+			}
+
+		private: // Fields:
+			olc::Sprite sprite;
+			std::vector<AtlasRegion> regions; // indexed by handle.
+			std::vector<olc::Sprite::OpaqueRun> runs;
+			std::vector<uint32_t> runRows;    // GetOpaqueRuns's rows, height + 1 of them per region.
+			std::vector<uint32_t> regionRows; // where each region's are in runRows.
+			std::vector<olc::Pixel> scratch;  // rows of scaled or flipped regions.
+			std::string error;
+		};
+
+
+
+		// o--------------------o
+		// | SpriteAtlasBuilder |
+		// o--------------------o
+
+		// Packs sprites into a SpriteAtlas with a skyline packer: the atlas has a fixed width, the tops of everything placed
+		// so far are kept as a list of flat segments, and each sprite, tallest first, goes wherever its top would end up
+		// lowest. That wastes little on sprites of mixed sizes and is quick enough to run at load time, though it's meant
+		// to be run offline and the atlas saved.
+		class SpriteAtlasBuilder {
+		public: // Properties:
+			// Empty pixels kept around each sprite, so nothing bleeds into its neighbours when the atlas is scaled as a
+			// decal. Not needed for drawing it as a sprite.
+			void setPadding(int32_t value) { padding = std::max(value, 0); }
+			// 0 picks the smallest power of two that should fit everything, or the widest sprite if that's wider.
+			void setWidth(int32_t value) { width = std::max(value, 0); }
+
+			size_t getSpriteCount() const { return sources.size(); }
+
+		public: // Methods:
+			// Adds the w by h part of sprite at (ox, oy), or all of it. Returns its handle in the atlas. The sprite is only
+			// read by build, so it has to stay alive until then.
+			uint32_t add(const olc::Sprite* sprite) { return add(sprite, 0, 0, sprite->width, sprite->height); }
+
+			uint32_t add(const olc::Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h) {
+				sources.push_back({ sprite, ox, oy, std::max(w, 0), std::max(h, 0) });
+				return (uint32_t)(sources.size() - 1);
+			}
+
+			// Packs and copies every sprite added into atlas, replacing whatever it had.
+			void build(SpriteAtlas& atlas) const {
+				int64_t area = 0;
+				int32_t widest = 1;
+				for (const Source& source : sources) {
+					area += (int64_t)(source.w + padding) * (source.h + padding);
+					widest = std::max(widest, source.w + padding);
+				}
+				int32_t atlasWidth = width;
+				if (atlasWidth == 0) {
+					atlasWidth = 1;
+					while ((int64_t)atlasWidth * atlasWidth < area) atlasWidth *= 2;
+				}
+				atlasWidth = std::max(atlasWidth, widest);
+
+				// tallest first, then widest.
+				std::vector<uint32_t> order(sources.size());
+				for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+				std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+					if (sources[a].h != sources[b].h) return sources[a].h > sources[b].h;
+					if (sources[a].w != sources[b].w) return sources[a].w > sources[b].w;
+					return a < b;
+				});
+
+				std::vector<AtlasRegion> regions(sources.size());
+				std::vector<Segment> skyline = { { 0, 0, atlasWidth } };
+				int32_t atlasHeight = 0;
+				for (uint32_t index : order) {
+					const Source& source = sources[index];
+					if (source.w == 0 || source.h == 0) {
+						regions[index] = { 0, 0, source.w, source.h };
+						continue;
+					}
+					int32_t w = source.w + padding, h = source.h + padding;
+					int32_t x, y;
+					place(skyline, w, h, x, y);
+					regions[index] = { x, y, source.w, source.h };
+					atlasHeight = std::max(atlasHeight, y + h);
+				}
+
+				atlas.resize(atlasWidth, atlasHeight);
+				std::fill(atlas.sprite.pColData, atlas.sprite.pColData + (size_t)atlasWidth * atlasHeight, olc::BLANK);
+				for (size_t k = 0; k < sources.size(); ++k) {
+					const Source& source = sources[k];
+					const AtlasRegion& r = regions[k];
+					for (int32_t j = 0; j < r.height; ++j)
+						for (int32_t i = 0; i < r.width; ++i)
+							atlas.sprite.pColData[(size_t)(r.y + j) * atlasWidth + r.x + i] = source.sprite->GetPixel(source.ox + i, source.oy + j);
+				}
+				atlas.regions = std::move(regions);
+				atlas.findOpaqueRuns();
+			}
+
+		private: // types:
+			struct Source {
+				const olc::Sprite* sprite;
+				int32_t ox, oy, w, h;
+			};
+
+			// A flat part of the skyline: everything under y from x to x + width is taken.
+			struct Segment {
+				int32_t x, y, width;
+			};
+
+		private:
+			// Finds where a w by h rectangle's top would be lowest (leftmost of those), and raises the skyline over it.
+			static void place(std::vector<Segment>& skyline, int32_t w, int32_t h, int32_t& bestX, int32_t& bestY) {
+				size_t best = skyline.size();
+				bestX = 0;
+				bestY = INT32_MAX;
+				for (size_t i = 0; i < skyline.size(); ++i) {
+					int32_t x = skyline[i].x;
+					if (x + w > skyline.back().x + skyline.back().width) break;
+					// it rests on the highest segment it spans.
+					int32_t y = 0;
+					for (size_t j = i; j < skyline.size() && skyline[j].x < x + w; ++j) y = std::max(y, skyline[j].y);
+					if (y < bestY) {
+						best = i;
+						bestX = x;
+						bestY = y;
+					}
+				}
+
+				// the new segment replaces everything under it, cutting the last one it covers partly.
+				Segment top = { bestX, bestY + h, w };
+				size_t end = best;
+				while (end < skyline.size() && skyline[end].x + skyline[end].width <= bestX + w) ++end;
+				if (end < skyline.size() && skyline[end].x < bestX + w) {
+					skyline[end].width -= bestX + w - skyline[end].x;
+					skyline[end].x = bestX + w;
+				}
+				skyline.erase(skyline.begin() + best, skyline.begin() + end);
+				skyline.insert(skyline.begin() + best, top);
+
+				// neighbours at the same height become one.
+				if (best + 1 < skyline.size() && skyline[best + 1].y == top.y) {
+					skyline[best].width += skyline[best + 1].width;
+					skyline.erase(skyline.begin() + best + 1);
+				}
+				if (best > 0 && skyline[best - 1].y == top.y) {
+					skyline[best - 1].width += skyline[best].width;
+					skyline.erase(skyline.begin() + best);
+				}
+			}
+
+		private: // Fields:
+			int32_t padding = 0;
+			int32_t width = 0;
+			std::vector<Source> sources;
+		};
+	}
+}
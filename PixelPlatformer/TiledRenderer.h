@@ -0,0 +1,238 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+#include "JobSystem.h"
+
+#include<algorithm>
+#include<climits>
+#include<cstdint>
+#include<initializer_list>
+#include<thread>
+#include<vector>
+
+namespace JesseRussell {
+	namespace Graphics {
+		// o---------------o
+		// | TiledRenderer |
+		// o---------------o
+
+		// Records draw calls instead of drawing them, then draws them all at once on every thread of a JobSystem. The
+		// target is cut into bands of whole rows, each command is binned into the bands it touches, and each band
+		// replays its commands in the order they were recorded, clipped to itself. Only the thread drawing a band writes
+		// to it, and each pixel gets the same draws in the same order as drawing them one after another would give it,
+		// through the engine's own span rasterizers and kernels. So the result is the same to the pixel, overlapping
+		// ALPHA draws included.
+		//
+		// Bands rather than square tiles: every rasterizer produces horizontal spans, so clipping to a band only ever
+		// drops whole spans, and a band is one block of memory.
+		//
+		// The commands mirror the engine's drawing routines, in pixel modes NORMAL, MASK and ALPHA (custom modes can't
+		// be recorded, they'd be called from several threads at once). Lines are solid. Sprites are read while
+		// executing, so they have to stay alive and unchanged until then.
+		class TiledRenderer {
+		public: // Constructors:
+			explicit TiledRenderer(Threading::JobSystem& jobs) : jobs(jobs), scratch(jobs.getThreadCount() + 1) {}
+
+		public: // Properties:
+			// Rows per band. Smaller bands share the work out more evenly, bigger ones repeat less of each command's setup
+			// (a line or circle is walked in full by every band it touches).
+			int32_t getBandHeight() const { return bandHeight; }
+			void setBandHeight(int32_t value) { bandHeight = std::max(value, 1); }
+
+			size_t getCommandCount() const { return commands.size(); }
+
+			// Like the engine's, these apply to the commands recorded after them. CUSTOM is treated as NORMAL.
+			void setPixelMode(olc::Pixel::Mode value) { mode = value == olc::Pixel::CUSTOM ? olc::Pixel::NORMAL : value; }
+			void setPixelBlend(float value) { blend = std::min(std::max(value, 0.0f), 1.0f); }
+
+		public: // recording:
+			void clear(olc::Pixel p) {
+				add(Command::CLEAR, INT32_MIN, INT32_MAX, p);
+			}
+
+			void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, olc::Pixel p) {
+				add(Command::FILL_RECT, y, y + h, p, { x, y, w, h });
+			}
+
+			// The same four lines the engine's DrawRect draws.
+			void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, olc::Pixel p) {
+				drawLine(x, y, x + w, y, p);
+				drawLine(x + w, y, x + w, y + h, p);
+				drawLine(x + w, y + h, x, y + h, p);
+				drawLine(x, y + h, x, y, p);
+			}
+
+			void drawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, olc::Pixel p) {
+				add(Command::LINE, std::min(y1, y2), std::max(y1, y2) + 1, p, { x1, y1, x2, y2 });
+			}
+
+			void drawCircle(int32_t x, int32_t y, int32_t radius, olc::Pixel p, uint8_t mask = 0xFF) {
+				if (radius < 0) return;
+				add(Command::CIRCLE, y - radius, y + radius + 1, p, { x, y, radius }).flags = mask;
+			}
+
+			void fillCircle(int32_t x, int32_t y, int32_t radius, olc::Pixel p) {
+				if (radius < 0) return;
+				add(Command::FILL_CIRCLE, y - radius, y + radius + 1, p, { x, y, radius });
+			}
+
+			void fillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, olc::Pixel p) {
+				add(Command::FILL_TRIANGLE, std::min({ y1, y2, y3 }), std::max({ y1, y2, y3 }) + 1, p, { x1, y1, x2, y2, x3, y3 });
+			}
+
+			void drawSprite(int32_t x, int32_t y, olc::Sprite* sprite, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE) {
+				if (sprite == nullptr) return;
+				drawPartialSprite(x, y, sprite, 0, 0, sprite->width, sprite->height, scale, flip);
+			}
+
+			void drawPartialSprite(int32_t x, int32_t y, olc::Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE) {
+				if (sprite == nullptr) return;
+				int32_t s = (int32_t)std::max(scale, 1u);
+				Command& command = add(Command::SPRITE, y, y + h * s, olc::BLANK, { x, y, ox, oy, w, h });
+				command.sprite = sprite;
+				command.scale = s;
+				command.flags = flip;
+			}
+
+		public: // Methods:
+			// Draws everything recorded onto target, then forgets it. Returns once it's all drawn.
+			void execute(olc::Sprite* target) {
+				if (target == nullptr || target->width <= 0 || target->height <= 0) {
+					commands.clear();
+					return;
+				}
+
+				size_t bandCount = (size_t)((target->height + bandHeight - 1) / bandHeight);
+				if (bins.size() < bandCount) bins.resize(bandCount);
+				for (size_t band = 0; band < bandCount; ++band) bins[band].clear();
+				for (size_t i = 0; i < commands.size(); ++i) {
+					const Command& command = commands[i];
+					int32_t top = std::max(command.top, 0), bottom = std::min(command.bottom, target->height);
+					if (top >= bottom) continue;
+					for (int32_t band = top / bandHeight; band <= (bottom - 1) / bandHeight; ++band)
+						bins[band].push_back((uint32_t)i);
+				}
+
+				target->InvalidateOpaqueRuns();
+				// Every thread that isn't a worker counts as thread 0, and another one (a PhysicsThread stepping an engine
+				// on the same JobSystem, say) may help out with these bands while it waits. So the thread calling execute
+				// gets the extra slot at the end to itself.
+				std::thread::id caller = std::this_thread::get_id();
+				jobs.parallel_for(0, bandCount, 1, [&](size_t begin, size_t end) {
+					size_t slot = std::this_thread::get_id() == caller ? scratch.size() - 1 : jobs.getCurrentThreadIndex();
+					std::vector<olc::Pixel>& rowScratch = scratch[slot];
+					for (size_t band = begin; band < end; ++band) {
+						int32_t top = (int32_t)band * bandHeight;
+						drawBand(*target, top, std::min(top + bandHeight, target->height), bins[band], rowScratch);
+					}
+				});
+				commands.clear();
+			}
+
+		private: // types:
+			struct Command {
+				enum Type : uint8_t { CLEAR, FILL_RECT, LINE, CIRCLE, FILL_CIRCLE, FILL_TRIANGLE, SPRITE };
+				Type type;
+				olc::Pixel::Mode mode;
+				uint8_t flags;  // circle mask, sprite flip.
+				float blend;
+				olc::Pixel colour;
+				int32_t v[6];   // coordinates, as the engine's routine takes them.
+				olc::Sprite* sprite;
+				int32_t scale;
+				int32_t top, bottom; // rows it can touch, [top, bottom).
+			};
+
+		private:
+			Command& add(Command::Type type, int32_t top, int32_t bottom, olc::Pixel colour, std::initializer_list<int32_t> v = {}) {
+				Command command = {};
+				command.type = type;
+				command.mode = mode;
+				command.blend = blend;
+				command.colour = colour;
+				std::copy(v.begin(), v.end(), command.v);
+				command.top = top;
+				command.bottom = bottom;
+				commands.push_back(command);
+				return commands.back();
+			}
+
+			// Replays commands on rows [top, bottom) of target, in the same way the engine's routines draw them.
+			void drawBand(olc::Sprite& target, int32_t top, int32_t bottom, const std::vector<uint32_t>& bin, std::vector<olc::Pixel>& rowScratch) const {
+				using Engine = olc::PixelGameEngine;
+				const int32_t width = target.width;
+				// not GetData, which would invalidate target's opaque runs from every band's thread at once. execute does
+				// that once, up front.
+				olc::Pixel* data = target.pColData;
+
+				for (uint32_t index : bin) {
+					const Command& c = commands[index];
+					const int32_t* v = c.v;
+					auto span = [&](int32_t x, int32_t y, int32_t count) {
+						if (y < top || y >= bottom) return;
+						int32_t x2 = std::min(x + count, width);
+						x = std::max(x, 0);
+						if (x2 > x) Engine::olc_WriteSpan(data + y * width + x, x2 - x, c.colour, c.mode, c.blend);
+					};
+
+					switch (c.type) {
+					case Command::CLEAR:
+						Engine::olc_FillSpan(data + top * width, (bottom - top) * width, c.colour);
+						break;
+					case Command::FILL_RECT:
+						for (int32_t y = std::max(v[1], top); y < std::min(v[1] + v[3], bottom); ++y) span(v[0], y, v[2]);
+						break;
+					case Command::LINE:
+						Engine::olc_LineSpans(v[0], v[1], v[2], v[3], span);
+						break;
+					case Command::CIRCLE:
+						Engine::olc_CircleSpans(v[0], v[1], v[2], c.flags, span);
+						break;
+					case Command::FILL_CIRCLE:
+						Engine::olc_FillCircleSpans(v[0], v[1], v[2], span);
+						break;
+					case Command::FILL_TRIANGLE:
+						Engine::olc_FillTriangleSpans(v[0], v[1], v[2], v[3], v[4], v[5], span);
+						break;
+					case Command::SPRITE:
+						drawSprite(c, data, width, top, bottom, rowScratch);
+						break;
+					}
+				}
+			}
+
+			static void drawSprite(const Command& c, olc::Pixel* data, int32_t width, int32_t top, int32_t bottom, std::vector<olc::Pixel>& rowScratch) {
+				using Engine = olc::PixelGameEngine;
+				int32_t x = c.v[0], y = c.v[1], ox = c.v[2], oy = c.v[3], w = c.v[4], h = c.v[5];
+				const olc::Sprite& sprite = *c.sprite;
+				if (ox >= 0 && oy >= 0 && ox + w <= sprite.width && oy + h <= sprite.height) {
+					Engine::olc_BlitRows(x, y, c.sprite, ox, oy, w, h, c.scale, c.flags, 0, top, width, bottom, rowScratch,
+						[&](int32_t dx, int32_t dy, const olc::Pixel* row, int32_t count) {
+							Engine::olc_WriteRow(data + dy * width + dx, row, count, c.mode, c.blend);
+						});
+					return;
+				}
+
+				// Source hanging off the sprite: texel by texel through GetPixel, as the engine does.
+				bool flipX = (c.flags & olc::Sprite::Flip::HORIZ) != 0, flipY = (c.flags & olc::Sprite::Flip::VERT) != 0;
+				for (int32_t dy = std::max(y, top); dy < std::min(y + h * c.scale, bottom); ++dy) {
+					int32_t j = (dy - y) / c.scale;
+					for (int32_t dx = std::max(x, 0); dx < std::min(x + w * c.scale, width); ++dx) {
+						int32_t i = (dx - x) / c.scale;
+						olc::Pixel texel = sprite.GetPixel(ox + (flipX ? w - 1 - i : i), oy + (flipY ? h - 1 - j : j));
+						Engine::olc_WriteRow(data + dy * width + dx, &texel, 1, c.mode, c.blend);
+					}
+				}
+			}
+
+		private: // Fields:
+			Threading::JobSystem& jobs;
+			int32_t bandHeight = 32;
+			olc::Pixel::Mode mode = olc::Pixel::NORMAL;
+			float blend = 1.0f;
+
+			std::vector<Command> commands;
+			std::vector<std::vector<uint32_t>> bins; // command indices per band.
+			std::vector<std::vector<olc::Pixel>> scratch; // rows of scaled or flipped sprites, per thread, plus one for the caller of execute.
+		};
+	}
+}
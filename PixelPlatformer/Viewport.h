@@ -0,0 +1,162 @@
+#pragma once
+
+#include "PlatformPhysics.h"
+
+#include<cstdint>
+#include<unordered_map>
+#include<vector>
+
+namespace phy {
+	// o--------o
+	// | Camera |
+	// o--------o
+
+	// The part of the world that's on screen. position is the world position of the screen's top left corner.
+	struct Camera {
+		vector2 position = { 0, 0 };
+		vector2 size = { 0, 0 };
+
+		CollisionBox getView() const { return CollisionBox(position, Box(size)); }
+
+		vector2 toScreen(const vector2& world) const { return world - position; }
+		vector2 toWorld(const vector2& screen) const { return screen + position; }
+
+		// Moves as little as possible to keep target at least margin away from every edge of the screen.
+		void follow(const vector2& targetPosition, const vector2& targetSize, const scalar& margin) {
+			if (targetPosition.x - margin < position.x) position.x = targetPosition.x - margin;
+			else if (targetPosition.x + targetSize.x + margin > position.x + size.x) position.x = targetPosition.x + targetSize.x + margin - size.x;
+
+			if (targetPosition.y - margin < position.y) position.y = targetPosition.y - margin;
+			else if (targetPosition.y + targetSize.y + margin > position.y + size.y) position.y = targetPosition.y + targetSize.y + margin - size.y;
+		}
+	};
+
+
+
+	// o------------o
+	// | RenderGrid |
+	// o------------o
+
+	// Answers "which entities are in this rectangle" for drawing, so draw cost follows what's on screen rather than how
+	// big the level is.
+	//
+	// Static entities are bucketed into a uniform grid, rebuilt only when the engine's entity list changes. Dynamic
+	// entities move every step, and there are normally few of them, so they're just tested one by one.
+	class RenderGrid {
+	public: // Constructors:
+		explicit RenderGrid(scalar cellSize = 128) : cellSize(cellSize) {}
+
+	public: // Properties:
+		size_t getStaticCount() const { return statics.size(); }
+		size_t getDynamicCount() const { return dynamics.size(); }
+
+	public: // Methods:
+		// Call once per frame before querying. Cheap unless entities were added or removed since the last call.
+		void update(const Engine& engine) {
+			if (engine.entities_getVersion() == engineVersion) return;
+			engineVersion = engine.entities_getVersion();
+
+			for (auto& cell : cells) cell.second.clear();
+			statics.clear();
+			dynamics.clear();
+			large.clear();
+
+			for (auto iter = engine.entities_cbegin(); iter != engine.entities_cend(); ++iter) {
+				Entity* e = *iter;
+				if (e->isDynamic()) {
+					dynamics.push_back(e);
+					continue;
+				}
+
+				size_t index = statics.size();
+				statics.push_back({ e, 0 });
+
+				int32_t x1 = cellOf(e->getX1()), x2 = cellOf(e->getX2());
+				int32_t y1 = cellOf(e->getY1()), y2 = cellOf(e->getY2());
+				// Something covering a huge number of cells would cost more to bucket than to test.
+				if ((int64_t)(x2 - x1 + 1) * (y2 - y1 + 1) > maxCellsPerEntity) {
+					large.push_back(index);
+					continue;
+				}
+				for (int32_t y = y1; y <= y2; ++y)
+					for (int32_t x = x1; x <= x2; ++x)
+						cells[key(x, y)].push_back(index);
+			}
+
+			// Cells still in use keep their storage, but ones left behind (a streaming world unloads regions all the
+			// time) are dropped, so the map grows with what's loaded rather than with everywhere that ever was.
+			for (auto cell = cells.begin(); cell != cells.end();) {
+				if (cell->second.empty()) cell = cells.erase(cell);
+				else ++cell;
+			}
+		}
+
+		// Calls action(entity) once for every entity that intersects view.
+		template<typename Action>
+		void query(const CollisionBox& view, Action action) {
+			queryStatic(view, action);
+			queryDynamic(view, action);
+		}
+
+		// Only the static entities, for drawing them somewhere they're kept between frames.
+		template<typename Action>
+		void queryStatic(const CollisionBox& view, Action action) {
+			++queryNumber;
+
+			int32_t x1 = cellOf(view.getX1()), x2 = cellOf(view.getX2());
+			int32_t y1 = cellOf(view.getY1()), y2 = cellOf(view.getY2());
+			for (int32_t y = y1; y <= y2; ++y) {
+				for (int32_t x = x1; x <= x2; ++x) {
+					auto cell = cells.find(key(x, y));
+					if (cell == cells.end()) continue;
+					for (size_t index : cell->second)
+						visit(index, view, action);
+				}
+			}
+
+			for (size_t index : large)
+				visit(index, view, action);
+		}
+
+		template<typename Action>
+		void queryDynamic(const CollisionBox& view, Action action) {
+			for (Entity* e : dynamics)
+				if (e->intersects(view)) action(*e);
+		}
+
+	private:
+		struct Item {
+			Entity* entity;
+			size_t lastQuery; // entities spanning several cells are only reported once per query.
+		};
+
+		template<typename Action>
+		void visit(size_t index, const CollisionBox& view, Action& action) {
+			Item& item = statics[index];
+			if (item.lastQuery == queryNumber) return;
+			item.lastQuery = queryNumber;
+			if (item.entity->intersects(view)) action(*item.entity);
+		}
+
+		int32_t cellOf(const scalar& coordinate) const {
+			// floor, not truncation, so cell -1 doesn't get twice the width of the others.
+			int32_t cell = (int32_t)(coordinate / cellSize);
+			if (coordinate < scalar(cell) * cellSize) --cell;
+			return cell;
+		}
+
+		static uint64_t key(int32_t x, int32_t y) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y; }
+
+	private: // Fields:
+		static const int64_t maxCellsPerEntity = 64;
+
+		scalar cellSize;
+		size_t engineVersion = (size_t)-1;
+		size_t queryNumber = 0;
+
+		std::unordered_map<uint64_t, std::vector<size_t>> cells;
+		std::vector<Item> statics;
+		std::vector<size_t> large;
+		std::vector<Entity*> dynamics;
+	};
+}
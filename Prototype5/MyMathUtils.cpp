@@ -53,6 +53,13 @@ namespace JesseRussell {
 	}
 
 	namespace vectors {
+		constexpr Cardinal::Value X::Value;
+		constexpr Cardinal::Value X::Positive;
+		constexpr Cardinal::Value X::Negative;
+		constexpr Cardinal::Value Y::Value;
+		constexpr Cardinal::Value Y::Positive;
+		constexpr Cardinal::Value Y::Negative;
+
 		fvector2 operator*(const float& scaler, const fvector2& vector) { return fvector2(scaler * vector.x, scaler * vector.y); }
 		fvector2 operator/(const float& scaler, const fvector2& vector) { return fvector2(scaler / vector.x, scaler / vector.y); }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include<string>
 #include<iostream>
+#include<type_traits>
 
 namespace JesseRussell {
 	namespace cmp {
@@ -158,6 +159,38 @@ namespace JesseRussell {
 			Value value = NONE;
 		};
 
+		// o======o
+		// | Axes |
+		// o======o
+
+		// Compile-time counterparts of Cardinal::EAST_WEST and Cardinal::NORTH_SOUTH.
+		// Handing one of these to a template (fvector2::Axis<X>(), Engine::Update<Y>(), ...) picks the axis
+		// at compile time, so there's nothing to branch on and nothing to throw.
+		struct X;
+		struct Y;
+
+		struct X {
+			using Swapped = Y;
+			static constexpr Cardinal::Value Value    = Cardinal::EAST_WEST;
+			static constexpr Cardinal::Value Positive = Cardinal::EAST;
+			static constexpr Cardinal::Value Negative = Cardinal::WEST;
+
+			template<typename Vector> static auto& Of(Vector& v) { return v.x; }
+		};
+
+		struct Y {
+			using Swapped = X;
+			static constexpr Cardinal::Value Value    = Cardinal::NORTH_SOUTH;
+			static constexpr Cardinal::Value Positive = Cardinal::SOUTH;
+			static constexpr Cardinal::Value Negative = Cardinal::NORTH;
+
+			template<typename Vector> static auto& Of(Vector& v) { return v.y; }
+		};
+
+		// The axis that a side lies on. AxisOf<Cardinal::NORTH> is Y, AxisOf<Cardinal::WEST> is X.
+		template<Cardinal::Value side>
+		using AxisOf = typename std::conditional<(side & Cardinal::EAST_WEST) != 0, X, Y>::type;
+
 		struct fvector2 {
 			// fields:
 			float
@@ -304,17 +337,36 @@ namespace JesseRussell {
 			bool operator==(const fvector2& other) const { return x == other.x && y == other.y; }
 			bool operator!=(const fvector2& other) const { return x != other.x || y != other.y; }
 
+			// Axis integration (compile-time):
+			template<typename A> const float& Axis() const { return A::Of(*this); }
+			template<typename A> float&       ref_Axis() { return A::Of(*this); }
+
+			template<typename A> void AddAxis(const float& value) { A::Of(*this) += value; }
+			template<typename A> void ReplaceAxis(const float& value) { A::Of(*this) = value; }
+
+			template<typename A> fvector2 SelectAxis() const {
+				fvector2 result;
+				A::Of(result) = A::Of(*this);
+				return result;
+			}
+
+			template<typename A> fvector2 PlusAxis(const float& value) const {
+				fvector2 result = *this;
+				A::Of(result) += value;
+				return result;
+			}
+
 			// Cardinal integration:
 			const float& Axis(const Cardinal& axis) const {
 				if (axis.isHorizontal()) {
 					if (axis.isVertical())
 						throw std::invalid_argument("The axis was horizontal and vertical simultaneously when exclusively horizontal or vertical was expected.");
 					else
-						return x;
+						return Axis<X>();
 				}
 				else {
 					if (axis.isVertical())
-						return y;
+						return Axis<Y>();
 					else
 						throw std::invalid_argument("The axis was NONE.");
 				}
@@ -325,11 +377,11 @@ namespace JesseRussell {
 					if (axis.isVertical())
 						throw std::invalid_argument("The axis was horizontal and vertical simultaneously when exclusively horizontal or vertical was expected.");
 					else
-						return x;
+						return ref_Axis<X>();
 				}
 				else {
 					if (axis.isVertical())
-						return y;
+						return ref_Axis<Y>();
 					else
 						throw std::invalid_argument("The axis was NONE.");
 				}
@@ -81,6 +81,10 @@ namespace phy {
 		void  PointB(const Cardinal& axis, const float& value) { Size(axis, value - Position(axis)); }
 
 
+		template<typename A> float Position() const { return A::Of(position); }
+		template<typename A> float Size() const { return A::Of(size); }
+
+
 		float Volume() const { return std::abs(size.x * size.y); }
 
 		const float& Width() const { return size.x; }
@@ -91,12 +95,30 @@ namespace phy {
 
 	public: // Methods:
 
+		template<Cardinal::Value side>
+		float GetSide() const {
+			static_assert(side == Cardinal::NORTH || side == Cardinal::EAST || side == Cardinal::SOUTH || side == Cardinal::WEST,
+				"Expected exclusively north, south, east, or west.");
+			using A = AxisOf<side>;
+			return side == A::Positive
+				? cmp::max(A::Of(position), A::Of(position) + A::Of(size))
+				: cmp::min(A::Of(position), A::Of(position) + A::Of(size));
+		}
+
+		template<Cardinal::Value corner>
+		fvector2 GetCorner() const {
+			return {
+				GetSide<static_cast<Cardinal::Value>(corner & Cardinal::EAST_WEST)>(),
+				GetSide<static_cast<Cardinal::Value>(corner & Cardinal::NORTH_SOUTH)>()
+			};
+		}
+
 		float GetSide(const Cardinal& side) const {
 			switch (side.GetValue()) {
-			case Cardinal::NORTH: return cmp::min(PointA_y(), PointB_y());
-			case Cardinal::EAST:  return cmp::max(PointA_x(), PointB_x());
-			case Cardinal::SOUTH: return cmp::max(PointA_y(), PointB_y());
-			case Cardinal::WEST:  return cmp::min(PointA_x(), PointB_x());
+			case Cardinal::NORTH: return GetSide<Cardinal::NORTH>();
+			case Cardinal::EAST:  return GetSide<Cardinal::EAST>();
+			case Cardinal::SOUTH: return GetSide<Cardinal::SOUTH>();
+			case Cardinal::WEST:  return GetSide<Cardinal::WEST>();
 			default: throw std::invalid_argument("Expected exclusively north, south, east, or west.");
 			}
 		}
@@ -157,32 +179,44 @@ namespace phy {
 		// ||																||
 		// \\===============================================================//
 
+		template<typename A>
+		CollisionBox Smear(const fvector2& offset) const {
+			if (A::Of(offset) >= 0)
+				return CollisionBox::ByPoints(GetCorner<Cardinal::NORTH_WEST>(), GetCorner<Cardinal::SOUTH_EAST>().PlusAxis<A>(A::Of(offset)));
+			else
+				return CollisionBox::ByPoints(GetCorner<Cardinal::NORTH_WEST>().PlusAxis<A>(A::Of(offset)), GetCorner<Cardinal::SOUTH_EAST>());
+		}
+
+		// Only the area swept by the leading side, so the box starts at the leading side instead of the trailing one.
+		template<typename A>
+		CollisionBox Offset(const fvector2& offset) const {
+			using B = typename A::Swapped;
+			if (A::Of(offset) >= 0)
+				return CollisionBox::ByPoints(
+					GetCorner<static_cast<Cardinal::Value>(A::Positive | B::Negative)>(),
+					GetCorner<Cardinal::SOUTH_EAST>().PlusAxis<A>(A::Of(offset)));
+			else
+				return CollisionBox::ByPoints(
+					GetCorner<Cardinal::NORTH_WEST>().PlusAxis<A>(A::Of(offset)),
+					GetCorner<static_cast<Cardinal::Value>(A::Negative | B::Positive)>());
+		}
+
 		CollisionBox Smear(const Cardinal& axis, const float& offset) const {
 			return Smear(axis, { offset, offset });
 		}
 
 		CollisionBox Smear(const Cardinal& axis, const fvector2& offset) const {
 			if (axis.isHorizontal()) {
-				if (axis.isVertical()) {
+				if (axis.isVertical())
 					throw std::invalid_argument("axis was horizontal and vertical simultaneously.");
-				}
-				else{
-					if (offset.x >= 0)
-						return CollisionBox::ByPoints(GetCorner(Cardinal::NORTH_WEST), GetCorner(Cardinal::SOUTH_EAST).PlusX(offset.x));
-					else
-						return CollisionBox::ByPoints(GetCorner(Cardinal::NORTH_WEST).PlusX(offset.x), GetCorner(Cardinal::SOUTH_EAST));
-				}
+				else
+					return Smear<X>(offset);
 			}
 			else {
-				if (axis.isVertical()) {
-					if (offset.y >= 0)
-						return CollisionBox::ByPoints(GetCorner(Cardinal::NORTH_WEST), GetCorner(Cardinal::SOUTH_EAST).PlusY(offset.y));
-					else
-						return CollisionBox::ByPoints(GetCorner(Cardinal::NORTH_WEST).PlusY(offset.y), GetCorner(Cardinal::SOUTH_EAST));
-				}
-				else {
+				if (axis.isVertical())
+					return Smear<Y>(offset);
+				else
 					throw std::invalid_argument("axis was NONE.");
-				}
 			}
 		}
 
@@ -192,26 +226,16 @@ namespace phy {
 
 		CollisionBox Offset(const Cardinal& axis, const fvector2& offset) const {
 			if (axis.isHorizontal()) {
-				if (axis.isVertical()) {
+				if (axis.isVertical())
 					throw std::invalid_argument("axis was horizontal and vertical simultaneously.");
-				}
-				else {
-					if (offset.x >= 0)
-						return CollisionBox::ByPoints(GetCorner(Cardinal::NORTH_EAST), GetCorner(Cardinal::SOUTH_EAST).PlusX(offset.x));
-					else
-						return CollisionBox::ByPoints(GetCorner(Cardinal::NORTH_WEST).PlusX(offset.x), GetCorner(Cardinal::SOUTH_WEST));
-				}
+				else
+					return Offset<X>(offset);
 			}
 			else {
-				if (axis.isVertical()) {
-					if (offset.y >= 0)
-						return CollisionBox::ByPoints(GetCorner(Cardinal::SOUTH_WEST), GetCorner(Cardinal::SOUTH_EAST).PlusY(offset.y));
-					else
-						return CollisionBox::ByPoints(GetCorner(Cardinal::NORTH_WEST).PlusY(offset.y), GetCorner(Cardinal::NORTH_EAST));
-				}
-				else {
+				if (axis.isVertical())
+					return Offset<Y>(offset);
+				else
 					throw std::invalid_argument("axis was NONE.");
-				}
 			}
 		}
 
@@ -220,25 +244,28 @@ namespace phy {
 		void Move(const Cardinal& axis, const float& distance) {
 			position.AddAxis(axis, distance);
 		}
+		template<typename A>
+		void Move(const float& distance) { A::Of(position) += distance; }
+
+		template<Cardinal::Value side>
+		void SetPositionOnSide(const float& value) {
+			static_assert(side == Cardinal::NORTH || side == Cardinal::EAST || side == Cardinal::SOUTH || side == Cardinal::WEST,
+				"Expected exclusively north, east, south, or west");
+			using A = AxisOf<side>;
+			// With a negative size the box's far edge is at position, so the sides trade places.
+			if ((A::Of(size) >= 0) == (side == A::Positive))
+				A::Of(position) = value - A::Of(size);
+			else
+				A::Of(position) = value;
+		}
 
 		void SetPositionOnSide(const Cardinal& side, const float& value) {
-			if (Size(side) >= 0) {
-				switch (side.GetValue()) {
-				case Cardinal::NORTH: position.y = value; break;
-				case Cardinal::EAST:  position.x = value - size.x; break;
-				case Cardinal::SOUTH: position.y = value - size.y; break;
-				case Cardinal::WEST:  position.x = value; break;
-				default: throw std::invalid_argument("Expected exclusively north, east, south, or west");
-				}
-			}
-			else {
-				switch (side.GetValue()) {
-				case Cardinal::NORTH: position.y = value - size.y; break;
-				case Cardinal::EAST:  position.x = value; break;
-				case Cardinal::SOUTH: position.y = value; break;
-				case Cardinal::WEST:  position.x = value - size.x; break;
-				default: throw std::invalid_argument("Expected exclusively north, east, south, or west");
-				}
+			switch (side.GetValue()) {
+			case Cardinal::NORTH: SetPositionOnSide<Cardinal::NORTH>(value); break;
+			case Cardinal::EAST:  SetPositionOnSide<Cardinal::EAST>(value); break;
+			case Cardinal::SOUTH: SetPositionOnSide<Cardinal::SOUTH>(value); break;
+			case Cardinal::WEST:  SetPositionOnSide<Cardinal::WEST>(value); break;
+			default: throw std::invalid_argument("Expected exclusively north, east, south, or west");
 			}
 		}
 
@@ -403,6 +430,10 @@ namespace phy {
 		void ApplyVelocity(const float& timeScale = 1) {
 			Move(velocity * timeScale);
 		}
+		template<typename A>
+		void ApplyVelocity(const float& timeScale = 1) {
+			Move<A>(A::Of(velocity) * timeScale);
+		}
 		//
 
 		CollisionBox GetVelocitySmear(const Cardinal& axis, const float& timeScale) {
@@ -413,6 +444,11 @@ namespace phy {
 			return Offset(axis, velocity * timeScale);
 		}
 
+		template<typename A>
+		CollisionBox GetVelocityOffset(const float& timeScale) {
+			return Offset<A>(velocity * timeScale);
+		}
+
 		Cardinal GetHeading() {
 			Cardinal result = 0;
 			if (velocity.x >= 0) result |= Cardinal::EAST;
@@ -434,6 +470,26 @@ namespace phy {
 			return (GetVelocityOffset(axis, timeScale).Intersects(other));
 		}
 
+		template<typename A>
+		bool Collides(const CollisionBox& other, float timeScale, float& out_collisionSpot, Cardinal& out_collisionSide) {
+			// Same as GetHeading() narrowed to A, without building the whole heading.
+			if (A::Of(velocity) >= 0) {
+				out_collisionSide = A::Positive;
+				out_collisionSpot = other.GetSide<A::Negative>();
+			}
+			else {
+				out_collisionSide = A::Negative;
+				out_collisionSpot = other.GetSide<A::Positive>();
+			}
+
+			return Collides<A>(other, timeScale);
+		}
+
+		template<typename A>
+		bool Collides(const CollisionBox& other, float timeScale) {
+			return GetVelocityOffset<A>(timeScale).Intersects(other);
+		}
+
 	private: // Fields:
 		fvector2
 			velocity = { 0, 0 };
@@ -505,10 +561,18 @@ namespace phy {
 		void ApplyNetForce(const float& timeScale = 1) {
 			velocity += (netForce / mass) * timeScale;
 		}
+		template<typename A>
+		void ApplyNetForce(const float& timeScale = 1) {
+			A::Of(velocity) += (A::Of(netForce) / mass) * timeScale;
+		}
 
 		void ResetNetForce(const Cardinal& axis = Cardinal::SOUTH_EAST) {
 			netForce.ReplaceAxis(axis, 0);
 		}
+		template<typename A>
+		void ResetNetForce() {
+			A::Of(netForce) = 0;
+		}
 	private:
 		fvector2
 			netForce = { 0, 0 },
@@ -586,9 +650,12 @@ namespace phy {
 
 
 	public:
-		void Update(Cardinal axis, const float& timeScale) {
+		// Runs one axis pass over every movable entity. The axis is a template argument (X or Y) so the whole pass is
+		// specialized for it instead of branching on a Cardinal for every entity.
+		template<typename A>
+		void Update(const float& timeScale) {
 			// Update environment properties:
-			this->axis = axis;
+			this->axis = A::Value;
 			this->timeScale = timeScale;
 			// Main loop...
 			for (Entity* e : movableEntities) {
@@ -600,7 +667,7 @@ namespace phy {
 					((MovableEntity*)e)->beforeMovementUpdate(*this);
 					if (e_isdyn) ((DynamicEntity*)e)->beforePhysicsUpdate(*this);
 
-					UpdateSingleMovable((MovableEntity*)e);
+					UpdateSingleMovable<A>((MovableEntity*)e);
 
 					if (e_isdyn)((DynamicEntity*)e)->afterPhysicsUpdate(*this);
 					((MovableEntity*)e)->afterMovementUpdate(*this);
@@ -608,7 +675,24 @@ namespace phy {
 			}
 		}
 
+		void Update(Cardinal axis, const float& timeScale) {
+			if (axis.isHorizontal()) {
+				if (axis.isVertical())
+					throw std::invalid_argument("axis was horizontal and vertical simultaneously.");
+				else
+					Update<X>(timeScale);
+			}
+			else {
+				if (axis.isVertical())
+					Update<Y>(timeScale);
+				else
+					throw std::invalid_argument("axis was NONE.");
+			}
+		}
+
+		template<typename A>
 		void UpdateSingleMovable(MovableEntity* e) {
+			using B = typename A::Swapped;
 			float out_collisionSpot;
 			Cardinal out_collisionSide;
 			float closestSpot;
@@ -624,8 +708,8 @@ namespace phy {
 			if (e->IsDynamic()) {
 				DynamicEntity* de = (DynamicEntity*)e;
 				fvector2 force = { 0, 0 };
-				float velocity = de->velocity.Axis(axis);
-				force.ref_Axis(axis) = velocity * std::abs(velocity) * -0.5 * airDensity * de->Drag() * de->Size(axis.AxisSwapped());
+				float velocity = de->velocity.Axis<A>();
+				force.ref_Axis<A>() = velocity * std::abs(velocity) * -0.5 * airDensity * de->Drag() * de->Size<B>();
 
 				de->AddForce(force);
 			}
@@ -642,8 +726,8 @@ namespace phy {
 			// | Apply net force: |
 			// o ---------------- o
 			if (e->IsDynamic()) {
-				((DynamicEntity*)e)->ApplyNetForce(axis, timeScale);
-				((DynamicEntity*)e)->ResetNetForce(axis);
+				((DynamicEntity*)e)->ApplyNetForce<A>(timeScale);
+				((DynamicEntity*)e)->ResetNetForce<A>();
 			}
 
 
@@ -655,7 +739,7 @@ namespace phy {
 				
 
 				// Check for touching:
-				if (e->Collides(axis, *other, timeScale, out_collisionSpot, out_collisionSide)) {
+				if (e->Collides<A>(*other, timeScale, out_collisionSpot, out_collisionSide)) {
 					if (e->CompareCollisionGroups(*other)) {
 						// one of many collisions has occurred
 						if (collided) {
@@ -690,17 +774,9 @@ namespace phy {
 			bool trueCollision = false;
 			if (collided) {
 				if (closestEntity->IsMovable()) {
-					MovableEntity other = *(MovableEntity*)closestEntity;
-					switch (closestSide.GetValue()) {
-					case Cardinal::NORTH:
-						trueCollision = e->velocity.y - other.velocity.y < 0; break;
-					case Cardinal::SOUTH:
-						trueCollision = e->velocity.y - other.velocity.y > 0; break;
-					case Cardinal::WEST:
-						trueCollision = e->velocity.x - other.velocity.x < 0; break;
-					case Cardinal::EAST:
-						trueCollision = e->velocity.x - other.velocity.x > 0; break;
-					}
+					const MovableEntity& other = *(MovableEntity*)closestEntity;
+					float relativeVelocity = e->velocity.Axis<A>() - other.velocity.Axis<A>();
+					trueCollision = closestSide.GetValue() == A::Positive ? relativeVelocity > 0 : relativeVelocity < 0;
 				}
 				else
 					trueCollision = true;
@@ -713,7 +789,8 @@ namespace phy {
 			if (collided && trueCollision) {
 				float spot = closestSpot;
 				Cardinal side = out_collisionSide;
-				e->SetPositionOnSide(side, spot);
+				if (side.GetValue() == A::Positive) e->SetPositionOnSide<A::Positive>(spot);
+				else                                e->SetPositionOnSide<A::Negative>(spot);
 
 				if (e->IsDynamic()) {
 					DynamicEntity& entity = *(DynamicEntity*)e;
@@ -724,26 +801,26 @@ namespace phy {
 						DynamicEntity& other = *(DynamicEntity*)closestEntity;
 						// get relative force of collision, and call it normal force even though you're not sure if that's technically right...
 						float normalForce =
-							entity.mass * (entity.velocity.Axis(axis) / timeScale) +
-							other.mass * (other.velocity.Axis(axis) / timeScale);
+							entity.mass * (entity.velocity.Axis<A>() / timeScale) +
+							other.mass * (other.velocity.Axis<A>() / timeScale);
 						// effect of collision:
 						// -------------------
 
 						// Get new velocity:
 						float other_vf =
-							(2 * entity.mass / (entity.mass + other.mass)) * entity.velocity.Axis(axis) -
-							((entity.mass - other.mass) / (entity.mass + other.mass)) * other.velocity.Axis(axis);
+							(2 * entity.mass / (entity.mass + other.mass)) * entity.velocity.Axis<A>() -
+							((entity.mass - other.mass) / (entity.mass + other.mass)) * other.velocity.Axis<A>();
 
 						float entity_vf =
-							((entity.mass - other.mass) / (entity.mass + other.mass)) * entity.velocity.Axis(axis) +
-							(2 * other.mass / (entity.mass + other.mass)) * other.velocity.Axis(axis);
+							((entity.mass - other.mass) / (entity.mass + other.mass)) * entity.velocity.Axis<A>() +
+							(2 * other.mass / (entity.mass + other.mass)) * other.velocity.Axis<A>();
 
 						// average bounce.
 						float averageBounce = (entity.bounce + other.bounce) / 2;
 
 						// Set new velocity:
-						entity.velocity.ref_Axis(axis) = entity_vf * averageBounce;
-						other.velocity.ref_Axis(axis) = other_vf * averageBounce;
+						entity.velocity.ref_Axis<A>() = entity_vf * averageBounce;
+						other.velocity.ref_Axis<A>() = other_vf * averageBounce;
 						//
 
 						// effect of friction (continues from | Apply other forces: |):
@@ -751,18 +828,18 @@ namespace phy {
 						// omg friction is complicated
 
 						// static friction:
-						float relativeVeloctiy = entity.velocity.Axis(axis.AxisSwapped()) - other.velocity.Axis(axis.AxisSwapped()); // *relative to entity not other.
+						float relativeVeloctiy = entity.velocity.Axis<B>() - other.velocity.Axis<B>(); // *relative to entity not other.
 						float averageFriction = (entity.friction_coef * other.friction_coef) / 2;
 
 						fvector2 force = { 0, 0 };
-						force.ref_Axis(axis.AxisSwapped()) = averageFriction * std::abs(normalForce) * -cmp::sign(relativeVeloctiy);
+						force.ref_Axis<B>() = averageFriction * std::abs(normalForce) * -cmp::sign(relativeVeloctiy);
 
 						entity.AddForce(force);
 						other.AddForce(force * -1);
 					}
 					else {
 						// effect of collision:
-						entity.velocity.ref_Axis(axis) *= -entity.bounce;
+						entity.velocity.ref_Axis<A>() *= -entity.bounce;
 
 						// get relative force of collision, and call it normal force even though you're not sure if that's technically right...
 						float normalForce = 0;
@@ -772,18 +849,18 @@ namespace phy {
 						if (closestEntity->IsMovable()) {
 							MovableEntity& other_me = *((MovableEntity*)closestEntity);
 							normalForce =
-								entity.mass * (entity.velocity.Axis(axis)   / timeScale) +
-								entity.mass * (other_me.velocity.Axis(axis) / timeScale);
+								entity.mass * (entity.velocity.Axis<A>()   / timeScale) +
+								entity.mass * (other_me.velocity.Axis<A>() / timeScale);
 
 							relativeVeloctiy =
-								entity.velocity.Axis(axis.AxisSwapped()) - other_me.velocity.Axis(axis.AxisSwapped());
+								entity.velocity.Axis<B>() - other_me.velocity.Axis<B>();
 						}
 						// if other is not movable
 						else {
 							normalForce =
-								entity.mass * (entity.velocity.Axis(axis) / timeScale);
+								entity.mass * (entity.velocity.Axis<A>() / timeScale);
 
-							relativeVeloctiy = entity.velocity.Axis(axis.AxisSwapped());
+							relativeVeloctiy = entity.velocity.Axis<B>();
 						}
 
 						// effect of friction (continues from | Apply other forces: |):
@@ -794,7 +871,7 @@ namespace phy {
 						float averageFriction = (entity.friction_coef * closestEntity->friction_coef) / 2;
 
 						fvector2 force = { 0, 0 };
-						force.ref_Axis(axis.AxisSwapped()) = averageFriction * std::abs(normalForce) * -cmp::sign(relativeVeloctiy);
+						force.ref_Axis<B>() = averageFriction * std::abs(normalForce) * -cmp::sign(relativeVeloctiy);
 
 						entity.AddForce(force);
 					}
@@ -803,11 +880,11 @@ namespace phy {
 					MovableEntity& entity = *e;
 					if (closestEntity->IsDynamic()) {
 						DynamicEntity& other = *(DynamicEntity*)closestEntity;
-						other.velocity.ref_Axis(axis) = entity.velocity.Axis(axis);
+						other.velocity.ref_Axis<A>() = entity.velocity.Axis<A>();
 					}
 					else {
 						Entity& other = *closestEntity;
-						entity.velocity.ref_Axis(axis) *= -entity.bounce;
+						entity.velocity.ref_Axis<A>() *= -entity.bounce;
 					}
 				}
 			}
@@ -816,7 +893,7 @@ namespace phy {
 			// | Apply velocity: |
 			// o --------------- o
 			if (!collided) {
-				e->ApplyVelocity(axis, timeScale);
+				e->ApplyVelocity<A>(timeScale);
 			}
 		}
 
@@ -1,12 +1,34 @@
 #pragma once
 #include<chrono>
+#include<cstdint>
+#include<atomic>
+#include<mutex>
+#include<vector>
+#include<string>
+#include<ostream>
+#include<fstream>
+#include<iomanip>
+#include<thread>
+
+#ifdef DIAGNOSTICS_PROFILER_TSC
+#ifdef _MSC_VER
+#include<intrin.h>
+#else
+#include<x86intrin.h>
+#endif
+#endif
+
 // Stopwatch class similar to C#'s stopwatch all the way down to the namespace.
 namespace JesseRussell {
 	namespace Diagnostics {
+		// Every time point in here comes from this one clock. high_resolution_clock is allowed to be a different clock
+		// than steady_clock (it's system_clock in some standard libraries), so it can't be mixed in.
+		using Clock = std::chrono::steady_clock;
+
 		class Stopwatch
 		{
 		private:
-			std::chrono::steady_clock::time_point startTime, stopTime;
+			Clock::time_point startTime, stopTime;
 			bool running, ready;
 
 		public:
@@ -16,7 +38,7 @@ namespace JesseRussell {
 
 			void start() {
 				if (ready) {
-					startTime = std::chrono::high_resolution_clock::now();
+					startTime = Clock::now();
 					ready = false;
 				}
 				running = true;
@@ -24,7 +46,7 @@ namespace JesseRussell {
 
 			void stop() {
 				if (running) {
-					stopTime = std::chrono::high_resolution_clock::now();
+					stopTime = Clock::now();
 					running = false;
 				}
 			}
@@ -41,11 +63,11 @@ namespace JesseRussell {
 
 			bool isRunning() { return running; }
 
-			std::chrono::steady_clock::duration getElapsed() {
+			Clock::duration getElapsed() {
 				if (running)
-					return std::chrono::high_resolution_clock::now() - startTime;
+					return Clock::now() - startTime;
 				else if (ready)
-					return std::chrono::steady_clock::duration::zero();
+					return Clock::duration::zero();
 				else
 					return stopTime - startTime;
 			}
@@ -54,5 +76,272 @@ namespace JesseRussell {
 				return std::chrono::duration_cast<std::chrono::milliseconds>(getElapsed()).count();
 			}
 		};
+
+
+
+		// o----------o
+		// | Profiler |
+		// o----------o
+
+		// Scoped, hierarchical profiler. Put PROFILE_ZONE("name") at the top of a block and the time spent in that block is
+		// recorded as one event, nested under whichever zone encloses it on the same thread.
+		//
+		// Each thread records into its own buffer, so opening and closing a zone never takes a lock. Buffers are lists of
+		// fixed-size chunks that are only ever appended to, so one thread can export while the others keep recording.
+		//
+		// Recording is off until Profiler::setEnabled(true); until then a zone costs one relaxed load.
+		// Define DIAGNOSTICS_NO_PROFILER to compile PROFILE_ZONE and PROFILE_FUNCTION out completely.
+		// Define DIAGNOSTICS_PROFILER_TSC to timestamp with the CPU's time-stamp counter instead of Clock. It's cheaper to
+		// read, but only trustworthy on CPUs with an invariant TSC (anything x86 from the last decade).
+		class Profiler {
+			struct ThreadBuffer;
+
+		public: // types:
+			struct Event {
+				const char* name; // Not copied. String literals and __FUNCTION__ are fine.
+				uint64_t start;   // ticks, see toMicroseconds.
+				uint64_t end;
+				uint32_t depth;   // 0 for outermost zones.
+			};
+
+			class Zone {
+			public:
+				explicit Zone(const char* name) {
+					if (!isEnabled()) return;
+					buffer = &threadBuffer();
+					event.name = name;
+					event.depth = buffer->depth++;
+					event.start = now();
+				}
+
+				~Zone() {
+					if (buffer == nullptr) return;
+					event.end = now();
+					--buffer->depth;
+					buffer->push(event);
+				}
+
+				Zone(const Zone&) = delete;
+				Zone& operator=(const Zone&) = delete;
+
+			private:
+				ThreadBuffer* buffer = nullptr;
+				Event event;
+			};
+
+		private: // buffers:
+			struct Chunk {
+				static constexpr size_t capacity = 4096;
+				Event events[capacity];
+				std::atomic<size_t> count{ 0 };
+				std::atomic<Chunk*> next{ nullptr };
+			};
+
+			struct ThreadBuffer {
+				uint32_t id;
+				std::atomic<const char*> name{ nullptr };
+				uint32_t depth = 0;
+				Chunk* head = new Chunk;
+				Chunk* tail = head;
+
+				~ThreadBuffer() {
+					while (head != nullptr) {
+						Chunk* next = head->next.load(std::memory_order_relaxed);
+						delete head;
+						head = next;
+					}
+				}
+
+				// Only ever called by the owning thread. count is published last, so readers never see a half-written event.
+				void push(const Event& event) {
+					size_t count = tail->count.load(std::memory_order_relaxed);
+					if (count == Chunk::capacity) {
+						Chunk* chunk = new Chunk;
+						tail->next.store(chunk, std::memory_order_release);
+						tail = chunk;
+						count = 0;
+					}
+					tail->events[count] = event;
+					tail->count.store(count + 1, std::memory_order_release);
+				}
+
+				template<typename Action>
+				void forEach(Action action) const {
+					for (const Chunk* chunk = head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire)) {
+						size_t count = chunk->count.load(std::memory_order_acquire);
+						for (size_t i = 0; i < count; ++i)
+							action(chunk->events[i]);
+					}
+				}
+			};
+
+			struct State {
+				std::atomic<bool> enabled{ false };
+				std::mutex buffersMutex;
+				std::vector<ThreadBuffer*> buffers;
+
+				~State() {
+					for (ThreadBuffer* buffer : buffers)
+						delete buffer;
+				}
+			};
+
+			static State& state() {
+				static State instance;
+				return instance;
+			}
+
+			// Buffers belong to the profiler, not the thread, so a thread's events can still be exported after it exits.
+			static ThreadBuffer& threadBuffer() {
+				thread_local ThreadBuffer* buffer = nullptr;
+				if (buffer == nullptr) {
+					State& s = state();
+					std::lock_guard<std::mutex> lock(s.buffersMutex);
+					buffer = new ThreadBuffer;
+					buffer->id = (uint32_t)s.buffers.size();
+					s.buffers.push_back(buffer);
+				}
+				return *buffer;
+			}
+
+		public: // control:
+			static bool isEnabled() { return state().enabled.load(std::memory_order_relaxed); }
+			static void setEnabled(bool value) { state().enabled.store(value, std::memory_order_relaxed); }
+
+			// Names the calling thread in exported traces. Like zone names, the string isn't copied.
+			static void setThreadName(const char* name) { threadBuffer().name.store(name, std::memory_order_relaxed); }
+
+			// Drops every recorded event. Unlike exporting, this must not overlap with zones being recorded on any thread.
+			static void clear() {
+				State& s = state();
+				std::lock_guard<std::mutex> lock(s.buffersMutex);
+				for (ThreadBuffer* buffer : s.buffers) {
+					Chunk* chunk = buffer->head->next.load(std::memory_order_relaxed);
+					while (chunk != nullptr) {
+						Chunk* next = chunk->next.load(std::memory_order_relaxed);
+						delete chunk;
+						chunk = next;
+					}
+					buffer->head->next.store(nullptr, std::memory_order_relaxed);
+					buffer->head->count.store(0, std::memory_order_relaxed);
+					buffer->tail = buffer->head;
+				}
+			}
+
+		public: // time:
+			static uint64_t now() {
+#ifdef DIAGNOSTICS_PROFILER_TSC
+				return __rdtsc();
+#else
+				return (uint64_t)Clock::now().time_since_epoch().count();
+#endif
+			}
+
+			static double toMicroseconds(uint64_t ticks) { return ticks / ticksPerMicrosecond(); }
+
+			static double ticksPerMicrosecond() {
+#ifdef DIAGNOSTICS_PROFILER_TSC
+				// Measured once, against Clock, the first time anything asks.
+				static const double value = [] {
+					Clock::time_point clockStart = Clock::now();
+					uint64_t tscStart = __rdtsc();
+					while (Clock::now() - clockStart < std::chrono::milliseconds(20)) {}
+					uint64_t tscEnd = __rdtsc();
+					Clock::time_point clockEnd = Clock::now();
+					return (tscEnd - tscStart) / std::chrono::duration<double, std::micro>(clockEnd - clockStart).count();
+				}();
+				return value;
+#else
+				return (double)Clock::period::den / Clock::period::num / 1000000.0;
+#endif
+			}
+
+		public: // reading:
+			// Calls action(threadId, threadName, event) for every recorded event. threadName is null for unnamed threads.
+			// Events of one thread come in the order their zones closed, so children come before their parents.
+			template<typename Action>
+			static void forEachEvent(Action action) {
+				State& s = state();
+				std::lock_guard<std::mutex> lock(s.buffersMutex);
+				for (const ThreadBuffer* buffer : s.buffers) {
+					const char* name = buffer->name.load(std::memory_order_relaxed);
+					buffer->forEach([&](const Event& event) { action(buffer->id, name, event); });
+				}
+			}
+
+			// Writes everything recorded so far in Chrome's trace event format.
+			// Open it with chrome://tracing, edge://tracing or https://ui.perfetto.dev.
+			static void writeChromeTrace(std::ostream& out) {
+				uint64_t origin = UINT64_MAX;
+				forEachEvent([&](uint32_t, const char*, const Event& event) {
+					if (event.start < origin) origin = event.start;
+				});
+
+				std::ios_base::fmtflags flags = out.flags();
+				std::streamsize precision = out.precision();
+				out << std::fixed << std::setprecision(3);
+
+				out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+				bool first = true;
+				{
+					State& s = state();
+					std::lock_guard<std::mutex> lock(s.buffersMutex);
+					for (const ThreadBuffer* buffer : s.buffers) {
+						const char* name = buffer->name.load(std::memory_order_relaxed);
+						if (name == nullptr) continue;
+						out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":";
+						writeJsonString(out, name);
+						out << "}}";
+						first = false;
+					}
+				}
+				forEachEvent([&](uint32_t threadId, const char*, const Event& event) {
+					out << (first ? "\n" : ",\n") << "{\"name\":";
+					writeJsonString(out, event.name);
+					out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId
+						<< ",\"ts\":" << toMicroseconds(event.start - origin)
+						<< ",\"dur\":" << toMicroseconds(event.end - event.start) << "}";
+					first = false;
+				});
+				out << "\n]}\n";
+
+				out.flags(flags);
+				out.precision(precision);
+			}
+
+			static bool saveChromeTrace(const std::string& path) {
+				std::ofstream file(path);
+				if (!file) return false;
+				writeChromeTrace(file);
+				return (bool)file;
+			}
+
+		private:
+			static void writeJsonString(std::ostream& out, const char* text) {
+				out << '"';
+				for (const char* c = text; *c != '\0'; ++c) {
+					switch (*c) {
+					case '"':  out << "\\\""; break;
+					case '\\': out << "\\\\"; break;
+					case '\n': out << "\\n"; break;
+					case '\t': out << "\\t"; break;
+					default:
+						if ((unsigned char)*c < 0x20) out << ' ';
+						else out << *c;
+					}
+				}
+				out << '"';
+			}
+		};
 	}
-}
\ No newline at end of file
+}
+
+#define PROFILE_ZONE_CONCAT_(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_(a, b)
+#ifdef DIAGNOSTICS_NO_PROFILER
+#define PROFILE_ZONE(name)
+#define PROFILE_FUNCTION()
+#else
+#define PROFILE_ZONE(name) ::JesseRussell::Diagnostics::Profiler::Zone PROFILE_ZONE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+#endif
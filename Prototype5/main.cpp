@@ -5,6 +5,7 @@
 #include "Stopwatch.h"
 
 #include<chrono>
+#include<cstdio>
 #include<thread>
 
 using namespace JesseRussell;
@@ -93,8 +94,8 @@ public:
 		if (GetKey(olc::LEFT).bHeld) player->AddForce({ -pushForce, 0 });
 		if (GetKey(olc::RIGHT).bHeld) player->AddForce({ pushForce, 0 });
 
-		engine.Update(Cardinal::EAST, fElapsedTime);
-		engine.Update(Cardinal::SOUTH, fElapsedTime);
+		engine.Update<X>(fElapsedTime);
+		engine.Update<Y>(fElapsedTime);
 
 
 
@@ -112,8 +113,11 @@ public:
 				iter++;
 			}
 
-			DrawString(10, 10, "velocity:" + player->Velocity().ToString(), olc::Pixel(0xff00ffff));
-			DrawString(10, 20, "velocity:" + block->Velocity().ToString(), olc::Pixel(0xff00ffff));
+			char text[64];
+			std::snprintf(text, sizeof(text), "velocity:[ %f, %f ]", player->Velocity().x, player->Velocity().y);
+			DrawString(10, 10, text, olc::Pixel(0xff00ffff));
+			std::snprintf(text, sizeof(text), "velocity:[ %f, %f ]", block->Velocity().x, block->Velocity().y);
+			DrawString(10, 20, text, olc::Pixel(0xff00ffff));
 			auto cent = player->GetCenter();
 			DrawCircle(cent.x, cent.y, cmp::min(player->Width(), player->Height()) / 2);
 		}
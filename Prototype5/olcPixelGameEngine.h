@@ -80,6 +80,13 @@
 
 	vblank_mode=0 ./YourProgName
 
+	Without a display, say on a build server, define OLC_PLATFORM_HEADLESS
+	and neither X11 nor OpenGL is needed: layers are composited in memory,
+	and Start runs the frames and input given to SetHeadlessScript, then
+	returns. Compile with:
+
+	g++ -o YourProgName YourSource.cpp -DOLC_PLATFORM_HEADLESS -lpthread -lpng -lstdc++fs -std=c++17
+
 
 	Compiling in Code::Blocks on Windows
 	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -288,7 +295,7 @@ int main()
 	#endif
 #endif
 
-#if defined(__APPLE__)
+#if defined(__APPLE__) && !defined(OLC_PLATFORM_HEADLESS)
 	#define PGE_USE_CUSTOM_START
 #endif
 
@@ -311,12 +318,24 @@ int main()
 
 #define UNUSED(x) (void)(x)
 
+// The span kernels behind Clear, FillRect, straight lines and alpha blending use
+// SSE2 where it's available, which is every x64 target, and AVX2 when compiling
+// for it (/arch:AVX2, -mavx2). Define OLC_NO_SIMD to use plain loops.
+#if !defined(OLC_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define OLC_SIMD_SSE2
+	#include <emmintrin.h>
+	#if defined(__AVX2__)
+		#define OLC_SIMD_AVX2
+		#include <immintrin.h>
+	#endif
+#endif
+
 // O------------------------------------------------------------------------------O
 // | PLATFORM SELECTION CODE, Thanks slavka!                                      |
 // O------------------------------------------------------------------------------O
 
 // Platform
-#if !defined(OLC_PLATFORM_WINAPI) && !defined(OLC_PLATFORM_X11) && !defined(OLC_PLATFORM_GLUT)
+#if !defined(OLC_PLATFORM_WINAPI) && !defined(OLC_PLATFORM_X11) && !defined(OLC_PLATFORM_GLUT) && !defined(OLC_PLATFORM_HEADLESS)
 	#if defined(_WIN32)
 		#define OLC_PLATFORM_WINAPI
 	#endif
@@ -328,8 +347,11 @@ int main()
 	#endif
 #endif
 
-// Renderer
-#if !defined(OLC_GFX_OPENGL10) || !defined(OLC_GFX_OPENGL33) && !defined(OLC_GFX_DIRECTX10)
+// Renderer - headless has no window to render into, so it composites in memory
+#if defined(OLC_PLATFORM_HEADLESS) && !defined(OLC_GFX_SOFTWARE)
+	#define OLC_GFX_SOFTWARE
+#endif
+#if !defined(OLC_GFX_SOFTWARE) && (!defined(OLC_GFX_OPENGL10) || !defined(OLC_GFX_OPENGL33) && !defined(OLC_GFX_DIRECTX10))
 	#define OLC_GFX_OPENGL10
 #endif
 
@@ -626,6 +648,24 @@ namespace olc
 		Mode modeSample = Mode::NORMAL;
 
 		static std::unique_ptr<olc::ImageLoader> loader;
+
+	public:
+		// A run of opaque texels along a row, for drawing in MASK mode
+		struct OpaqueRun { int32_t x; int32_t length; };
+		// The runs of opaque texels (alpha 255), left to right: row y's are
+		// runs[rows[y]] to runs[rows[y + 1] - 1]. Worked out the first time they're
+		// asked for, then kept until SetPixel changes whether a texel is opaque,
+		// GetData hands out the texels, or an image is loaded. Anything writing
+		// through pColData directly should call InvalidateOpaqueRuns. GetData and
+		// InvalidateOpaqueRuns write to the sprite, so code drawing into one target
+		// from several threads uses pColData and invalidates once beforehand
+		void GetOpaqueRuns(const OpaqueRun*& runs, const uint32_t*& rows);
+		void InvalidateOpaqueRuns();
+
+	private:
+		std::vector<OpaqueRun> vOpaqueRuns;
+		std::vector<uint32_t> vOpaqueRows;
+		bool bOpaqueRunsValid = false;
 	};
 
 	// O------------------------------------------------------------------------------O
@@ -699,6 +739,8 @@ namespace olc
 		olc::vf2d vScale = { 1, 1 };
 		bool bShow = false;
 		bool bUpdate = false;
+		int32_t nUpdateRowsBegin = 0;
+		int32_t nUpdateRowsEnd = -1; // -1 means every row
 		olc::Sprite* pDrawTarget = nullptr;
 		uint32_t nResID = 0;
 		std::vector<DecalInstance> vecDecalInstance;
@@ -720,10 +762,13 @@ namespace olc
 		virtual void       DrawDecalQuad(const olc::DecalInstance& decal) = 0;
 		virtual uint32_t   CreateTexture(const uint32_t width, const uint32_t height, const bool filtered = false) = 0;
 		virtual void       UpdateTexture(uint32_t id, olc::Sprite* spr) = 0;
+		virtual void       UpdateTextureRows(uint32_t id, olc::Sprite* spr, int32_t y, int32_t rows) { UNUSED(y); UNUSED(rows); UpdateTexture(id, spr); }
 		virtual uint32_t   DeleteTexture(const uint32_t id) = 0;
 		virtual void       ApplyTexture(uint32_t id) = 0;
 		virtual void       UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) = 0;
 		virtual void       ClearBuffer(olc::Pixel p, bool bDepth) = 0;
+		// Renderers that composite in memory hand back the last frame they displayed
+		virtual const olc::Sprite* GetFrameBuffer() const { return nullptr; }
 		static olc::PixelGameEngine* ptrPGE;
 	};
 
@@ -743,6 +788,32 @@ namespace olc
 		static olc::PixelGameEngine* ptrPGE;
 	};
 
+	// What Start runs under OLC_PLATFORM_HEADLESS: how many frames, the time each
+	// one reports, and the input fed in before them
+	struct HeadlessScript
+	{
+		struct Event
+		{
+			enum Type : uint8_t { KEY, MOUSE_BUTTON, MOUSE_MOVE, MOUSE_WHEEL };
+			uint32_t nFrame; // Counting from 0, seen by that frame's OnUserUpdate
+			Type type;
+			int32_t a;       // Key, mouse button, mouse x or wheel delta
+			int32_t b;       // Down (1) or up (0), or mouse y
+		};
+
+		// 0 runs until OnUserUpdate returns false
+		uint32_t nFrames = 1;
+		// Every frame's fElapsedTime, so runs repeat exactly
+		float fFrameTime = 1.0f / 60.0f;
+		std::vector<Event> vEvents;
+
+		HeadlessScript& AddKey(uint32_t frame, olc::Key k, bool bDown);
+		HeadlessScript& AddMouseButton(uint32_t frame, uint32_t b, bool bDown);
+		// In screen pixels
+		HeadlessScript& AddMouseMove(uint32_t frame, int32_t x, int32_t y);
+		HeadlessScript& AddMouseWheel(uint32_t frame, int32_t delta);
+	};
+
 	
 
 	static std::unique_ptr<Renderer> renderer;
@@ -799,6 +870,8 @@ namespace olc
 		int32_t GetDrawTargetHeight() const;
 		// Returns the currently active draw target
 		olc::Sprite* GetDrawTarget() const;
+		// Returns the sheet of the font DrawString draws with, 16 x 6 glyphs of 8 x 8
+		const olc::Sprite* GetFontSprite() const;
 		// Resize the primary screen sprite
 		void SetScreenSize(int w, int h);
 		// Specify which Sprite should be the target of drawing functions, use nullptr
@@ -814,6 +887,9 @@ namespace olc
 		const olc::vi2d& GetPixelSize() const;
 		// Gets actual pixel scale
 		const olc::vi2d& GetScreenPixelSize() const;
+		// The last frame displayed, every visible layer at screen size, if the renderer
+		// keeps it in memory (Renderer_Software), otherwise nullptr
+		const olc::Sprite* GetFrameBuffer() const;
 
 	public: // CONFIGURATION ROUTINES
 		// Layer targeting functions
@@ -825,6 +901,9 @@ namespace olc
 		void SetLayerScale(uint8_t layer, float x, float y);
 		void SetLayerTint(uint8_t layer, const olc::Pixel& tint);
 		void SetLayerCustomRenderFunction(uint8_t layer, std::function<void()> f);
+		// Only rows [y, y + rows) of the layer changed this frame, so only upload those. Frames where it isn't
+		// called upload the whole layer as usual. rows = 0 means nothing changed.
+		void SetLayerUpdateRows(uint8_t layer, int32_t y, int32_t rows);
 
 		std::vector<LayerDesc>& GetLayers();
 		uint32_t CreateLayer();
@@ -839,6 +918,9 @@ namespace olc
 		void SetPixelMode(std::function<olc::Pixel(const int x, const int y, const olc::Pixel& pSource, const olc::Pixel& pDest)> pixelMode);
 		// Change the blend factor form between 0.0f to 1.0f;
 		void SetPixelBlend(float fBlend);
+		float GetPixelBlend();
+		// Frames and input for Start to run through, without a display (OLC_PLATFORM_HEADLESS)
+		void SetHeadlessScript(const HeadlessScript& script);
 		
 
 
@@ -867,6 +949,12 @@ namespace olc
 		// Flat fills a triangle between points (x1,y1), (x2,y2) and (x3,y3)
 		void FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p = olc::WHITE);
 		void FillTriangle(const olc::vi2d& pos1, const olc::vi2d& pos2, const olc::vi2d& pos3, Pixel p = olc::WHITE);
+		// Flat fills a triangle by the half-space rule instead: only pixels inside all
+		// three edges, and a shared edge belongs to one side only, so a mesh has no
+		// gaps or overlaps. Only the part in the clip rectangle (cx,cy) to (cx+cw,cy+ch)
+		// is drawn, so a target can be split into tiles, each filled on its own thread
+		void FillTriangleHalfSpace(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p = olc::WHITE,
+			int32_t cx = 0, int32_t cy = 0, int32_t cw = INT32_MAX, int32_t ch = INT32_MAX);
 		// Draws an entire sprite at well location (x,y)
 		void DrawSprite(int32_t x, int32_t y, Sprite* sprite, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
 		void DrawSprite(const olc::vi2d& pos, Sprite* sprite, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
@@ -875,6 +963,16 @@ namespace olc
 		void DrawPartialSprite(int32_t x, int32_t y, Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
 		void DrawPartialSprite(const olc::vi2d& pos, Sprite* sprite, const olc::vi2d& sourcepos, const olc::vi2d& size, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
 
+		// Span shaders - like a custom pixel mode, but the shader's type is known
+		// at compile time, so it's inlined into the row loops instead of called
+		// through a std::function for every pixel. A shader is anything callable as
+		//     olc::Pixel shader(int x, int y, const olc::Pixel& pSource, const olc::Pixel& pDest)
+		// and decides what's written, whatever the pixel mode is
+		template<typename Shader> void FillRectShaded(int32_t x, int32_t y, int32_t w, int32_t h, Pixel p, Shader shader);
+		template<typename Shader> void DrawLineShaded(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Pixel p, Shader shader);
+		template<typename Shader> void DrawSpriteShaded(int32_t x, int32_t y, Sprite* sprite, Shader shader, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
+		template<typename Shader> void DrawPartialSpriteShaded(int32_t x, int32_t y, Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, Shader shader, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
+
 		// Decal Quad functions
 		void SetDecalMode(const olc::DecalMode& mode);
 		// Draws a whole decal, with optional scale and tinting
@@ -906,11 +1004,16 @@ namespace olc
 		// Draws a single line of text - traditional monospaced
 		void DrawString(int32_t x, int32_t y, const std::string& sText, Pixel col = olc::WHITE, uint32_t scale = 1);
 		void DrawString(const olc::vi2d& pos, const std::string& sText, Pixel col = olc::WHITE, uint32_t scale = 1);
+		// Without a std::string, for text formatted into a buffer every frame
+		void DrawString(int32_t x, int32_t y, const char* sText, Pixel col = olc::WHITE, uint32_t scale = 1);
+		void DrawString(const olc::vi2d& pos, const char* sText, Pixel col = olc::WHITE, uint32_t scale = 1);
 		olc::vi2d GetTextSize(const std::string& s);
 
 		// Draws a single line of text - non-monospaced
 		void DrawStringProp(int32_t x, int32_t y, const std::string& sText, Pixel col = olc::WHITE, uint32_t scale = 1);
 		void DrawStringProp(const olc::vi2d& pos, const std::string& sText, Pixel col = olc::WHITE, uint32_t scale = 1);
+		void DrawStringProp(int32_t x, int32_t y, const char* sText, Pixel col = olc::WHITE, uint32_t scale = 1);
+		void DrawStringProp(const olc::vi2d& pos, const char* sText, Pixel col = olc::WHITE, uint32_t scale = 1);
 		olc::vi2d GetTextSizeProp(const std::string& s);
 
 		// Clears entire draw target to Pixel
@@ -956,6 +1059,11 @@ namespace olc
 		std::function<olc::Pixel(const int x, const int y, const olc::Pixel&, const olc::Pixel&)> funcPixelMode;
 		std::chrono::time_point<std::chrono::system_clock> m_tp1, m_tp2;
 		std::vector<olc::vi2d> vFontSpacing;
+		// Each glyph's rows as bits, bit i lit if column i is, so text is drawn
+		// without reading the font sprite
+		uint8_t     nFontRows[96][8] = {};
+		std::vector<Pixel> vBlitRow;
+		HeadlessScript headlessScript;
 
 		// State of keyboard		
 		bool		pKeyNewState[256] = { 0 };
@@ -974,10 +1082,48 @@ namespace olc
 		// components to compile
 		void        olc_ConfigureSystem();
 
+		// Span kernels: whole runs of pixels written straight into the draw
+		// target, in the engine's pixel mode
+		bool        olc_CanWriteSpans(Pixel p) const;
+		void        olc_DrawSpan(int32_t x, int32_t y, int32_t count, Pixel p);
+		void        olc_BlitSprite(int32_t x, int32_t y, Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, int32_t scale, uint8_t flip);
+		// Behind DrawString and DrawStringProp
+		void        olc_DrawText(int32_t x, int32_t y, const char* sText, size_t nLength, Pixel col, uint32_t scale, bool bProportional);
+		// Behind the span shaders, and the custom pixel mode
+		template<typename Shader> void olc_ShadeSpan(int32_t x, int32_t y, int32_t count, const Pixel* src, int32_t srcStep, Shader& shader);
+
 		// If anything sets this flag to false, the engine
 		// "should" shut down gracefully
 		static std::atomic<bool> bAtomActive;
 
+	public:
+		// Span rasterizers and kernels, the drawing routines' insides. They don't
+		// touch the engine, so other threads can use them to draw into parts of a
+		// sprite of their own. Rasterizers call span(x, y, count) for each run of
+		// pixels along a row, clipped to [cx1,cx2) x [cy1,cy2) if they take a clip
+		// rectangle, otherwise not clipped at all
+		static void olc_FillSpan(Pixel* dst, int32_t count, Pixel p);
+		static void olc_BlendSpan(Pixel* dst, const Pixel* src, int32_t srcStep, int32_t count, float blend);
+		// One colour, or a row of texels, written as pixel mode NORMAL, MASK or ALPHA does
+		static void olc_WriteSpan(Pixel* dst, int32_t count, Pixel p, Pixel::Mode mode, float blend);
+		static void olc_WriteRow(Pixel* dst, const Pixel* src, int32_t count, Pixel::Mode mode, float blend);
+		template<typename Span> static void olc_LineSpans(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Span span);
+		template<typename Span> static void olc_CircleSpans(int32_t x, int32_t y, int32_t radius, uint8_t mask, Span span);
+		template<typename Span> static void olc_FillCircleSpans(int32_t x, int32_t y, int32_t radius, Span span);
+		template<typename Span> static void olc_FillTriangleSpans(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Span span);
+		template<typename Span> static void olc_TriangleSpans(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, int32_t cx1, int32_t cy1, int32_t cx2, int32_t cy2, Span span);
+		// MASK mode at scale 1: the w x h part at (ox,oy) of an image stride texels
+		// wide, drawn at (x,y) into target by copying only its opaque runs, laid out
+		// as Sprite::GetOpaqueRuns gives them. Writes through target's pColData and
+		// leaves its opaque runs alone, so several threads can draw into one target
+		// at once: the caller invalidates them first
+		static void olc_BlitOpaqueRuns(Sprite* target, int32_t x, int32_t y, const Pixel* texels, int32_t stride, const Sprite::OpaqueRun* runs, const uint32_t* rows,
+			int32_t ox, int32_t oy, int32_t w, int32_t h, uint8_t flip, int32_t cx1, int32_t cy1, int32_t cx2, int32_t cy2);
+		// row(x, y, texels, count) for each row of the sprite's image drawn at (x,y),
+		// scratch holding flipped or scaled rows. The source must be inside the sprite
+		template<typename Row> static void olc_BlitRows(int32_t x, int32_t y, Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, int32_t scale, uint8_t flip,
+			int32_t cx1, int32_t cy1, int32_t cx2, int32_t cy2, std::vector<Pixel>& scratch, Row row);
+
 	public:
 		// "Break In" Functions
 		void olc_UpdateMouse(int32_t x, int32_t y);
@@ -998,10 +1144,424 @@ namespace olc
 		// olc::vf2d	vSubPixelOffset = { 0.0f, 0.0f };
 
 		friend class PGEX;
+		friend class Platform_Headless;
 	};
 
 
 
+	// O------------------------------------------------------------------------------O
+	// | olcPixelGameEngine SPAN SHADERS - Templates, so defined with the declarations |
+	// O------------------------------------------------------------------------------O
+	template<typename Shader>
+	void PixelGameEngine::FillRectShaded(int32_t x, int32_t y, int32_t w, int32_t h, Pixel p, Shader shader)
+	{
+		if (!pDrawTarget) return;
+		int32_t y2 = std::min(y + h, pDrawTarget->height);
+		for (int32_t j = std::max(y, 0); j < y2; j++)
+			olc_ShadeSpan(x, j, w, &p, 0, shader);
+	}
+
+	template<typename Shader>
+	void PixelGameEngine::DrawLineShaded(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Pixel p, Shader shader)
+	{
+		if (!pDrawTarget) return;
+		olc_LineSpans(x1, y1, x2, y2, [&](int32_t x, int32_t y, int32_t count) { olc_ShadeSpan(x, y, count, &p, 0, shader); });
+	}
+
+	template<typename Shader>
+	void PixelGameEngine::DrawSpriteShaded(int32_t x, int32_t y, Sprite* sprite, Shader shader, uint32_t scale, uint8_t flip)
+	{
+		if (sprite == nullptr) return;
+		DrawPartialSpriteShaded(x, y, sprite, 0, 0, sprite->width, sprite->height, shader, scale, flip);
+	}
+
+	template<typename Shader>
+	void PixelGameEngine::DrawPartialSpriteShaded(int32_t x, int32_t y, Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, Shader shader, uint32_t scale, uint8_t flip)
+	{
+		if (sprite == nullptr || !pDrawTarget) return;
+		int32_t nScale = (int32_t)std::max(scale, 1u);
+		if (ox >= 0 && oy >= 0 && ox + w <= sprite->width && oy + h <= sprite->height)
+		{
+			olc_BlitRows(x, y, sprite, ox, oy, w, h, nScale, flip, 0, 0, pDrawTarget->width, pDrawTarget->height, vBlitRow,
+				[&](int32_t dx, int32_t dy, const Pixel* pRow, int32_t nCount) { olc_ShadeSpan(dx, dy, nCount, pRow, 1, shader); });
+			return;
+		}
+
+		// Source hanging off the sprite, so texel by texel through GetPixel
+		bool bFlipX = (flip & olc::Sprite::Flip::HORIZ) != 0;
+		bool bFlipY = (flip & olc::Sprite::Flip::VERT) != 0;
+		for (int32_t j = 0; j < h * nScale; j++)
+			for (int32_t i = 0; i < w * nScale; i++)
+			{
+				Pixel t = sprite->GetPixel(ox + (bFlipX ? w - 1 - i / nScale : i / nScale), oy + (bFlipY ? h - 1 - j / nScale : j / nScale));
+				olc_ShadeSpan(x + i, y + j, 1, &t, 0, shader);
+			}
+	}
+
+	template<typename Shader>
+	void PixelGameEngine::olc_ShadeSpan(int32_t x, int32_t y, int32_t count, const Pixel* src, int32_t srcStep, Shader& shader)
+	{
+		// Clipped once, then the shader called inline along the row. src
+		// steps by srcStep per pixel, 0 for one colour
+		if (!pDrawTarget || y < 0 || y >= pDrawTarget->height) return;
+		if (x < 0) { src -= x * srcStep; count += x; x = 0; }
+		count = std::min(count, pDrawTarget->width - x);
+		Pixel* dst = pDrawTarget->GetData() + y * pDrawTarget->width + x;
+		for (int32_t i = 0; i < count; i++)
+			dst[i] = shader(x + i, y, src[i * srcStep], dst[i]);
+	}
+
+	template<typename Row>
+	void PixelGameEngine::olc_BlitRows(int32_t x, int32_t y, Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, int32_t scale, uint8_t flip,
+		int32_t cx1, int32_t cy1, int32_t cx2, int32_t cy2, std::vector<Pixel>& scratch, Row row)
+	{
+		// Clipped once, up front
+		int32_t dx1 = std::max(x, cx1), dy1 = std::max(y, cy1);
+		int32_t dx2 = std::min(x + w * scale, cx2), dy2 = std::min(y + h * scale, cy2);
+		if (dx2 <= dx1 || dy2 <= dy1) return;
+		int32_t nCount = dx2 - dx1;
+
+		bool bFlipX = (flip & olc::Sprite::Flip::HORIZ) != 0;
+		bool bFlipY = (flip & olc::Sprite::Flip::VERT) != 0;
+		// Unflipped, unscaled rows are read straight from the sprite, anything
+		// else is laid out in scratch once per source row
+		bool bDirect = scale == 1 && !bFlipX;
+		if (!bDirect && (int32_t)scratch.size() < nCount) scratch.resize(nCount);
+
+		int32_t nLastRow = -1;
+		const Pixel* pRow = nullptr;
+		for (int32_t dy = dy1; dy < dy2; dy++)
+		{
+			int32_t j = (dy - y) / scale;
+			if (j != nLastRow)
+			{
+				nLastRow = j;
+				const Pixel* pSrc = sprite->pColData + (oy + (bFlipY ? h - 1 - j : j)) * sprite->width + ox;
+				if (bDirect)
+					pRow = pSrc + (dx1 - x);
+				else
+				{
+					// Each texel repeated scale times, walking the source backwards if flipped
+					int32_t i = (dx1 - x) / scale, nRun = scale - (dx1 - x) % scale;
+					Pixel* pOut = scratch.data();
+					for (int32_t n = 0; n < nCount; i++, nRun = scale)
+					{
+						Pixel t = pSrc[bFlipX ? w - 1 - i : i];
+						for (int32_t r = std::min(nRun, nCount - n); r > 0; r--, n++) *pOut++ = t;
+					}
+					pRow = scratch.data();
+				}
+			}
+			row(dx1, dy, pRow, nCount);
+		}
+	}
+
+	template<typename Span>
+	void PixelGameEngine::olc_LineSpans(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Span span)
+	{
+		// The pixels DrawLine's Bresenham picks, as horizontal runs span(x, y, count),
+		// unclipped. Steep lines are a run per pixel
+		int32_t dx = x2 - x1, dy = y2 - y1;
+		int32_t dx1 = std::abs(dx), dy1 = std::abs(dy);
+		if (dy == 0) { span(std::min(x1, x2), y1, dx1 + 1); return; }
+		if (dx == 0) { for (int32_t y = std::min(y1, y2); y <= std::max(y1, y2); y++) span(x1, y, 1); return; }
+
+		int32_t nStep = (dx < 0) == (dy < 0) ? 1 : -1;
+		if (dy1 <= dx1)
+		{
+			int32_t x = dx >= 0 ? x1 : x2, y = dx >= 0 ? y1 : y2, xe = dx >= 0 ? x2 : x1;
+			int32_t px = 2 * dy1 - dx1, nStart = x;
+			while (x < xe)
+			{
+				x++;
+				if (px < 0)
+					px += 2 * dy1;
+				else
+				{
+					span(nStart, y, x - nStart);
+					nStart = x; y += nStep;
+					px += 2 * (dy1 - dx1);
+				}
+			}
+			span(nStart, y, x - nStart + 1);
+		}
+		else
+		{
+			int32_t x = dy >= 0 ? x1 : x2, y = dy >= 0 ? y1 : y2, ye = dy >= 0 ? y2 : y1;
+			int32_t py = 2 * dx1 - dy1;
+			span(x, y, 1);
+			while (y < ye)
+			{
+				y++;
+				if (py <= 0)
+					py += 2 * dx1;
+				else
+				{
+					x += nStep;
+					py += 2 * (dx1 - dy1);
+				}
+				span(x, y, 1);
+			}
+		}
+	}
+
+	template<typename Span>
+	void PixelGameEngine::olc_CircleSpans(int32_t x, int32_t y, int32_t radius, uint8_t mask, Span span)
+	{ // Thanks to IanM-Matrix1 #PR121
+		if (radius < 0) return;
+		if (radius == 0) { span(x, y, 1); return; }
+
+		int x0 = 0;
+		int y0 = radius;
+		int d = 3 - 2 * radius;
+		int nRunStart = 0;
+
+		while (y0 >= x0) // only formulate 1/8 of circle
+		{
+			// Octants at the sides are steep, a pixel per row
+			if (mask & 0x04) span(x + y0, y + x0, 1);// Q4 - lower lower right
+			if (mask & 0x40) span(x - y0, y - x0, 1);// Q0 - upper upper left
+			if (x0 != 0 && x0 != y0)
+			{
+				if (mask & 0x02) span(x + y0, y - x0, 1);// Q7 - upper upper right
+				if (mask & 0x20) span(x - y0, y + x0, 1);// Q3 - lower lower left
+			}
+
+			// Octants at the top and bottom are shallow: pixels x0 = nRunStart..x0
+			// share a row, drawn as one span once y0 is about to change
+			if (d >= 0 || x0 + 1 > y0)
+			{
+				int n = x0 - nRunStart + 1;
+				if (mask & 0x01) span(x + nRunStart, y - y0, n);// Q6 - upper right right
+				if (mask & 0x10) span(x - x0, y + y0, n);// Q2 - lower left left
+				int a = std::max(nRunStart, 1), b = x0 == y0 ? x0 - 1 : x0;
+				if (b >= a)
+				{
+					if (mask & 0x08) span(x + a, y + y0, b - a + 1);// Q5 - lower right right
+					if (mask & 0x80) span(x - b, y - y0, b - a + 1);// Q1 - upper left left
+				}
+				nRunStart = x0 + 1;
+			}
+
+			if (d < 0)
+				d += 4 * x0++ + 6;
+			else
+				d += 4 * (x0++ - y0--) + 10;
+		}
+	}
+
+	template<typename Span>
+	void PixelGameEngine::olc_FillCircleSpans(int32_t x, int32_t y, int32_t radius, Span span)
+	{ // Thanks to IanM-Matrix1 #PR121
+		if (radius < 0) return;
+		if (radius == 0) { span(x, y, 1); return; }
+
+		int x0 = 0;
+		int y0 = radius;
+		int d = 3 - 2 * radius;
+
+		auto drawline = [&](int sx, int ex, int y) { span(sx, y, ex - sx + 1); };
+
+		while (y0 >= x0)
+		{
+			drawline(x - y0, x + y0, y - x0);
+			if (x0 > 0)	drawline(x - y0, x + y0, y + x0);
+
+			if (d < 0)
+				d += 4 * x0++ + 6;
+			else
+			{
+				if (x0 != y0)
+				{
+					drawline(x - x0, x + x0, y - y0);
+					drawline(x - x0, x + x0, y + y0);
+				}
+				d += 4 * (x0++ - y0--) + 10;
+			}
+		}
+	}
+
+	// https://www.avrfreaks.net/sites/default/files/triangles.c
+	template<typename Span>
+	void PixelGameEngine::olc_FillTriangleSpans(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Span span)
+	{
+		auto drawline = [&](int sx, int ex, int ny) { span(sx, ny, ex - sx + 1); };
+
+		int t1x, t2x, y, minx, maxx, t1xp, t2xp;
+		bool changed1 = false;
+		bool changed2 = false;
+		int signx1, signx2, dx1, dy1, dx2, dy2;
+		int e1, e2;
+		// Sort vertices
+		if (y1 > y2) { std::swap(y1, y2); std::swap(x1, x2); }
+		if (y1 > y3) { std::swap(y1, y3); std::swap(x1, x3); }
+		if (y2 > y3) { std::swap(y2, y3); std::swap(x2, x3); }
+
+		t1x = t2x = x1; y = y1;   // Starting points
+		dx1 = (int)(x2 - x1);
+		if (dx1 < 0) { dx1 = -dx1; signx1 = -1; }
+		else signx1 = 1;
+		dy1 = (int)(y2 - y1);
+
+		dx2 = (int)(x3 - x1);
+		if (dx2 < 0) { dx2 = -dx2; signx2 = -1; }
+		else signx2 = 1;
+		dy2 = (int)(y3 - y1);
+
+		if (dy1 > dx1) { std::swap(dx1, dy1); changed1 = true; }
+		if (dy2 > dx2) { std::swap(dy2, dx2); changed2 = true; }
+
+		e2 = (int)(dx2 >> 1);
+		// Flat top, just process the second half
+		if (y1 == y2) goto next;
+		e1 = (int)(dx1 >> 1);
+
+		for (int i = 0; i < dx1;) {
+			t1xp = 0; t2xp = 0;
+			if (t1x < t2x) { minx = t1x; maxx = t2x; }
+			else { minx = t2x; maxx = t1x; }
+			// process first line until y value is about to change
+			while (i < dx1) {
+				i++;
+				e1 += dy1;
+				while (e1 >= dx1) {
+					e1 -= dx1;
+					if (changed1) t1xp = signx1;//t1x += signx1;
+					else          goto next1;
+				}
+				if (changed1) break;
+				else t1x += signx1;
+			}
+			// Move line
+		next1:
+			// process second line until y value is about to change
+			while (1) {
+				e2 += dy2;
+				while (e2 >= dx2) {
+					e2 -= dx2;
+					if (changed2) t2xp = signx2;//t2x += signx2;
+					else          goto next2;
+				}
+				if (changed2)     break;
+				else              t2x += signx2;
+			}
+		next2:
+			if (minx > t1x) minx = t1x;
+			if (minx > t2x) minx = t2x;
+			if (maxx < t1x) maxx = t1x;
+			if (maxx < t2x) maxx = t2x;
+			drawline(minx, maxx, y);    // Draw line from min to max points found on the y
+										// Now increase y
+			if (!changed1) t1x += signx1;
+			t1x += t1xp;
+			if (!changed2) t2x += signx2;
+			t2x += t2xp;
+			y += 1;
+			if (y == y2) break;
+
+		}
+	next:
+		// Second half
+		dx1 = (int)(x3 - x2); if (dx1 < 0) { dx1 = -dx1; signx1 = -1; }
+		else signx1 = 1;
+		dy1 = (int)(y3 - y2);
+		t1x = x2;
+
+		if (dy1 > dx1) {   // swap values
+			std::swap(dy1, dx1);
+			changed1 = true;
+		}
+		else changed1 = false;
+
+		e1 = (int)(dx1 >> 1);
+
+		for (int i = 0; i <= dx1; i++) {
+			t1xp = 0; t2xp = 0;
+			if (t1x < t2x) { minx = t1x; maxx = t2x; }
+			else { minx = t2x; maxx = t1x; }
+			// process first line until y value is about to change
+			while (i < dx1) {
+				e1 += dy1;
+				while (e1 >= dx1) {
+					e1 -= dx1;
+					if (changed1) { t1xp = signx1; break; }//t1x += signx1;
+					else          goto next3;
+				}
+				if (changed1) break;
+				else   	   	  t1x += signx1;
+				if (i < dx1) i++;
+			}
+		next3:
+			// process second line until y value is about to change
+			while (t2x != x3) {
+				e2 += dy2;
+				while (e2 >= dx2) {
+					e2 -= dx2;
+					if (changed2) t2xp = signx2;
+					else          goto next4;
+				}
+				if (changed2)     break;
+				else              t2x += signx2;
+			}
+		next4:
+
+			if (minx > t1x) minx = t1x;
+			if (minx > t2x) minx = t2x;
+			if (maxx < t1x) maxx = t1x;
+			if (maxx < t2x) maxx = t2x;
+			drawline(minx, maxx, y);
+			if (!changed1) t1x += signx1;
+			t1x += t1xp;
+			if (!changed2) t2x += signx2;
+			t2x += t2xp;
+			y += 1;
+			if (y > y3) return;
+		}
+	}
+
+	template<typename Span>
+	void PixelGameEngine::olc_TriangleSpans(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, int32_t cx1, int32_t cy1, int32_t cx2, int32_t cy2, Span span)
+	{
+		// Half-space rasterizer: a pixel is inside when each edge function
+		// a*x + b*y + c is positive there. Per row, each edge bounds x from one side,
+		// so a row is one span(x, y, count), already clipped to [cx1,cx2) x [cy1,cy2).
+		// On an edge (edge function 0) a pixel belongs to the side the edge's normal
+		// points away from, so triangles sharing that edge don't both draw it
+		int64_t nArea = (int64_t)(x2 - x1) * (y3 - y1) - (int64_t)(y2 - y1) * (x3 - x1);
+		if (nArea == 0) return;
+		if (nArea < 0) { std::swap(x2, x3); std::swap(y2, y3); }
+
+		struct Edge { int64_t a, b, c, bias; };
+		auto edge = [](int32_t xa, int32_t ya, int32_t xb, int32_t yb)
+		{
+			Edge e;
+			e.a = -(int64_t)(yb - ya); e.b = (int64_t)xb - xa;
+			e.c = -e.a * xa - e.b * ya;
+			e.bias = (e.a > 0 || (e.a == 0 && e.b > 0)) ? 0 : 1;
+			return e;
+		};
+		const Edge edges[3] = { edge(x1, y1, x2, y2), edge(x2, y2, x3, y3), edge(x3, y3, x1, y1) };
+		auto floorDiv = [](int64_t n, int64_t d) { int64_t q = n / d; return (q * d != n && ((n < 0) != (d < 0))) ? q - 1 : q; };
+
+		int32_t ry1 = std::max({ std::min({ y1, y2, y3 }), cy1 }), ry2 = std::min(std::max({ y1, y2, y3 }) + 1, cy2);
+		int32_t rx1 = std::max({ std::min({ x1, x2, x3 }), cx1 }), rx2 = std::min(std::max({ x1, x2, x3 }) + 1, cx2);
+		for (int32_t y = ry1; y < ry2; y++)
+		{
+			// Inside where a*x >= bias - b*y - c for every edge
+			int64_t xl = rx1, xr = (int64_t)rx2 - 1;
+			for (const Edge& e : edges)
+			{
+				int64_t k = e.bias - e.b * y - e.c;
+				if (e.a > 0) xl = std::max(xl, -floorDiv(-k, e.a));
+				else if (e.a < 0) xr = std::min(xr, floorDiv(-k, -e.a));
+				else if (k > 0) xr = xl - 1;
+			}
+			if (xr >= xl) span((int32_t)xl, y, (int32_t)(xr - xl + 1));
+		}
+	}
+
+
+
 	// O------------------------------------------------------------------------------O
 	// | PGE EXTENSION BASE CLASS - Permits access to PGE functions from extension    |
 	// O------------------------------------------------------------------------------O
@@ -1182,6 +1742,7 @@ namespace olc
 
 	olc::rcode Sprite::LoadFromPGESprFile(const std::string& sImageFile, olc::ResourcePack* pack)
 	{
+		InvalidateOpaqueRuns();
 		if (pColData) delete[] pColData;
 		auto ReadData = [&](std::istream& is)
 		{
@@ -1261,7 +1822,9 @@ namespace olc
 	{
 		if (x >= 0 && x < width && y >= 0 && y < height)
 		{
-			pColData[y * width + x] = p;
+			Pixel& t = pColData[y * width + x];
+			if ((t.a == 255) != (p.a == 255)) InvalidateOpaqueRuns();
+			t = p;
 			return true;
 		}
 		else
@@ -1298,12 +1861,41 @@ namespace olc
 	}
 
 	Pixel* Sprite::GetData()
-	{ return pColData; }
+	{ InvalidateOpaqueRuns(); return pColData; }
 
+	void Sprite::InvalidateOpaqueRuns()
+	{ bOpaqueRunsValid = false; }
 
-	olc::rcode Sprite::LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack)
+	void Sprite::GetOpaqueRuns(const OpaqueRun*& runs, const uint32_t*& rows)
+	{
+		if (!bOpaqueRunsValid)
+		{
+			vOpaqueRuns.clear();
+			vOpaqueRows.resize(height + 1);
+			for (int32_t y = 0; y < height; y++)
+			{
+				vOpaqueRows[y] = (uint32_t)vOpaqueRuns.size();
+				const Pixel* pRow = pColData + y * width;
+				for (int32_t x = 0; x < width;)
+				{
+					while (x < width && pRow[x].a != 255) x++;
+					int32_t nStart = x;
+					while (x < width && pRow[x].a == 255) x++;
+					if (x > nStart) vOpaqueRuns.push_back({ nStart, x - nStart });
+				}
+			}
+			vOpaqueRows[height] = (uint32_t)vOpaqueRuns.size();
+			bOpaqueRunsValid = true;
+		}
+		runs = vOpaqueRuns.data();
+		rows = vOpaqueRows.data();
+	}
+
+
+	olc::rcode Sprite::LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack)
 	{
 		UNUSED(pack);
+		InvalidateOpaqueRuns();
 		return loader->LoadImageResource(this, sImageFile, pack);
 	}
 
@@ -1381,6 +1973,33 @@ namespace olc
 	olc::Sprite* Renderable::Sprite() const
 	{ return pSprite.get(); }
 
+	// O------------------------------------------------------------------------------O
+	// | olc::HeadlessScript IMPLEMENTATION                                           |
+	// O------------------------------------------------------------------------------O
+	HeadlessScript& HeadlessScript::AddKey(uint32_t frame, olc::Key k, bool bDown)
+	{
+		vEvents.push_back({ frame, Event::KEY, int32_t(k), bDown ? 1 : 0 });
+		return *this;
+	}
+
+	HeadlessScript& HeadlessScript::AddMouseButton(uint32_t frame, uint32_t b, bool bDown)
+	{
+		vEvents.push_back({ frame, Event::MOUSE_BUTTON, int32_t(b), bDown ? 1 : 0 });
+		return *this;
+	}
+
+	HeadlessScript& HeadlessScript::AddMouseMove(uint32_t frame, int32_t x, int32_t y)
+	{
+		vEvents.push_back({ frame, Event::MOUSE_MOVE, x, y });
+		return *this;
+	}
+
+	HeadlessScript& HeadlessScript::AddMouseWheel(uint32_t frame, int32_t delta)
+	{
+		vEvents.push_back({ frame, Event::MOUSE_WHEEL, delta, 0 });
+		return *this;
+	}
+
 	// O------------------------------------------------------------------------------O
 	// | olc::ResourcePack IMPLEMENTATION                                             |
 	// O------------------------------------------------------------------------------O
@@ -1699,6 +2318,19 @@ namespace olc
 		if (layer < vLayers.size()) vLayers[layer].funcHook = f;
 	}
 
+	void PixelGameEngine::SetLayerUpdateRows(uint8_t layer, int32_t y, int32_t rows)
+	{
+		if (layer >= vLayers.size()) return;
+		LayerDesc& ld = vLayers[layer];
+		int32_t y2 = std::min(y + rows, ld.pDrawTarget->height);
+		y = std::max(y, 0);
+		if (y2 <= y) { y = 0; y2 = 0; }
+		// Several calls in one frame add up
+		if (ld.nUpdateRowsEnd < 0 || ld.nUpdateRowsEnd == ld.nUpdateRowsBegin) { ld.nUpdateRowsBegin = y; ld.nUpdateRowsEnd = y2; }
+		else if (y2 > y) { ld.nUpdateRowsBegin = std::min(ld.nUpdateRowsBegin, y); ld.nUpdateRowsEnd = std::max(ld.nUpdateRowsEnd, y2); }
+		ld.bUpdate = true;
+	}
+
 	std::vector<LayerDesc>& PixelGameEngine::GetLayers()
 	{ return vLayers; }
 
@@ -1715,6 +2347,9 @@ namespace olc
 	Sprite* PixelGameEngine::GetDrawTarget() const
 	{ return pDrawTarget; }
 
+	const Sprite* PixelGameEngine::GetFontSprite() const
+	{ return fontSprite; }
+
 	int32_t PixelGameEngine::GetDrawTargetWidth() const
 	{
 		if (pDrawTarget)
@@ -1773,6 +2408,16 @@ namespace olc
 	const olc::vi2d& PixelGameEngine::GetScreenPixelSize() const
 	{ return vScreenPixelSize; }
 
+	const olc::Sprite* PixelGameEngine::GetFrameBuffer() const
+	{ return renderer->GetFrameBuffer(); }
+
+	void PixelGameEngine::SetHeadlessScript(const HeadlessScript& script)
+	{
+		headlessScript = script;
+		std::stable_sort(headlessScript.vEvents.begin(), headlessScript.vEvents.end(),
+			[](const HeadlessScript::Event& a, const HeadlessScript::Event& b) { return a.nFrame < b.nFrame; });
+	}
+
 	const olc::vi2d& PixelGameEngine::GetWindowMouse() const
 	{ return vMouseWindowPos; }
 
@@ -1800,23 +2445,136 @@ namespace olc
 
 		if (nPixelMode == Pixel::ALPHA)
 		{
-			Pixel d = pDrawTarget->GetPixel(x, y);
-			float a = (float)(p.a / 255.0f) * fBlendFactor;
-			float c = 1.0f - a;
-			float r = a * (float)p.r + c * (float)d.r;
-			float g = a * (float)p.g + c * (float)d.g;
-			float b = a * (float)p.b + c * (float)d.b;
-			return pDrawTarget->SetPixel(x, y, Pixel((uint8_t)r, (uint8_t)g, (uint8_t)b/*, (uint8_t)(p.a * fBlendFactor)*/));
+			if (x < 0 || x >= pDrawTarget->width || y < 0 || y >= pDrawTarget->height) return false;
+			olc_BlendSpan(pDrawTarget->GetData() + y * pDrawTarget->width + x, &p, 0, 1, fBlendFactor);
+			return true;
 		}
 
 		if (nPixelMode == Pixel::CUSTOM)
 		{
-			return pDrawTarget->SetPixel(x, y, funcPixelMode(x, y, p, pDrawTarget->GetPixel(x, y)));
+			if (x < 0 || x >= pDrawTarget->width || y < 0 || y >= pDrawTarget->height) return false;
+			olc_ShadeSpan(x, y, 1, &p, 0, funcPixelMode);
+			return true;
 		}
 
 		return false;
 	}
 
+	bool PixelGameEngine::olc_CanWriteSpans(Pixel p) const
+	{
+		// MASK with an opaque pixel writes exactly what NORMAL does
+		return pDrawTarget && (nPixelMode == Pixel::NORMAL || (nPixelMode == Pixel::MASK && p.a == 255));
+	}
+
+	void PixelGameEngine::olc_FillSpan(Pixel* dst, int32_t count, Pixel p)
+	{
+		int32_t i = 0;
+#if defined(OLC_SIMD_SSE2)
+		// Pixels up to a 16 byte boundary, then 4 at a time
+		for (; i < count && (reinterpret_cast<uintptr_t>(dst + i) & 15) != 0; i++) dst[i] = p;
+		const __m128i v = _mm_set1_epi32((int)p.n);
+		for (; i + 16 <= count; i += 16)
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(dst + i), v);
+			_mm_store_si128(reinterpret_cast<__m128i*>(dst + i + 4), v);
+			_mm_store_si128(reinterpret_cast<__m128i*>(dst + i + 8), v);
+			_mm_store_si128(reinterpret_cast<__m128i*>(dst + i + 12), v);
+		}
+		for (; i + 4 <= count; i += 4)
+			_mm_store_si128(reinterpret_cast<__m128i*>(dst + i), v);
+#endif
+		for (; i < count; i++) dst[i] = p;
+	}
+
+	void PixelGameEngine::olc_BlendSpan(Pixel* dst, const Pixel* src, int32_t srcStep, int32_t count, float blend)
+	{
+		// ALPHA mode in integers: a = src.a * blend, then each channel is
+		// (src * a + dst * (255 - a)) / 255, rounded, and the result is opaque.
+		// srcStep is 1 to walk src alongside dst, 0 to blend the same pixel
+		// all the way. Each channel is within 1 of the float formula, or 2 with a
+		// SetPixelBlend below 1, since blend is rounded to 1/256ths.
+		int32_t nBlend = std::min(std::max((int32_t)(blend * 256.0f + 0.5f), 0), 256);
+		int32_t i = 0;
+#if defined(OLC_SIMD_AVX2)
+		{
+			// As the SSE2 loop below, 8 pixels at a time
+			const __m256i zero = _mm256_setzero_si256(), k255 = _mm256_set1_epi16(255), k128 = _mm256_set1_epi16(128);
+			const __m256i vBlend = _mm256_set1_epi16((short)nBlend), opaque = _mm256_set1_epi32((int)0xFF000000);
+			auto mix = [&](__m256i s16, __m256i d16)
+			{
+				__m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s16, 0xFF), 0xFF);
+				a = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(a, vBlend), k128), 8);
+				__m256i x = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s16, a), _mm256_mullo_epi16(d16, _mm256_sub_epi16(k255, a))), k128);
+				return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+			};
+			const __m256i sConst = _mm256_set1_epi32((int)src->n);
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256i s = srcStep ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)) : sConst;
+				__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+				__m256i lo = mix(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+				__m256i hi = mix(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(_mm256_packus_epi16(lo, hi), opaque));
+			}
+		}
+#endif
+#if defined(OLC_SIMD_SSE2)
+		{
+			// 4 pixels at a time, each widened to 16 bits per channel. x / 255,
+			// rounded, is (x + 128 + ((x + 128) >> 8)) >> 8, and nothing
+			// overflows 16 bits: src * a + dst * (255 - a) + 128 <= 65153
+			const __m128i zero = _mm_setzero_si128(), k255 = _mm_set1_epi16(255), k128 = _mm_set1_epi16(128);
+			const __m128i vBlend = _mm_set1_epi16((short)nBlend), opaque = _mm_set1_epi32((int)0xFF000000);
+			auto mix = [&](__m128i s16, __m128i d16)
+			{
+				__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s16, 0xFF), 0xFF);
+				a = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(a, vBlend), k128), 8);
+				__m128i x = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s16, a), _mm_mullo_epi16(d16, _mm_sub_epi16(k255, a))), k128);
+				return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+			};
+			const __m128i sConst = _mm_set1_epi32((int)src->n);
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i s = srcStep ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)) : sConst;
+				__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+				__m128i lo = mix(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+				__m128i hi = mix(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_packus_epi16(lo, hi), opaque));
+			}
+		}
+#endif
+		for (; i < count; i++)
+		{
+			Pixel ps = src[i * srcStep], pd = dst[i];
+			uint32_t a = (ps.a * nBlend + 128) >> 8, c = 255 - a;
+			auto mix = [&](uint32_t s, uint32_t d) { uint32_t x = s * a + d * c + 128; return uint8_t((x + (x >> 8)) >> 8); };
+			dst[i] = Pixel(mix(ps.r, pd.r), mix(ps.g, pd.g), mix(ps.b, pd.b));
+		}
+	}
+
+	void PixelGameEngine::olc_DrawSpan(int32_t x, int32_t y, int32_t count, Pixel p)
+	{
+		// A row of one colour, clipped, in whatever the pixel mode is
+		if (!pDrawTarget || y < 0 || y >= pDrawTarget->height) return;
+		int32_t x2 = std::min(x + count, pDrawTarget->width);
+		x = std::max(x, 0);
+		if (x2 <= x) return;
+		if (nPixelMode == Pixel::CUSTOM)
+			olc_ShadeSpan(x, y, x2 - x, &p, 0, funcPixelMode);
+		else
+			olc_WriteSpan(pDrawTarget->GetData() + y * pDrawTarget->width + x, x2 - x, p, nPixelMode, fBlendFactor);
+	}
+
+	void PixelGameEngine::olc_WriteSpan(Pixel* dst, int32_t count, Pixel p, Pixel::Mode mode, float blend)
+	{
+		// MASK with an opaque pixel writes exactly what NORMAL does, and nothing
+		// with a see-through one
+		if (mode == Pixel::NORMAL || (mode == Pixel::MASK && p.a == 255))
+			olc_FillSpan(dst, count, p);
+		else if (mode == Pixel::ALPHA)
+			olc_BlendSpan(dst, &p, 0, count, blend);
+	}
+
 
 	void PixelGameEngine::DrawLine(const olc::vi2d& pos1, const olc::vi2d& pos2, Pixel p, uint32_t pattern)
 	{
@@ -1830,10 +2588,21 @@ namespace olc
 
 		auto rol = [&](void) { pattern = (pattern << 1) | (pattern >> 31); return pattern & 1; };
 
+		// Solid straight lines skip Draw, clipped once and written as a span
+		bool bSpan = pattern == 0xFFFFFFFF && olc_CanWriteSpans(p);
+
 		// straight lines idea by gurkanctn
 		if (dx == 0) // Line is vertical
 		{
 			if (y2 < y1) std::swap(y1, y2);
+			if (bSpan)
+			{
+				if (x1 < 0 || x1 >= pDrawTarget->width) return;
+				y1 = std::max(y1, 0); y2 = std::min(y2, pDrawTarget->height - 1);
+				Pixel* m = pDrawTarget->GetData() + y1 * pDrawTarget->width + x1;
+				for (y = y1; y <= y2; y++, m += pDrawTarget->width) *m = p;
+				return;
+			}
 			for (y = y1; y <= y2; y++) if (rol()) Draw(x1, y, p);
 			return;
 		}
@@ -1841,10 +2610,29 @@ namespace olc
 		if (dy == 0) // Line is horizontal
 		{
 			if (x2 < x1) std::swap(x1, x2);
+			if (pattern == 0xFFFFFFFF && pDrawTarget)
+			{
+				olc_DrawSpan(x1, y1, x2 - x1 + 1, p);
+				return;
+			}
 			for (x = x1; x <= x2; x++) if (rol()) Draw(x, y1, p);
 			return;
 		}
 
+		// Solid diagonal lines as the runs of pixels they have on each row,
+		// written straight in when the whole line is on the draw target
+		if (pattern == 0xFFFFFFFF && pDrawTarget)
+		{
+			if (bSpan && std::min(x1, x2) >= 0 && std::max(x1, x2) < pDrawTarget->width && std::min(y1, y2) >= 0 && std::max(y1, y2) < pDrawTarget->height)
+				olc_LineSpans(x1, y1, x2, y2, [&](int32_t sx, int32_t sy, int32_t count)
+				{
+					for (Pixel* m = pDrawTarget->GetData() + sy * pDrawTarget->width + sx; count > 0; count--) *m++ = p;
+				});
+			else
+				olc_LineSpans(x1, y1, x2, y2, [&](int32_t sx, int32_t sy, int32_t count) { olc_DrawSpan(sx, sy, count, p); });
+			return;
+		}
+
 		// Line is Funk-aye
 		dx1 = abs(dx); dy1 = abs(dy);
 		px = 2 * dy1 - dx1;	py = 2 * dx1 - dy1;
@@ -1912,35 +2700,14 @@ namespace olc
 		if (radius < 0 || x < -radius || y < -radius || x - GetDrawTargetWidth() > radius || y - GetDrawTargetHeight() > radius)
 			return;
 
-		if (radius > 0)
-		{
-			int x0 = 0;
-			int y0 = radius;
-			int d = 3 - 2 * radius;
-
-			while (y0 >= x0) // only formulate 1/8 of circle
+		// Written straight in when the whole circle is on the draw target
+		if (olc_CanWriteSpans(p) && x >= radius && y >= radius && x + radius < pDrawTarget->width && y + radius < pDrawTarget->height)
+			olc_CircleSpans(x, y, radius, mask, [&](int32_t sx, int32_t sy, int32_t count)
 			{
-				// Draw even octants
-				if (mask & 0x01) Draw(x + x0, y - y0, p);// Q6 - upper right right
-				if (mask & 0x04) Draw(x + y0, y + x0, p);// Q4 - lower lower right
-				if (mask & 0x10) Draw(x - x0, y + y0, p);// Q2 - lower left left
-				if (mask & 0x40) Draw(x - y0, y - x0, p);// Q0 - upper upper left
-				if (x0 != 0 && x0 != y0)
-				{
-					if (mask & 0x02) Draw(x + y0, y - x0, p);// Q7 - upper upper right
-					if (mask & 0x08) Draw(x + x0, y + y0, p);// Q5 - lower right right
-					if (mask & 0x20) Draw(x - y0, y + x0, p);// Q3 - lower lower left
-					if (mask & 0x80) Draw(x - x0, y - y0, p);// Q1 - upper left left
-				}
-
-				if (d < 0)
-					d += 4 * x0++ + 6;
-				else
-					d += 4 * (x0++ - y0--) + 10;
-			}
-		}
+				for (Pixel* m = pDrawTarget->GetData() + sy * pDrawTarget->width + sx; count > 0; count--) *m++ = p;
+			});
 		else
-			Draw(x, y, p);
+			olc_CircleSpans(x, y, radius, mask, [&](int32_t sx, int32_t sy, int32_t count) { olc_DrawSpan(sx, sy, count, p); });
 	}
 
 	void PixelGameEngine::FillCircle(const olc::vi2d& pos, int32_t radius, Pixel p)
@@ -1953,38 +2720,7 @@ namespace olc
 		if (radius < 0 || x < -radius || y < -radius || x - GetDrawTargetWidth() > radius || y - GetDrawTargetHeight() > radius)
 			return;
 
-		if (radius > 0)
-		{
-			int x0 = 0;
-			int y0 = radius;
-			int d = 3 - 2 * radius;
-
-			auto drawline = [&](int sx, int ex, int y)
-			{
-				for (int x = sx; x <= ex; x++)
-					Draw(x, y, p);
-			};
-
-			while (y0 >= x0)
-			{
-				drawline(x - y0, x + y0, y - x0);
-				if (x0 > 0)	drawline(x - y0, x + y0, y + x0);
-
-				if (d < 0)
-					d += 4 * x0++ + 6;
-				else
-				{
-					if (x0 != y0)
-					{
-						drawline(x - x0, x + x0, y - y0);
-						drawline(x - x0, x + x0, y + y0);
-					}
-					d += 4 * (x0++ - y0--) + 10;
-				}
-			}
-		}
-		else
-			Draw(x, y, p);
+		olc_FillCircleSpans(x, y, radius, [&](int32_t sx, int32_t sy, int32_t count) { olc_DrawSpan(sx, sy, count, p); });
 	}
 
 	void PixelGameEngine::DrawRect(const olc::vi2d& pos, const olc::vi2d& size, Pixel p)
@@ -2004,7 +2740,7 @@ namespace olc
 	{
 		int pixels = GetDrawTargetWidth() * GetDrawTargetHeight();
 		Pixel* m = GetDrawTarget()->GetData();
-		for (int i = 0; i < pixels; i++) m[i] = p;
+		olc_FillSpan(m, pixels, p);
 	}
 
 	void PixelGameEngine::ClearBuffer(Pixel p, bool bDepth)
@@ -2032,9 +2768,9 @@ namespace olc
 		if (y2 < 0) y2 = 0;
 		if (y2 >= (int32_t)GetDrawTargetHeight()) y2 = (int32_t)GetDrawTargetHeight();
 
-		for (int i = x; i < x2; i++)
-			for (int j = y; j < y2; j++)
-				Draw(i, j, p);
+		// Row by row, the order the pixels are laid out in
+		for (int j = y; j < y2; j++)
+			olc_DrawSpan(x, j, x2 - x, p);
 	}
 
 	void PixelGameEngine::DrawTriangle(const olc::vi2d& pos1, const olc::vi2d& pos2, const olc::vi2d& pos3, Pixel p)
@@ -2054,141 +2790,18 @@ namespace olc
 		FillTriangle(pos1.x, pos1.y, pos2.x, pos2.y, pos3.x, pos3.y, p);
 	}
 
-	// https://www.avrfreaks.net/sites/default/files/triangles.c
 	void PixelGameEngine::FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p)
 	{
-		auto drawline = [&](int sx, int ex, int ny) { for (int i = sx; i <= ex; i++) Draw(i, ny, p); };
-
-		int t1x, t2x, y, minx, maxx, t1xp, t2xp;
-		bool changed1 = false;
-		bool changed2 = false;
-		int signx1, signx2, dx1, dy1, dx2, dy2;
-		int e1, e2;
-		// Sort vertices
-		if (y1 > y2) { std::swap(y1, y2); std::swap(x1, x2); }
-		if (y1 > y3) { std::swap(y1, y3); std::swap(x1, x3); }
-		if (y2 > y3) { std::swap(y2, y3); std::swap(x2, x3); }
-
-		t1x = t2x = x1; y = y1;   // Starting points
-		dx1 = (int)(x2 - x1);
-		if (dx1 < 0) { dx1 = -dx1; signx1 = -1; }
-		else signx1 = 1;
-		dy1 = (int)(y2 - y1);
-
-		dx2 = (int)(x3 - x1);
-		if (dx2 < 0) { dx2 = -dx2; signx2 = -1; }
-		else signx2 = 1;
-		dy2 = (int)(y3 - y1);
-
-		if (dy1 > dx1) { std::swap(dx1, dy1); changed1 = true; }
-		if (dy2 > dx2) { std::swap(dy2, dx2); changed2 = true; }
-
-		e2 = (int)(dx2 >> 1);
-		// Flat top, just process the second half
-		if (y1 == y2) goto next;
-		e1 = (int)(dx1 >> 1);
-
-		for (int i = 0; i < dx1;) {
-			t1xp = 0; t2xp = 0;
-			if (t1x < t2x) { minx = t1x; maxx = t2x; }
-			else { minx = t2x; maxx = t1x; }
-			// process first line until y value is about to change
-			while (i < dx1) {
-				i++;
-				e1 += dy1;
-				while (e1 >= dx1) {
-					e1 -= dx1;
-					if (changed1) t1xp = signx1;//t1x += signx1;
-					else          goto next1;
-				}
-				if (changed1) break;
-				else t1x += signx1;
-			}
-			// Move line
-		next1:
-			// process second line until y value is about to change
-			while (1) {
-				e2 += dy2;
-				while (e2 >= dx2) {
-					e2 -= dx2;
-					if (changed2) t2xp = signx2;//t2x += signx2;
-					else          goto next2;
-				}
-				if (changed2)     break;
-				else              t2x += signx2;
-			}
-		next2:
-			if (minx > t1x) minx = t1x;
-			if (minx > t2x) minx = t2x;
-			if (maxx < t1x) maxx = t1x;
-			if (maxx < t2x) maxx = t2x;
-			drawline(minx, maxx, y);    // Draw line from min to max points found on the y
-										// Now increase y
-			if (!changed1) t1x += signx1;
-			t1x += t1xp;
-			if (!changed2) t2x += signx2;
-			t2x += t2xp;
-			y += 1;
-			if (y == y2) break;
-
-		}
-	next:
-		// Second half
-		dx1 = (int)(x3 - x2); if (dx1 < 0) { dx1 = -dx1; signx1 = -1; }
-		else signx1 = 1;
-		dy1 = (int)(y3 - y2);
-		t1x = x2;
-
-		if (dy1 > dx1) {   // swap values
-			std::swap(dy1, dx1);
-			changed1 = true;
-		}
-		else changed1 = false;
-
-		e1 = (int)(dx1 >> 1);
-
-		for (int i = 0; i <= dx1; i++) {
-			t1xp = 0; t2xp = 0;
-			if (t1x < t2x) { minx = t1x; maxx = t2x; }
-			else { minx = t2x; maxx = t1x; }
-			// process first line until y value is about to change
-			while (i < dx1) {
-				e1 += dy1;
-				while (e1 >= dx1) {
-					e1 -= dx1;
-					if (changed1) { t1xp = signx1; break; }//t1x += signx1;
-					else          goto next3;
-				}
-				if (changed1) break;
-				else   	   	  t1x += signx1;
-				if (i < dx1) i++;
-			}
-		next3:
-			// process second line until y value is about to change
-			while (t2x != x3) {
-				e2 += dy2;
-				while (e2 >= dx2) {
-					e2 -= dx2;
-					if (changed2) t2xp = signx2;
-					else          goto next4;
-				}
-				if (changed2)     break;
-				else              t2x += signx2;
-			}
-		next4:
+		olc_FillTriangleSpans(x1, y1, x2, y2, x3, y3, [&](int32_t sx, int32_t sy, int32_t count) { olc_DrawSpan(sx, sy, count, p); });
+	}
 
-			if (minx > t1x) minx = t1x;
-			if (minx > t2x) minx = t2x;
-			if (maxx < t1x) maxx = t1x;
-			if (maxx < t2x) maxx = t2x;
-			drawline(minx, maxx, y);
-			if (!changed1) t1x += signx1;
-			t1x += t1xp;
-			if (!changed2) t2x += signx2;
-			t2x += t2xp;
-			y += 1;
-			if (y > y3) return;
-		}
+	void PixelGameEngine::FillTriangleHalfSpace(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p, int32_t cx, int32_t cy, int32_t cw, int32_t ch)
+	{
+		if (!pDrawTarget) return;
+		int32_t cx2 = (int32_t)std::min((int64_t)cx + cw, (int64_t)pDrawTarget->width);
+		int32_t cy2 = (int32_t)std::min((int64_t)cy + ch, (int64_t)pDrawTarget->height);
+		olc_TriangleSpans(x1, y1, x2, y2, x3, y3, std::max(cx, 0), std::max(cy, 0), cx2, cy2,
+			[&](int32_t sx, int32_t sy, int32_t count) { olc_DrawSpan(sx, sy, count, p); });
 	}
 
 	void PixelGameEngine::DrawSprite(const olc::vi2d& pos, Sprite* sprite, uint32_t scale, uint8_t flip)
@@ -2201,33 +2814,7 @@ namespace olc
 		if (sprite == nullptr)
 			return;
 
-		int32_t fxs = 0, fxm = 1, fx = 0;
-		int32_t fys = 0, fym = 1, fy = 0;
-		if (flip & olc::Sprite::Flip::HORIZ) { fxs = sprite->width - 1; fxm = -1; }
-		if (flip & olc::Sprite::Flip::VERT) { fys = sprite->height - 1; fym = -1; }
-
-		if (scale > 1)
-		{
-			fx = fxs;
-			for (int32_t i = 0; i < sprite->width; i++, fx += fxm)
-			{
-				fy = fys;
-				for (int32_t j = 0; j < sprite->height; j++, fy += fym)
-					for (uint32_t is = 0; is < scale; is++)
-						for (uint32_t js = 0; js < scale; js++)
-							Draw(x + (i * scale) + is, y + (j * scale) + js, sprite->GetPixel(fx, fy));
-			}
-		}
-		else
-		{
-			fx = fxs;
-			for (int32_t i = 0; i < sprite->width; i++, fx += fxm)
-			{
-				fy = fys;
-				for (int32_t j = 0; j < sprite->height; j++, fy += fym)
-					Draw(x + i, y + j, sprite->GetPixel(fx, fy));
-			}
-		}
+		DrawPartialSprite(x, y, sprite, 0, 0, sprite->width, sprite->height, scale, flip);
 	}
 
 	void PixelGameEngine::DrawPartialSprite(const olc::vi2d& pos, Sprite* sprite, const olc::vi2d& sourcepos, const olc::vi2d& size, uint32_t scale, uint8_t flip)
@@ -2240,6 +2827,13 @@ namespace olc
 		if (sprite == nullptr)
 			return;
 
+		// Source entirely inside the sprite, so no texel needs GetPixel's checks
+		if (pDrawTarget && ox >= 0 && oy >= 0 && ox + w <= sprite->width && oy + h <= sprite->height)
+		{
+			olc_BlitSprite(x, y, sprite, ox, oy, w, h, (int32_t)std::max(scale, 1u), flip);
+			return;
+		}
+
 		int32_t fxs = 0, fxm = 1, fx = 0;
 		int32_t fys = 0, fym = 1, fy = 0;
 		if (flip & olc::Sprite::Flip::HORIZ) { fxs = w - 1; fxm = -1; }
@@ -2269,6 +2863,87 @@ namespace olc
 		}
 	}
 
+	void PixelGameEngine::olc_BlitSprite(int32_t x, int32_t y, Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, int32_t scale, uint8_t flip)
+	{
+		if (nPixelMode == Pixel::MASK && scale == 1)
+		{
+			const Sprite::OpaqueRun* pRuns;
+			const uint32_t* pRows;
+			sprite->GetOpaqueRuns(pRuns, pRows);
+			pDrawTarget->InvalidateOpaqueRuns();
+			olc_BlitOpaqueRuns(pDrawTarget, x, y, sprite->pColData, sprite->width, pRuns, pRows, ox, oy, w, h, flip, 0, 0, pDrawTarget->width, pDrawTarget->height);
+			return;
+		}
+
+		olc_BlitRows(x, y, sprite, ox, oy, w, h, scale, flip, 0, 0, pDrawTarget->width, pDrawTarget->height, vBlitRow,
+			[&](int32_t dx, int32_t dy, const Pixel* pRow, int32_t nCount)
+		{
+			if (nPixelMode == Pixel::CUSTOM)
+				olc_ShadeSpan(dx, dy, nCount, pRow, 1, funcPixelMode);
+			else
+				olc_WriteRow(pDrawTarget->GetData() + dy * pDrawTarget->width + dx, pRow, nCount, nPixelMode, fBlendFactor);
+		});
+	}
+
+	void PixelGameEngine::olc_BlitOpaqueRuns(Sprite* target, int32_t x, int32_t y, const Pixel* texels, int32_t stride, const Sprite::OpaqueRun* runs, const uint32_t* rows,
+		int32_t ox, int32_t oy, int32_t w, int32_t h, uint8_t flip, int32_t cx1, int32_t cy1, int32_t cx2, int32_t cy2)
+	{
+		// Only the opaque runs are copied, transparent texels aren't even looked at
+		bool bFlipX = (flip & olc::Sprite::Flip::HORIZ) != 0;
+		bool bFlipY = (flip & olc::Sprite::Flip::VERT) != 0;
+		int32_t nWidth = target->width;
+		Pixel* pTarget = target->pColData;
+		int32_t dy1 = std::max(y, cy1), dy2 = std::min(y + h, cy2);
+		for (int32_t dy = dy1; dy < dy2; dy++)
+		{
+			int32_t sy = oy + (bFlipY ? h - 1 - (dy - y) : dy - y);
+			const Pixel* pSrc = texels + sy * stride;
+			Pixel* pDst = pTarget + dy * nWidth;
+			const Sprite::OpaqueRun* pRun = runs + rows[sy];
+			const Sprite::OpaqueRun* pEnd = runs + rows[sy + 1];
+			// Part of a sprite sheet: straight to the first run reaching the part being drawn
+			if (ox > 0)
+				pRun = std::partition_point(pRun, pEnd, [&](const Sprite::OpaqueRun& run) { return run.x + run.length <= ox; });
+			for (; pRun < pEnd && pRun->x < ox + w; pRun++)
+			{
+				// The run, cut to the part of the sprite being drawn, then to the draw target
+				int32_t s1 = std::max(pRun->x, ox), s2 = std::min(pRun->x + pRun->length, ox + w);
+				if (!bFlipX)
+				{
+					int32_t d1 = x + s1 - ox, d2 = x + s2 - ox;
+					if (d1 < cx1) { s1 += cx1 - d1; d1 = cx1; }
+					d2 = std::min(d2, cx2);
+					if (d2 > d1) std::memmove(pDst + d1, pSrc + s1, (d2 - d1) * sizeof(Pixel));
+				}
+				else
+				{
+					// Texel s lands on x + ox + w - 1 - s, so the run lands backwards
+					int32_t d1 = std::max(x + ox + w - s2, cx1), d2 = std::min(x + ox + w - s1, cx2);
+					for (int32_t d = d1; d < d2; d++) pDst[d] = pSrc[x + ox + w - 1 - d];
+				}
+			}
+		}
+	}
+
+	void PixelGameEngine::olc_WriteRow(Pixel* dst, const Pixel* src, int32_t count, Pixel::Mode mode, float blend)
+	{
+		if (mode == Pixel::NORMAL)
+			std::memmove(dst, src, count * sizeof(Pixel));
+		else if (mode == Pixel::MASK)
+		{
+			// Only opaque runs are copied, transparent ones skipped over
+			for (int32_t i = 0; i < count;)
+			{
+				while (i < count && src[i].a != 255) i++;
+				int32_t nStart = i;
+				while (i < count && src[i].a == 255) i++;
+				if (i > nStart) std::memmove(dst + nStart, src + nStart, (i - nStart) * sizeof(Pixel));
+			}
+		}
+		else if (mode == Pixel::ALPHA)
+			olc_BlendSpan(dst, src, 1, count, blend);
+	}
+
 	void PixelGameEngine::SetDecalMode(const olc::DecalMode& mode)
 	{
 		nDecalMode = mode;
@@ -2570,43 +3245,70 @@ namespace olc
 
 	void PixelGameEngine::DrawString(int32_t x, int32_t y, const std::string& sText, Pixel col, uint32_t scale)
 	{
+		olc_DrawText(x, y, sText.data(), sText.size(), col, scale, false);
+	}
+
+	void PixelGameEngine::DrawString(const olc::vi2d& pos, const char* sText, Pixel col, uint32_t scale)
+	{
+		DrawString(pos.x, pos.y, sText, col, scale);
+	}
+
+	void PixelGameEngine::DrawString(int32_t x, int32_t y, const char* sText, Pixel col, uint32_t scale)
+	{
+		olc_DrawText(x, y, sText, std::strlen(sText), col, scale, false);
+	}
+
+	void PixelGameEngine::olc_DrawText(int32_t x, int32_t y, const char* sText, size_t nLength, Pixel col, uint32_t scale, bool bProportional)
+	{
+		if (!pDrawTarget) return;
+
+		// Thanks @tucna, spotted bug with col.ALPHA :P
+		// Drawn as MASK, or ALPHA if the colour isn't opaque, straight into the
+		// draw target rather than through the pixel mode
+		Pixel::Mode mode = col.a != 255 ? Pixel::ALPHA : Pixel::MASK;
+		int32_t nScale = std::max((int32_t)scale, 1);
+		int32_t nWidth = pDrawTarget->width, nHeight = pDrawTarget->height;
+		Pixel* pData = pDrawTarget->GetData();
 		int32_t sx = 0;
 		int32_t sy = 0;
-		Pixel::Mode m = nPixelMode;
-		// Thanks @tucna, spotted bug with col.ALPHA :P
-		if (col.a != 255)		SetPixelMode(Pixel::ALPHA);
-		else					SetPixelMode(Pixel::MASK);
-		for (auto c : sText)
+		for (size_t n = 0; n < nLength; n++)
 		{
+			char c = sText[n];
 			if (c == '\n')
 			{
 				sx = 0; sy += 8 * scale;
+				continue;
 			}
-			else
+
+			int32_t g = c - 32;
+			if (g < 0 || g >= 96)
 			{
-				int32_t ox = (c - 32) % 16;
-				int32_t oy = (c - 32) / 16;
+				if (!bProportional) sx += 8 * scale;
+				continue;
+			}
+			int32_t nFirst = bProportional ? vFontSpacing[g].x : 0;
+			int32_t nColumns = bProportional ? vFontSpacing[g].y : 8;
 
-				if (scale > 1)
-				{
-					for (uint32_t i = 0; i < 8; i++)
-						for (uint32_t j = 0; j < 8; j++)
-							if (fontSprite->GetPixel(i + ox * 8, j + oy * 8).r > 0)
-								for (uint32_t is = 0; is < scale; is++)
-									for (uint32_t js = 0; js < scale; js++)
-										Draw(x + sx + (i * scale) + is, y + sy + (j * scale) + js, col);
-				}
-				else
+			// Each run of lit columns in a row is one span per row of scale
+			for (int32_t j = 0; j < 8; j++)
+			{
+				uint32_t nBits = ((uint32_t)nFontRows[g][j] >> nFirst) & ((1u << nColumns) - 1);
+				for (int32_t i = 0; nBits != 0;)
 				{
-					for (uint32_t i = 0; i < 8; i++)
-						for (uint32_t j = 0; j < 8; j++)
-							if (fontSprite->GetPixel(i + ox * 8, j + oy * 8).r > 0)
-								Draw(x + sx + i, y + sy + j, col);
+					while ((nBits & 1) == 0) { nBits >>= 1; i++; }
+					int32_t nStart = i;
+					while (nBits & 1) { nBits >>= 1; i++; }
+
+					int32_t x1 = std::max(x + sx + nStart * nScale, 0);
+					int32_t x2 = std::min(x + sx + i * nScale, nWidth);
+					if (x2 <= x1) continue;
+					for (int32_t py = y + sy + j * nScale, pyEnd = py + nScale; py < pyEnd; py++)
+						if (py >= 0 && py < nHeight)
+							olc_WriteSpan(pData + py * nWidth + x1, x2 - x1, col, mode, fBlendFactor);
 				}
-				sx += 8 * scale;
 			}
+			sx += nColumns * scale;
 		}
-		SetPixelMode(m);
 	}
 
 	olc::vi2d PixelGameEngine::GetTextSizeProp(const std::string& s)
@@ -2632,43 +3334,17 @@ namespace olc
 
 	void PixelGameEngine::DrawStringProp(int32_t x, int32_t y, const std::string& sText, Pixel col, uint32_t scale)
 	{
-		int32_t sx = 0;
-		int32_t sy = 0;
-		Pixel::Mode m = nPixelMode;
-		
-		if (col.a != 255)		SetPixelMode(Pixel::ALPHA);
-		else					SetPixelMode(Pixel::MASK);
-		for (auto c : sText)
-		{
-			if (c == '\n')
-			{
-				sx = 0; sy += 8 * scale;
-			}
-			else
-			{
-				int32_t ox = (c - 32) % 16;
-				int32_t oy = (c - 32) / 16;
+		olc_DrawText(x, y, sText.data(), sText.size(), col, scale, true);
+	}
 
-				if (scale > 1)
-				{
-					for (int32_t i = 0; i < vFontSpacing[c - 32].y; i++)
-						for (int32_t j = 0; j < 8; j++)
-							if (fontSprite->GetPixel(i + ox * 8 + vFontSpacing[c - 32].x, j + oy * 8).r > 0)
-								for (int32_t is = 0; is < int(scale); is++)
-									for (int32_t js = 0; js < int(scale); js++)
-										Draw(x + sx + (i * scale) + is, y + sy + (j * scale) + js, col);
-				}
-				else
-				{
-					for (int32_t i = 0; i < vFontSpacing[c - 32].y; i++)
-						for (int32_t j = 0; j < 8; j++)
-							if (fontSprite->GetPixel(i + ox * 8 + vFontSpacing[c - 32].x, j + oy * 8).r > 0)
-								Draw(x + sx + i, y + sy + j, col);
-				}
-				sx += vFontSpacing[c - 32].y * scale;
-			}
-		}
-		SetPixelMode(m);
+	void PixelGameEngine::DrawStringProp(const olc::vi2d& pos, const char* sText, Pixel col, uint32_t scale)
+	{
+		DrawStringProp(pos.x, pos.y, sText, col, scale);
+	}
+
+	void PixelGameEngine::DrawStringProp(int32_t x, int32_t y, const char* sText, Pixel col, uint32_t scale)
+	{
+		olc_DrawText(x, y, sText, std::strlen(sText), col, scale, true);
 	}
 
 	void PixelGameEngine::SetPixelMode(Pixel::Mode m)
@@ -2690,6 +3366,9 @@ namespace olc
 		if (fBlendFactor > 1.0f) fBlendFactor = 1.0f;
 	}
 
+	float PixelGameEngine::GetPixelBlend()
+	{ return fBlendFactor; }
+
 	// User must override these functions as required. I have not made
 	// them abstract because I do need a default behaviour to occur if
 	// they are not overwritten
@@ -2829,6 +3508,9 @@ namespace olc
 
 		// Our time per frame coefficient
 		float fElapsedTime = elapsedTime.count();
+#if defined(OLC_PLATFORM_HEADLESS)
+		fElapsedTime = headlessScript.fFrameTime;
+#endif
 		fLastElapsed = fElapsedTime;
 
 		// Some platforms will need to check for events
@@ -2890,8 +3572,13 @@ namespace olc
 					renderer->ApplyTexture(layer->nResID);
 					if (layer->bUpdate)
 					{
-						renderer->UpdateTexture(layer->nResID, layer->pDrawTarget);
+						if (layer->nUpdateRowsEnd < 0)
+							renderer->UpdateTexture(layer->nResID, layer->pDrawTarget);
+						else if (layer->nUpdateRowsEnd > layer->nUpdateRowsBegin)
+							renderer->UpdateTextureRows(layer->nResID, layer->pDrawTarget, layer->nUpdateRowsBegin, layer->nUpdateRowsEnd - layer->nUpdateRowsBegin);
 						layer->bUpdate = false;
+						layer->nUpdateRowsBegin = 0;
+						layer->nUpdateRowsEnd = -1;
 					}
 
 					renderer->DrawLayerQuad(layer->vOffset, layer->vScale, layer->tint);
@@ -2963,6 +3650,15 @@ namespace olc
 			}
 		}
 
+		for (int32_t g = 0; g < 96; g++)
+			for (int32_t j = 0; j < 8; j++)
+			{
+				uint8_t nBits = 0;
+				for (int32_t i = 0; i < 8; i++)
+					if (fontSprite->GetPixel(i + g % 16 * 8, j + g / 16 * 8).r > 0) nBits |= 1 << i;
+				nFontRows[g][j] = nBits;
+			}
+
 		fontDecal = new olc::Decal(fontSprite);
 
 		constexpr std::array<uint8_t, 96> vSpacing = { {
@@ -3295,6 +3991,12 @@ namespace olc
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
 		}
 
+		void UpdateTextureRows(uint32_t id, olc::Sprite* spr, int32_t y, int32_t rows) override
+		{
+			UNUSED(id);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, spr->width, rows, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData() + y * spr->width);
+		}
+
 		void ApplyTexture(uint32_t id) override
 		{
 			glBindTexture(GL_TEXTURE_2D, id);
@@ -3324,6 +4026,311 @@ namespace olc
 
 
 
+// O------------------------------------------------------------------------------O
+// | START RENDERER: Software, in memory, no GPU needed                           |
+// O------------------------------------------------------------------------------O
+#if defined(OLC_GFX_SOFTWARE)
+namespace olc
+{
+	// Composites into a sprite instead of a window, one pixel per screen pixel
+	// whatever the pixel size. Textures are sampled nearest, clamped at the edges,
+	// filtered or not, and blended the way the OpenGL renderers set glBlendFunc for
+	// the decal mode. The frame stays opaque, like a window's back buffer
+	class Renderer_Software : public olc::Renderer
+	{
+	private:
+		struct Texture
+		{
+			int32_t nWidth = 0;
+			int32_t nHeight = 0;
+			std::vector<olc::Pixel> vData;
+			bool bInUse = false;
+		};
+
+		std::vector<Texture> vTextures; // At id - 1, id 0 is no texture
+		uint32_t nBoundTexture = 0;
+		olc::DecalMode nDecalMode = olc::DecalMode::NORMAL;
+		std::unique_ptr<olc::Sprite> pFrame;
+		std::vector<olc::Pixel> vRow;
+		std::vector<int32_t> vColumns;
+
+	public:
+		void PrepareDevice() override
+		{}
+
+		olc::rcode CreateDevice(std::vector<void*> params, bool bFullScreen, bool bVSYNC) override
+		{
+			UNUSED(params);
+			UNUSED(bFullScreen);
+			UNUSED(bVSYNC);
+			return olc::rcode::OK;
+		}
+
+		olc::rcode DestroyDevice() override
+		{
+			// The frame is kept, so it can still be read once Start returns
+			vTextures.clear();
+			nBoundTexture = 0;
+			return olc::rcode::OK;
+		}
+
+		void DisplayFrame() override
+		{}
+
+		void PrepareDrawing() override
+		{
+			SetDecalMode(olc::DecalMode::NORMAL);
+		}
+
+		void SetDecalMode(const olc::DecalMode& mode) override
+		{
+			nDecalMode = mode;
+		}
+
+		void DrawLayerQuad(const olc::vf2d& offset, const olc::vf2d& scale, const olc::Pixel tint) override
+		{
+			const Texture* tex = GetTexture(nBoundTexture);
+			if (tex == nullptr || pFrame == nullptr) return;
+			const int32_t w = pFrame->width, h = pFrame->height;
+
+			// The quad covers the whole frame, so every row samples the same columns
+			bool bStraight = tint == olc::WHITE && tex->nWidth == w;
+			vColumns.resize(w);
+			for (int32_t x = 0; x < w; x++)
+			{
+				vColumns[x] = Sample((float(x) + 0.5f) / float(w) * scale.x + offset.x, tex->nWidth);
+				bStraight &= vColumns[x] == x;
+			}
+
+			vRow.resize(w);
+			olc::Pixel* pDst = pFrame->GetData();
+			for (int32_t y = 0; y < h; y++)
+			{
+				const olc::Pixel* pSrc = tex->vData.data() + Sample((float(y) + 0.5f) / float(h) * scale.y + offset.y, tex->nHeight) * tex->nWidth;
+				if (!bStraight)
+				{
+					for (int32_t x = 0; x < w; x++) vRow[x] = Modulate(pSrc[vColumns[x]], tint);
+					pSrc = vRow.data();
+				}
+				Composite(pDst + y * w, pSrc, w);
+			}
+		}
+
+		void DrawDecalQuad(const olc::DecalInstance& decal) override
+		{
+			if (pFrame == nullptr) return;
+			SetDecalMode(decal.mode);
+			const Texture* tex = nullptr;
+			if (decal.decal != nullptr && (tex = GetTexture(uint32_t(decal.decal->id))) == nullptr) return;
+
+			// From -1..1, y up, to frame pixels, split as GL_QUADS is
+			olc::vf2d pos[4];
+			for (int i = 0; i < 4; i++)
+				pos[i] = { (decal.pos[i].x + 1.0f) * 0.5f * float(pFrame->width), (1.0f - decal.pos[i].y) * 0.5f * float(pFrame->height) };
+			DrawDecalTriangle(decal, tex, pos, { 0, 1, 2 });
+			DrawDecalTriangle(decal, tex, pos, { 0, 2, 3 });
+		}
+
+		uint32_t CreateTexture(const uint32_t width, const uint32_t height, const bool filtered) override
+		{
+			UNUSED(filtered);
+			size_t i = 0;
+			while (i < vTextures.size() && vTextures[i].bInUse) i++;
+			if (i == vTextures.size()) vTextures.emplace_back();
+			vTextures[i].bInUse = true;
+			vTextures[i].nWidth = int32_t(width);
+			vTextures[i].nHeight = int32_t(height);
+			nBoundTexture = uint32_t(i + 1);
+			return nBoundTexture;
+		}
+
+		uint32_t DeleteTexture(const uint32_t id) override
+		{
+			if (id != 0 && id <= vTextures.size()) vTextures[id - 1] = Texture();
+			if (nBoundTexture == id) nBoundTexture = 0;
+			return id;
+		}
+
+		// Read through pColData, GetData would throw away the sprite's opaque runs
+		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
+		{
+			if (id == 0 || id > vTextures.size() || spr == nullptr) return;
+			Texture& tex = vTextures[id - 1];
+			tex.nWidth = spr->width;
+			tex.nHeight = spr->height;
+			tex.vData.assign(spr->pColData, spr->pColData + spr->width * spr->height);
+		}
+
+		void UpdateTextureRows(uint32_t id, olc::Sprite* spr, int32_t y, int32_t rows) override
+		{
+			if (id == 0 || id > vTextures.size() || spr == nullptr) return;
+			Texture& tex = vTextures[id - 1];
+			if (tex.nWidth != spr->width || tex.nHeight != spr->height || tex.vData.empty())
+			{
+				UpdateTexture(id, spr);
+				return;
+			}
+			std::copy(spr->pColData + y * spr->width, spr->pColData + (y + rows) * spr->width, tex.vData.begin() + y * spr->width);
+		}
+
+		void ApplyTexture(uint32_t id) override
+		{
+			nBoundTexture = id;
+		}
+
+		void UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) override
+		{
+			UNUSED(pos);
+			UNUSED(size);
+		}
+
+		void ClearBuffer(olc::Pixel p, bool bDepth) override
+		{
+			UNUSED(bDepth);
+			const int32_t w = ptrPGE->ScreenWidth(), h = ptrPGE->ScreenHeight();
+			if (pFrame == nullptr || pFrame->width != w || pFrame->height != h)
+				pFrame = std::make_unique<olc::Sprite>(w, h);
+			p.a = 255;
+			PixelGameEngine::olc_FillSpan(pFrame->GetData(), w * h, p);
+		}
+
+		const olc::Sprite* GetFrameBuffer() const override
+		{
+			return pFrame.get();
+		}
+
+	private:
+		const Texture* GetTexture(uint32_t id) const
+		{
+			if (id == 0 || id > vTextures.size() || vTextures[id - 1].vData.empty()) return nullptr;
+			return &vTextures[id - 1];
+		}
+
+		// Nearest texel to texture coordinate t, on an axis n texels long
+		static int32_t Sample(float t, int32_t n)
+		{
+			t = std::min(std::max(t, 0.0f), 1.0f);
+			return std::min(int32_t(t * float(n)), n - 1);
+		}
+
+		static uint8_t Mul(uint32_t a, uint32_t b)
+		{
+			return uint8_t((a * b + 127) / 255);
+		}
+
+		static olc::Pixel Modulate(olc::Pixel p, olc::Pixel tint)
+		{
+			return olc::Pixel(Mul(p.r, tint.r), Mul(p.g, tint.g), Mul(p.b, tint.b), Mul(p.a, tint.a));
+		}
+
+		// count pixels of src blended onto dst, as glBlendFunc is set for the decal mode
+		void Composite(olc::Pixel* dst, const olc::Pixel* src, int32_t count) const
+		{
+			if (nDecalMode == olc::DecalMode::NORMAL)
+			{
+				PixelGameEngine::olc_BlendSpan(dst, src, 1, count, 1.0f);
+				return;
+			}
+
+			for (int32_t i = 0; i < count; i++)
+			{
+				const uint32_t a = src[i].a;
+				auto mix = [&](uint8_t s, uint8_t d) -> uint8_t
+				{
+					switch (nDecalMode)
+					{
+					case olc::DecalMode::ADDITIVE:       return uint8_t(std::min<uint32_t>(Mul(s, a) + d, 255));
+					case olc::DecalMode::MULTIPLICATIVE: return uint8_t(std::min<uint32_t>(Mul(s, d) + Mul(d, 255 - a), 255));
+					case olc::DecalMode::STENCIL:        return Mul(d, a);
+					case olc::DecalMode::ILLUMINATE:     return uint8_t(std::min<uint32_t>(Mul(s, 255 - a) + Mul(d, a), 255));
+					default:                             return d;
+					}
+				};
+				dst[i] = olc::Pixel(mix(src[i].r, dst[i].r), mix(src[i].g, dst[i].g), mix(src[i].b, dst[i].b), 255);
+			}
+		}
+
+		// Pixels with their centres inside, an edge shared with the other half of the
+		// quad going to one side only. uv and w are interpolated straight across the
+		// screen and divided per pixel, as glTexCoord4f has OpenGL do. Textured decals
+		// take the first tint, as the OpenGL renderers do, untextured ones shade
+		// between their corners' tints
+		void DrawDecalTriangle(const olc::DecalInstance& decal, const Texture* tex, const olc::vf2d* pos, const std::array<int, 3>& corner)
+		{
+			const olc::vf2d v[3] = { pos[corner[0]], pos[corner[1]], pos[corner[2]] };
+			const float fArea = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+			if (fArea == 0.0f) return;
+
+			// Each corner's weight as a plane over the screen, l = c + dx * x + dy * y,
+			// and whether the edge facing it owns pixels right on it (top-left rule)
+			float c[3], dx[3], dy[3];
+			bool bOwnsEdge[3];
+			for (int k = 0; k < 3; k++)
+			{
+				const olc::vf2d& a = v[(k + 1) % 3];
+				const olc::vf2d& b = v[(k + 2) % 3];
+				dx[k] = (a.y - b.y) / fArea;
+				dy[k] = (b.x - a.x) / fArea;
+				c[k] = (a.x * b.y - a.y * b.x) / fArea;
+				bOwnsEdge[k] = dx[k] > 0.0f || (dx[k] == 0.0f && dy[k] > 0.0f);
+			}
+
+			const int32_t x1 = std::max(int32_t(std::floor(std::min({ v[0].x, v[1].x, v[2].x }))), 0);
+			const int32_t y1 = std::max(int32_t(std::floor(std::min({ v[0].y, v[1].y, v[2].y }))), 0);
+			const int32_t x2 = std::min(int32_t(std::ceil(std::max({ v[0].x, v[1].x, v[2].x }))), pFrame->width);
+			const int32_t y2 = std::min(int32_t(std::ceil(std::max({ v[0].y, v[1].y, v[2].y }))), pFrame->height);
+
+			olc::Pixel* pDst = pFrame->GetData();
+			for (int32_t y = y1; y < y2; y++)
+				for (int32_t x = x1; x < x2; x++)
+				{
+					float l[3];
+					bool bInside = true;
+					for (int k = 0; k < 3 && bInside; k++)
+					{
+						l[k] = c[k] + dx[k] * (float(x) + 0.5f) + dy[k] * (float(y) + 0.5f);
+						bInside = l[k] > 0.0f || (l[k] == 0.0f && bOwnsEdge[k]);
+					}
+					if (!bInside) continue;
+
+					olc::Pixel p;
+					if (tex != nullptr)
+					{
+						float u = 0.0f, t = 0.0f, q = 0.0f;
+						for (int k = 0; k < 3; k++)
+						{
+							u += l[k] * decal.uv[corner[k]].x;
+							t += l[k] * decal.uv[corner[k]].y;
+							q += l[k] * decal.w[corner[k]];
+						}
+						if (q == 0.0f) continue;
+						p = Modulate(tex->vData[Sample(t / q, tex->nHeight) * tex->nWidth + Sample(u / q, tex->nWidth)], decal.tint[0]);
+					}
+					else
+					{
+						float r = 0.5f, g = 0.5f, b = 0.5f, a = 0.5f;
+						for (int k = 0; k < 3; k++)
+						{
+							const olc::Pixel& tint = decal.tint[corner[k]];
+							r += l[k] * tint.r;
+							g += l[k] * tint.g;
+							b += l[k] * tint.b;
+							a += l[k] * tint.a;
+						}
+						p = olc::Pixel(uint8_t(std::min(r, 255.0f)), uint8_t(std::min(g, 255.0f)), uint8_t(std::min(b, 255.0f)), uint8_t(std::min(a, 255.0f)));
+					}
+					Composite(pDst + y * pFrame->width + x, &p, 1);
+				}
+		}
+	};
+}
+#endif
+// O------------------------------------------------------------------------------O
+// | END RENDERER: Software, in memory, no GPU needed                             |
+// O------------------------------------------------------------------------------O
+
+
+
 
 // O------------------------------------------------------------------------------O
 // | START IMAGE LOADER: GDI+, Windows Only, always exists, a little slow         |
@@ -4337,6 +5344,110 @@ namespace olc {
 
 
 
+// O------------------------------------------------------------------------------O
+// | START PLATFORM: HEADLESS, no window, no display, scripted input              |
+// O------------------------------------------------------------------------------O
+#if defined(OLC_PLATFORM_HEADLESS)
+namespace olc
+{
+	// Nothing to open and no events of its own. Each frame feeds in the input
+	// SetHeadlessScript gave for it, and after the script's last frame the engine
+	// is stopped, so Start returns
+	class Platform_Headless : public olc::Platform
+	{
+	private:
+		uint32_t nFrame = 0;
+		size_t nNextEvent = 0;
+
+	public:
+		virtual olc::rcode ApplicationStartUp() override
+		{
+			nFrame = 0;
+			nNextEvent = 0;
+			return olc::rcode::OK;
+		}
+
+		virtual olc::rcode ApplicationCleanUp() override
+		{ return olc::rcode::OK; }
+
+		virtual olc::rcode ThreadStartUp() override
+		{ return olc::rcode::OK; }
+
+		virtual olc::rcode ThreadCleanUp() override
+		{
+			renderer->DestroyDevice();
+			return olc::OK;
+		}
+
+		virtual olc::rcode CreateGraphics(bool bFullScreen, bool bEnableVSYNC, const olc::vi2d& vViewPos, const olc::vi2d& vViewSize) override
+		{
+			if (renderer->CreateDevice({}, bFullScreen, bEnableVSYNC) == olc::rcode::OK)
+			{
+				renderer->UpdateViewport(vViewPos, vViewSize);
+				return olc::rcode::OK;
+			}
+			else
+				return olc::rcode::FAIL;
+		}
+
+		virtual olc::rcode CreateWindowPane(const olc::vi2d& vWindowPos, olc::vi2d& vWindowSize, bool bFullScreen) override
+		{
+			UNUSED(vWindowPos);
+			UNUSED(vWindowSize);
+			UNUSED(bFullScreen);
+			// As if the window had just been clicked on
+			ptrPGE->olc_UpdateKeyFocus(true);
+			return olc::rcode::OK;
+		}
+
+		virtual olc::rcode SetWindowTitle(const std::string& s) override
+		{
+			UNUSED(s);
+			return olc::rcode::OK;
+		}
+
+		virtual olc::rcode StartSystemEventLoop() override
+		{ return olc::rcode::OK; }
+
+		virtual olc::rcode HandleSystemEvent() override
+		{
+			const HeadlessScript& script = ptrPGE->headlessScript;
+			for (; nNextEvent < script.vEvents.size() && script.vEvents[nNextEvent].nFrame <= nFrame; nNextEvent++)
+			{
+				const HeadlessScript::Event& e = script.vEvents[nNextEvent];
+				switch (e.type)
+				{
+				case HeadlessScript::Event::KEY:
+					if (e.a >= 0 && e.a < 256) ptrPGE->olc_UpdateKeyState(e.a, e.b != 0);
+					break;
+				case HeadlessScript::Event::MOUSE_BUTTON:
+					if (e.a >= 0 && e.a < nMouseButtons) ptrPGE->olc_UpdateMouseState(e.a, e.b != 0);
+					break;
+				case HeadlessScript::Event::MOUSE_MOVE:
+					// Already in screen space, there's no window to map it from
+					ptrPGE->bHasMouseFocus = true;
+					ptrPGE->vMousePosCache = { std::min(std::max(e.a, 0), ptrPGE->vScreenSize.x - 1), std::min(std::max(e.b, 0), ptrPGE->vScreenSize.y - 1) };
+					ptrPGE->vMouseWindowPos = ptrPGE->vMousePosCache * ptrPGE->vPixelSize;
+					break;
+				case HeadlessScript::Event::MOUSE_WHEEL:
+					ptrPGE->olc_UpdateMouseWheel(e.a);
+					break;
+				}
+			}
+
+			// This frame still runs to the end
+			if (++nFrame >= script.nFrames && script.nFrames != 0) ptrPGE->olc_Terminate();
+			return olc::rcode::OK;
+		}
+	};
+}
+#endif
+// O------------------------------------------------------------------------------O
+// | END PLATFORM: HEADLESS                                                       |
+// O------------------------------------------------------------------------------O
+
+
+
 namespace olc
 {
 	void PixelGameEngine::olc_ConfigureSystem()
@@ -4369,6 +5480,10 @@ namespace olc
 		platform = std::make_unique<olc::Platform_GLUT>();
 #endif
 
+#if defined(OLC_PLATFORM_HEADLESS)
+		platform = std::make_unique<olc::Platform_Headless>();
+#endif
+
 
 
 #if defined(OLC_GFX_OPENGL10)
@@ -4391,6 +5506,10 @@ namespace olc
 		renderer = std::make_unique<olc::Renderer_DX11>();
 #endif
 
+#if defined(OLC_GFX_SOFTWARE)
+		renderer = std::make_unique<olc::Renderer_Software>();
+#endif
+
 		// Associate components with PGE instance
 		platform->ptrPGE = this;
 		renderer->ptrPGE = this;